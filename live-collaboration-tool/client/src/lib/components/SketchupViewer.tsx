@@ -1,7 +1,8 @@
 /**
  * 스케치업 3D 뷰어 컴포넌트 (React 19 호환)
  * - react-three-fiber 대신 순수 three.js를 사용합니다.
- * - GLB 로딩: GLTFLoader
+ * - GLB 로딩: GLTFLoader (+ MeshoptDecoder: EXT_meshopt_compression, DRACOLoader: KHR_draco_mesh_compression,
+ *   KTX2Loader: KHR_texture_basisu)
  * - 카메라 컨트롤: OrbitControls
  */
 
@@ -9,6 +10,9 @@ import React from "react";
 import * as THREE from "three";
 import { OrbitControls } from "three/examples/jsm/controls/OrbitControls.js";
 import { GLTFLoader } from "three/examples/jsm/loaders/GLTFLoader.js";
+import { DRACOLoader } from "three/examples/jsm/loaders/DRACOLoader.js";
+import { KTX2Loader } from "three/examples/jsm/loaders/KTX2Loader.js";
+import { MeshoptDecoder } from "three/examples/jsm/libs/meshopt_decoder.module.js";
 import { Vector3D, CameraState, SketchupPinpoint } from "../sketchup/types";
 
 export interface SketchupViewerRef {
@@ -124,11 +128,40 @@ function cameraStateFrom(camera: THREE.PerspectiveCamera, controls: OrbitControl
   };
 }
 
+// Draco 디코더(wasm)는 처음 Draco GLB를 만날 때만 내려받습니다.
+const DRACO_DECODER_PATH = "https://www.gstatic.com/draco/versioned/decoders/1.5.6/";
+let dracoLoader: DRACOLoader | null = null;
+
+// KTX2 트랜스코더는 GPU 압축 포맷 지원 여부(renderer)를 알아야 하므로 뷰어 renderer가 생긴 뒤에 연결합니다.
+// 그 전에 시작된 preload는 PNG/JPEG fallback source로 텍스처를 읽습니다.
+const BASIS_TRANSCODER_PATH = "https://cdn.jsdelivr.net/npm/three@0.160.0/examples/jsm/libs/basis/";
+let ktx2Loader: KTX2Loader | null = null;
+
+function initKtx2Loader(renderer: THREE.WebGLRenderer) {
+  if (ktx2Loader) return;
+  ktx2Loader = new KTX2Loader();
+  ktx2Loader.setTranscoderPath(BASIS_TRANSCODER_PATH);
+  ktx2Loader.detectSupport(renderer);
+}
+
+// 컨버터 --meshopt / --draco / --ktx2 출력을 압축된 채로 받도록 디코더를 연결
+function createGltfLoader() {
+  const loader = new GLTFLoader();
+  loader.setMeshoptDecoder(MeshoptDecoder);
+  if (!dracoLoader) {
+    dracoLoader = new DRACOLoader();
+    dracoLoader.setDecoderPath(DRACO_DECODER_PATH);
+  }
+  loader.setDRACOLoader(dracoLoader);
+  if (ktx2Loader) loader.setKTX2Loader(ktx2Loader);
+  return loader;
+}
+
 // 간단 preload (캐시)
 const gltfPromiseCache = new Map<string, Promise<THREE.Object3D>>();
 export function preloadSketchupModel(url: string) {
   if (gltfPromiseCache.has(url)) return;
-  const loader = new GLTFLoader();
+  const loader = createGltfLoader();
   const p = new Promise<THREE.Object3D>((resolve, reject) => {
     loader.load(
       url,
@@ -358,6 +391,7 @@ export const SketchupViewer = React.forwardRef<SketchupViewerRef, SketchupViewer
     renderer.toneMapping = THREE.ACESFilmicToneMapping;
     renderer.toneMappingExposure = 1.0;
     rendererRef.current = renderer;
+    initKtx2Loader(renderer);
     container.appendChild(renderer.domElement);
 
     const controls = new OrbitControls(camera, renderer.domElement);
@@ -640,7 +674,7 @@ export const SketchupViewer = React.forwardRef<SketchupViewerRef, SketchupViewer
       modelRootRef.current = null;
     }
 
-    const loader = new GLTFLoader();
+    const loader = createGltfLoader();
     const p =
       gltfPromiseCache.get(glbUrl) ??
       new Promise<THREE.Object3D>((resolve, reject) => {
@@ -71,6 +71,8 @@ export function initializeAssimpWorker() {
         let sourcePath = inputPath;
         let intermediateDir: string | null = null;
         let intermediateDaePath: string | null = null;
+        // C SDK 컨버터가 GLB를 직접 기록한 경우 (SKETCHUP_CSDK_FORMAT=glb) Assimp 단계를 건너뜀
+        let nativeGlb = false;
 
         if (originalExt === '.skp') {
           if (CONVERTER === 'sdk') {
@@ -79,14 +81,31 @@ export function initializeAssimpWorker() {
             await fs.mkdir(intermediateDir, { recursive: true });
 
             await job.progress(45);
-            const format =
-              (process.env.SKETCHUP_CSDK_FORMAT || 'obj').toLowerCase() === 'dae' ? 'dae' : 'obj';
+            const rawFormat = (process.env.SKETCHUP_CSDK_FORMAT || 'obj').toLowerCase();
+            const format = rawFormat === 'dae' || rawFormat === 'glb' ? rawFormat : 'obj';
+            // Draco 압축은 컨버터가 GLB를 직접 기록할 때 C++ 인코더(--draco)로 수행합니다.
+            const dracoEnabled = process.env.SKETCHUP_ENABLE_DRACO === '1';
+            if (dracoEnabled && format !== 'glb') {
+              console.warn('[변환] SKETCHUP_ENABLE_DRACO=1은 SKETCHUP_CSDK_FORMAT=glb에서만 적용됩니다.');
+            }
+            // KTX2(KHR_texture_basisu) 텍스처도 PNG/JPEG와 함께 GLB 안에 들어갑니다. (컨버터 기본 동작, --external-textures로 끔)
+            const ktx2Enabled = process.env.SKETCHUP_ENABLE_KTX2 === '1';
+            if (ktx2Enabled && format !== 'glb') {
+              console.warn('[변환] SKETCHUP_ENABLE_KTX2=1은 SKETCHUP_CSDK_FORMAT=glb에서만 적용됩니다.');
+            }
+            const extraArgs: string[] = [];
+            if (format === 'glb') {
+              if (dracoEnabled) extraArgs.push('--draco');
+              if (ktx2Enabled) extraArgs.push('--ktx2');
+            }
             const { intermediatePath } = await convertSkpToIntermediateWithSketchupCSDK({
               inputSkpPath: inputPath,
               outputDirForFile: intermediateDir,
               format,
+              extraArgs,
             });
             sourcePath = intermediatePath;
+            nativeGlb = format === 'glb';
           } else {
             // .skp → .dae
             // SketchUp Collada export는 DAE와 함께 텍스처 이미지를 "같은 디렉토리"에 생성합니다.
@@ -107,16 +126,25 @@ export function initializeAssimpWorker() {
         // Assimp로 source → glb (C SDK 변환을 선택한 경우에는 이미 outputPath가 생성됨)
         // 텍스처 포함을 위해 DAE 파일이 있는 디렉토리에서 실행
         // 하지만 출력 파일은 절대 경로로 지정해야 함
-        const command = `${ASSIMP_PATH} export "${sourcePath}" "${outputPath}" glb`;
+        if (nativeGlb) {
+          await fs.copyFile(sourcePath, outputPath);
+          // --meshopt: EXT_meshopt_compression 미지원 클라이언트용 원본 버퍼 (GLB 기준 상대 uri)
+          const fallbackPath = join(intermediateDir!, 'model.fallback.bin');
+          if (existsSync(fallbackPath)) {
+            await fs.copyFile(fallbackPath, join(outputDirForFile, 'model.fallback.bin'));
+          }
+        } else {
+          const command = `${ASSIMP_PATH} export "${sourcePath}" "${outputPath}" glb`;
 
-        // 입력(DAE/OBJ)이 있는 디렉토리에서 실행하여 텍스처 경로 문제 해결
-        // 출력 파일은 절대 경로로 지정하므로 cwd와 관계없이 작동
-        const workingDir = intermediateDir ?? join(outputPath, '..');
+          // 입력(DAE/OBJ)이 있는 디렉토리에서 실행하여 텍스처 경로 문제 해결
+          // 출력 파일은 절대 경로로 지정하므로 cwd와 관계없이 작동
+          const workingDir = intermediateDir ?? join(outputPath, '..');
 
-        await execAsync(command, {
-          maxBuffer: 50 * 1024 * 1024, // 50MB
-          cwd: workingDir, // 텍스처 경로 문제 해결 (입력 파일 기준)
-        });
+          await execAsync(command, {
+            maxBuffer: 50 * 1024 * 1024, // 50MB
+            cwd: workingDir, // 텍스처 경로 문제 해결 (입력 파일 기준)
+          });
+        }
 
         await job.progress(70);
 
@@ -129,7 +157,8 @@ export function initializeAssimpWorker() {
             if (texFiles.length > 0) {
               console.log(`[변환] 텍스처 샘플: ${texFiles.slice(0, 5).join(', ')}`);
             }
-          } else {
+          } else if (!nativeGlb) {
+            // 컨버터가 GLB를 직접 기록하면 텍스처가 GLB에 들어가 model/ 폴더가 없는 것이 정상
             console.warn(`[변환] 텍스처 디렉토리가 없습니다: ${srcTexDir}`);
           }
         }
@@ -181,35 +210,6 @@ export function initializeAssimpWorker() {
           }
         }
 
-        // Draco 압축 (옵션)
-        // NOTE: 현재 gltf-pipeline가 의존하는 cesium CJS/ESM 호환 문제로 런타임 에러가 발생할 수 있어
-        // 기본은 비활성화하고, 필요 시 SKETCHUP_ENABLE_DRACO=1로 켭니다.
-        if (process.env.SKETCHUP_ENABLE_DRACO === '1') {
-          try {
-            const gltfPipeline = await import('gltf-pipeline');
-            const pipeline = (gltfPipeline as any).default || gltfPipeline;
-
-            const glbBuffer = await fs.readFile(outputPath);
-            const options = {
-              dracoOptions: {
-                compressionLevel: 7,
-                quantizePositionBits: 14,
-                quantizeNormalBits: 10,
-                quantizeTexcoordBits: 12,
-              },
-            };
-
-            const processed = await pipeline.processGlb(glbBuffer, options);
-            if (processed && processed.glb) {
-              await fs.writeFile(outputPath, Buffer.from(processed.glb));
-            } else {
-              console.warn('Draco 압축 결과가 비어있음, 원본 GLB 사용');
-            }
-          } catch (dracoError) {
-            console.warn('Draco 압축 실패, 원본 GLB 사용:', dracoError);
-          }
-        }
-
         await job.progress(100);
 
         // 원격 저장 모드: 변환 결과를 메인 서버로 업로드 후 로컬 파일은 제거
@@ -17,8 +17,11 @@ export type ConvertSkpToGlbWithCSDKOptions = {
    * 중간 산출물 포맷. 기본은 obj.
    * - obj: model.obj + model.mtl (+ model/* 텍스처)
    * - dae: model.dae (+ model/* 텍스처)
+   * - glb: model.glb (+ model/* 텍스처) — 컨버터가 GLB를 직접 기록하므로 Assimp 단계가 필요 없음
    */
-  format?: "obj" | "dae";
+  format?: "obj" | "dae" | "glb";
+  /** argv 끝에 덧붙일 컨버터 옵션 (예: ["--draco"]) */
+  extraArgs?: string[];
   timeoutMs?: number;
 };
 
@@ -68,12 +71,13 @@ function parseArgsJson(raw: string): string[] {
  * - {input}: inputSkpPath
  * - {output}: outputDirForFile (출력 디렉토리)
  * - {outDir}: outputDirForFile
- * - {format}: obj | dae
+ * - {format}: obj | dae | glb
  */
 export async function convertSkpToIntermediateWithSketchupCSDK({
   inputSkpPath,
   outputDirForFile,
   format = "obj",
+  extraArgs = [],
   timeoutMs = 10 * 60 * 1000, // 10분
 }: ConvertSkpToGlbWithCSDKOptions): Promise<{ intermediatePath: string }> {
   if (!existsSync(inputSkpPath)) {
@@ -107,7 +111,7 @@ export async function convertSkpToIntermediateWithSketchupCSDK({
     outDir: outputDirForFile,
     format,
   };
-  const args = argsTemplate.map((a) => replacePlaceholders(a, vars));
+  const args = [...argsTemplate.map((a) => replacePlaceholders(a, vars)), ...extraArgs];
 
   try {
     const extraEnv: Record<string, string> = {};
@@ -143,10 +147,7 @@ export async function convertSkpToIntermediateWithSketchupCSDK({
     );
   }
 
-  const intermediatePath =
-    format === "dae"
-      ? `${outputDirForFile}/model.dae`
-      : `${outputDirForFile}/model.obj`;
+  const intermediatePath = `${outputDirForFile}/model.${format}`;
 
   if (!existsSync(intermediatePath)) {
     throw new Error(
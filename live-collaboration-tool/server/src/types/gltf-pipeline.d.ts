@@ -1,5 +0,0 @@
-declare module "gltf-pipeline" {
-  const gltfPipeline: any;
-  export default gltfPipeline;
-}
-
@@ -0,0 +1,150 @@
+// 인덱스 버퍼 최적화 벤치마크: 정점 캐시(Tipsify) + overdraw + fetch 전후의 ACMR/ATVR
+//
+// 사용법: mesh_optimize_bench [model.obj ...]
+// - 인자가 없으면 합성 메시만 측정합니다.
+// - OBJ는 obj_reader.h로 읽습니다.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mesh_optimize.h"
+#include "obj_reader.h"
+
+struct BenchMesh {
+  std::string name;
+  std::vector<float> positions;
+  std::vector<uint32_t> indices;
+};
+
+static uint32_t AddVertex(BenchMesh* m, float x, float y, float z) {
+  m->positions.insert(m->positions.end(), {x, y, z});
+  return static_cast<uint32_t>(m->positions.size() / 3 - 1);
+}
+
+static void ShuffleTriangles(BenchMesh* m, uint64_t seed) {
+  std::vector<std::array<uint32_t, 3>> tris(m->indices.size() / 3);
+  for (size_t t = 0; t < tris.size(); t++) {
+    tris[t] = {m->indices[t * 3], m->indices[t * 3 + 1], m->indices[t * 3 + 2]};
+  }
+  std::mt19937_64 rng(seed);
+  std::shuffle(tris.begin(), tris.end(), rng);
+  for (size_t t = 0; t < tris.size(); t++) {
+    for (int k = 0; k < 3; k++) m->indices[t * 3 + k] = tris[t][k];
+  }
+}
+
+// 행 순서로 삼각형을 만든 n x n 격자 (지형/곡면 테셀레이션 유사)
+static BenchMesh MakeGrid(size_t n, bool shuffled) {
+  BenchMesh m;
+  m.name = shuffled ? "grid-shuffled" : "grid";
+  for (size_t y = 0; y <= n; y++) {
+    for (size_t x = 0; x <= n; x++) AddVertex(&m, static_cast<float>(x), static_cast<float>(y), 0.0f);
+  }
+  const uint32_t row = static_cast<uint32_t>(n + 1);
+  for (uint32_t y = 0; y < n; y++) {
+    for (uint32_t x = 0; x < n; x++) {
+      const uint32_t a = y * row + x;
+      m.indices.insert(m.indices.end(), {a, a + 1, a + row, a + 1, a + row + 1, a + row});
+    }
+  }
+  if (shuffled) ShuffleTriangles(&m, 7);
+  return m;
+}
+
+// 면마다 정점을 따로 가진 상자 여러 개를 임의 순서로 (건축 모델의 face 순서 유사)
+static BenchMesh MakeBoxes(size_t count) {
+  BenchMesh m;
+  m.name = "boxes-shuffled";
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<float> pos(-5000.0f, 5000.0f);
+  std::uniform_real_distribution<float> size(10.0f, 200.0f);
+  for (size_t b = 0; b < count; b++) {
+    const float o[3] = {pos(rng), pos(rng), pos(rng)};
+    const float s[3] = {size(rng), size(rng), size(rng)};
+    for (int axis = 0; axis < 3; axis++) {
+      for (int side = 0; side < 2; side++) {
+        const int u = (axis + 1) % 3;
+        const int v = (axis + 2) % 3;
+        uint32_t q[4];
+        for (int c = 0; c < 4; c++) {
+          float p[3] = {o[0], o[1], o[2]};
+          p[axis] += side ? s[axis] : 0.0f;
+          p[u] += (c == 1 || c == 2) ? s[u] : 0.0f;
+          p[v] += (c >= 2) ? s[v] : 0.0f;
+          q[c] = AddVertex(&m, p[0], p[1], p[2]);
+        }
+        // 바깥쪽이 반시계가 되도록 side에 따라 감는 방향을 바꿈
+        if (side) {
+          m.indices.insert(m.indices.end(), {q[0], q[1], q[2], q[0], q[2], q[3]});
+        } else {
+          m.indices.insert(m.indices.end(), {q[0], q[2], q[1], q[0], q[3], q[2]});
+        }
+      }
+    }
+  }
+  ShuffleTriangles(&m, 11);
+  return m;
+}
+
+// 회전과 무관하게 같은 삼각형 집합인지 확인
+static std::vector<std::array<uint32_t, 3>> CanonicalTriangles(const std::vector<uint32_t>& indices) {
+  std::vector<std::array<uint32_t, 3>> tris(indices.size() / 3);
+  for (size_t t = 0; t < tris.size(); t++) {
+    std::array<uint32_t, 3> a = {indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]};
+    while (a[0] > a[1] || a[0] > a[2]) a = {a[1], a[2], a[0]};
+    tris[t] = a;
+  }
+  std::sort(tris.begin(), tris.end());
+  return tris;
+}
+
+static void Run(const BenchMesh& input) {
+  const size_t vertex_count = input.positions.size() / 3;
+  const VertexCacheStats before = AnalyzeVertexCache(input.indices, vertex_count);
+
+  std::vector<uint32_t> indices = input.indices;
+  const auto t0 = std::chrono::steady_clock::now();
+  OptimizeVertexCache(&indices, vertex_count);
+  const auto t1 = std::chrono::steady_clock::now();
+  const VertexCacheStats cache_only = AnalyzeVertexCache(indices, vertex_count);
+  OptimizeOverdraw(&indices, input.positions);
+  const auto t2 = std::chrono::steady_clock::now();
+  const std::vector<uint32_t> reordered = indices;
+  size_t fetched = 0;
+  OptimizeVertexFetch(&indices, vertex_count, &fetched);
+  const auto t3 = std::chrono::steady_clock::now();
+  const bool valid = CanonicalTriangles(reordered) == CanonicalTriangles(input.indices);
+  const VertexCacheStats after = AnalyzeVertexCache(indices, fetched);
+
+  const auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+  };
+  std::printf("%-20s tris=%-9zu verts=%-9zu ACMR %.3f -> %.3f (cache only %.3f)  ATVR %.3f -> %.3f  "
+              "%.1f ms (cache %.1f, overdraw %.1f, fetch %.1f) valid=%s\n",
+              input.name.c_str(), before.triangles, before.vertices, before.acmr, after.acmr, cache_only.acmr,
+              before.atvr, after.atvr, ms(t0, t3), ms(t0, t1), ms(t1, t2), ms(t2, t3), valid ? "yes" : "no");
+}
+
+int main(int argc, char** argv) {
+  std::printf("FIFO cache size=%u\n", kDefaultVertexCacheSize);
+  Run(MakeGrid(512, false));
+  Run(MakeGrid(512, true));
+  Run(MakeBoxes(20000));
+  for (int i = 1; i < argc; i++) {
+    BenchMesh m;
+    m.name = argv[i];
+    if (!LoadObj(argv[i], &m.positions, &m.indices)) {
+      std::cerr << "Failed to read: " << argv[i] << "\n";
+      return 1;
+    }
+    Run(m);
+  }
+  return 0;
+}
@@ -0,0 +1,264 @@
+// LOD 단순화 벤치마크: 삼각형 처리량(입력 삼각형/초)과 오차
+//
+// 사용법: mesh_simplify_bench [model.obj ...]
+// - 인자가 없으면 합성 메시만 측정합니다.
+// - OBJ는 obj_reader.h로 읽습니다.
+// 오차는 바운딩 박스 긴 변 대비: reported는 quadric 오차, measured는 원본 정점(최대 1000개 표본)에서
+// 단순화된 표면까지의 최대 거리. open edges는 위치 기준 짝 없는 edge 수로, seam/material 경계가
+// 벌어지지 않았다면 단순화 후에도 늘지 않습니다.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mesh_simplify.h"
+#include "obj_reader.h"
+
+static uint32_t AddVertex(GltfPrimitive* p, const float pos[3], const float nrm[3], float u, float v) {
+  p->positions.insert(p->positions.end(), pos, pos + 3);
+  p->normals.insert(p->normals.end(), nrm, nrm + 3);
+  p->texcoords.insert(p->texcoords.end(), {u, v});
+  return static_cast<uint32_t>(p->vertex_count() - 1);
+}
+
+// 경도 0에 uv seam이 있는 매끈한 구 (곡면 component 유사)
+static GltfMesh MakeSphere(uint32_t segments) {
+  GltfMesh m;
+  m.name = "uv-sphere";
+  m.primitives.emplace_back();
+  GltfPrimitive& p = m.primitives.back();
+  const uint32_t rings = segments / 2;
+  const double pi = 3.14159265358979323846;
+  for (uint32_t r = 0; r <= rings; r++) {
+    for (uint32_t s = 0; s <= segments; s++) {
+      const double theta = pi * r / rings;
+      const double phi = s == segments ? 0.0 : 2.0 * pi * s / segments;  // 경도 0과 같은 위치 (uv만 다름)
+      const double st = (r == 0 || r == rings) ? 0.0 : std::sin(theta);  // 극점은 한 위치
+      const float n[3] = {static_cast<float>(st * std::cos(phi)), static_cast<float>(st * std::sin(phi)),
+                          static_cast<float>(std::cos(theta))};
+      const float pos[3] = {n[0] * 100.0f, n[1] * 100.0f, n[2] * 100.0f};
+      AddVertex(&p, pos, n, static_cast<float>(s) / segments, static_cast<float>(r) / rings);
+    }
+  }
+  const uint32_t row = segments + 1;
+  for (uint32_t r = 0; r < rings; r++) {
+    for (uint32_t s = 0; s < segments; s++) {
+      const uint32_t a = r * row + s;
+      if (r > 0) p.indices.insert(p.indices.end(), {a, a + row, a + 1});
+      if (r + 1 < rings) p.indices.insert(p.indices.end(), {a + 1, a + row, a + row + 1});
+    }
+  }
+  // 극점은 경도마다 정점이 따로라 위치가 같은 정점이 여럿 → 고정됨
+  return m;
+}
+
+// 완만한 높이맵 격자 (지형)
+static GltfMesh MakeTerrain(uint32_t n) {
+  GltfMesh m;
+  m.name = "terrain";
+  m.primitives.emplace_back();
+  GltfPrimitive& p = m.primitives.back();
+  for (uint32_t y = 0; y <= n; y++) {
+    for (uint32_t x = 0; x <= n; x++) {
+      const double fx = static_cast<double>(x) / n;
+      const double fy = static_cast<double>(y) / n;
+      const float pos[3] = {static_cast<float>(fx * 1000.0), static_cast<float>(fy * 1000.0),
+                            static_cast<float>(40.0 * std::sin(fx * 7.0) * std::cos(fy * 5.0))};
+      const float nrm[3] = {0.0f, 0.0f, 1.0f};
+      AddVertex(&p, pos, nrm, static_cast<float>(fx), static_cast<float>(fy));
+    }
+  }
+  const uint32_t row = n + 1;
+  for (uint32_t y = 0; y < n; y++) {
+    for (uint32_t x = 0; x < n; x++) {
+      const uint32_t a = y * row + x;
+      p.indices.insert(p.indices.end(), {a, a + 1, a + row, a + 1, a + row + 1, a + row});
+    }
+  }
+  return m;
+}
+
+// 면마다 정점이 따로인 잘게 나뉜 상자. 축마다 다른 material (평면 face가 많은 건축 모델 유사)
+static GltfMesh MakeTessellatedBoxes(size_t count, uint32_t subdiv) {
+  GltfMesh m;
+  m.name = "boxes-flat";
+  m.primitives.resize(3);
+  for (int axis = 0; axis < 3; axis++) m.primitives[axis].material = axis;
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<float> pos(-5000.0f, 5000.0f);
+  std::uniform_real_distribution<float> size(10.0f, 200.0f);
+  for (size_t b = 0; b < count; b++) {
+    const float o[3] = {pos(rng), pos(rng), pos(rng)};
+    const float s[3] = {size(rng), size(rng), size(rng)};
+    for (int axis = 0; axis < 3; axis++) {
+      GltfPrimitive& p = m.primitives[axis];
+      for (int side = 0; side < 2; side++) {
+        const int u = (axis + 1) % 3;
+        const int v = (axis + 2) % 3;
+        float nrm[3] = {0.0f, 0.0f, 0.0f};
+        nrm[axis] = side ? 1.0f : -1.0f;
+        const uint32_t first = static_cast<uint32_t>(p.vertex_count());
+        for (uint32_t j = 0; j <= subdiv; j++) {
+          for (uint32_t i = 0; i <= subdiv; i++) {
+            float q[3] = {o[0], o[1], o[2]};
+            q[axis] += side ? s[axis] : 0.0f;
+            q[u] += s[u] * i / subdiv;
+            q[v] += s[v] * j / subdiv;
+            AddVertex(&p, q, nrm, static_cast<float>(i) / subdiv, static_cast<float>(j) / subdiv);
+          }
+        }
+        const uint32_t row = subdiv + 1;
+        for (uint32_t j = 0; j < subdiv; j++) {
+          for (uint32_t i = 0; i < subdiv; i++) {
+            const uint32_t a = first + j * row + i;
+            if (side) {
+              p.indices.insert(p.indices.end(), {a, a + 1, a + row + 1, a, a + row + 1, a + row});
+            } else {
+              p.indices.insert(p.indices.end(), {a, a + row + 1, a + 1, a, a + row, a + row + 1});
+            }
+          }
+        }
+      }
+    }
+  }
+  return m;
+}
+
+static size_t TriangleCount(const GltfMesh& m) {
+  size_t count = 0;
+  for (const GltfPrimitive& p : m.primitives) count += p.indices.size() / 3;
+  return count;
+}
+
+// 위치 기준으로 반대 방향 짝이 없는 edge 수
+static size_t OpenEdges(const GltfMesh& m) {
+  std::set<std::array<float, 6>> edges;
+  for (const GltfPrimitive& p : m.primitives) {
+    for (size_t i = 0; i < p.indices.size(); i += 3) {
+      for (int k = 0; k < 3; k++) {
+        const float* a = &p.positions[p.indices[i + k] * 3];
+        const float* b = &p.positions[p.indices[i + (k + 1) % 3] * 3];
+        edges.insert({a[0], a[1], a[2], b[0], b[1], b[2]});
+      }
+    }
+  }
+  size_t open = 0;
+  for (const std::array<float, 6>& e : edges) {
+    if (!edges.count({e[3], e[4], e[5], e[0], e[1], e[2]})) open++;
+  }
+  return open;
+}
+
+static double PointTriangleDistance(const double p[3], const float* a, const float* b, const float* c) {
+  // Ericson, "Real-Time Collision Detection" 5.1.5
+  const double ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+  const double ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+  const double ap[3] = {p[0] - a[0], p[1] - a[1], p[2] - a[2]};
+  auto dot = [](const double* x, const double* y) { return x[0] * y[0] + x[1] * y[1] + x[2] * y[2]; };
+  double q[3];
+  const double d1 = dot(ab, ap), d2 = dot(ac, ap);
+  const double bp[3] = {p[0] - b[0], p[1] - b[1], p[2] - b[2]};
+  const double d3 = dot(ab, bp), d4 = dot(ac, bp);
+  const double cp[3] = {p[0] - c[0], p[1] - c[1], p[2] - c[2]};
+  const double d5 = dot(ab, cp), d6 = dot(ac, cp);
+  const double va = d3 * d6 - d5 * d4, vb = d5 * d2 - d1 * d6, vc = d1 * d4 - d3 * d2;
+  if (d1 <= 0 && d2 <= 0) {
+    for (int k = 0; k < 3; k++) q[k] = a[k];
+  } else if (d3 >= 0 && d4 <= d3) {
+    for (int k = 0; k < 3; k++) q[k] = b[k];
+  } else if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+    const double t = d1 / (d1 - d3);
+    for (int k = 0; k < 3; k++) q[k] = a[k] + t * ab[k];
+  } else if (d6 >= 0 && d5 <= d6) {
+    for (int k = 0; k < 3; k++) q[k] = c[k];
+  } else if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+    const double t = d2 / (d2 - d6);
+    for (int k = 0; k < 3; k++) q[k] = a[k] + t * ac[k];
+  } else if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+    const double t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    for (int k = 0; k < 3; k++) q[k] = b[k] + t * (c[k] - b[k]);
+  } else {
+    const double denom = 1.0 / (va + vb + vc);
+    const double v = vb * denom, w = vc * denom;
+    for (int k = 0; k < 3; k++) q[k] = a[k] + ab[k] * v + ac[k] * w;
+  }
+  const double d[3] = {p[0] - q[0], p[1] - q[1], p[2] - q[2]};
+  return std::sqrt(dot(d, d));
+}
+
+static double Extent(const GltfMesh& m) {
+  float lo[3] = {1e30f, 1e30f, 1e30f};
+  float hi[3] = {-1e30f, -1e30f, -1e30f};
+  for (const GltfPrimitive& p : m.primitives) {
+    for (size_t i = 0; i < p.positions.size(); i++) {
+      lo[i % 3] = std::min(lo[i % 3], p.positions[i]);
+      hi[i % 3] = std::max(hi[i % 3], p.positions[i]);
+    }
+  }
+  return std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2], 0.0f});
+}
+
+// 원본 정점 표본에서 단순화된 표면까지의 최대 거리 (긴 변 대비)
+static double MeasuredError(const GltfMesh& original, const GltfMesh& simplified) {
+  std::vector<const float*> samples;
+  for (const GltfPrimitive& p : original.primitives) {
+    for (size_t i = 0; i < p.vertex_count(); i++) samples.push_back(&p.positions[i * 3]);
+  }
+  const size_t step = std::max<size_t>(1, samples.size() / 1000);
+  double worst = 0.0;
+  for (size_t s = 0; s < samples.size(); s += step) {
+    const double p[3] = {samples[s][0], samples[s][1], samples[s][2]};
+    double best = 1e300;
+    for (const GltfPrimitive& prim : simplified.primitives) {
+      for (size_t i = 0; i < prim.indices.size() && best > 0.0; i += 3) {
+        best = std::min(best, PointTriangleDistance(p, &prim.positions[prim.indices[i] * 3],
+                                                    &prim.positions[prim.indices[i + 1] * 3],
+                                                    &prim.positions[prim.indices[i + 2] * 3]));
+      }
+    }
+    worst = std::max(worst, best);
+  }
+  const double extent = Extent(original);
+  return extent > 0.0 ? worst / extent : 0.0;
+}
+
+static void Run(const GltfMesh& input) {
+  const size_t open_before = OpenEdges(input);
+  for (double ratio : {0.5, 0.25, 0.1}) {
+    SimplifyStats stats;
+    const auto t0 = std::chrono::steady_clock::now();
+    const GltfMesh lod = SimplifyMesh(input, ratio, 1.0, &stats);
+    const auto t1 = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(t1 - t0).count();
+    std::printf("%-16s ratio=%-5.2f tris %9zu -> %-9zu %8.1f ms %6.2f Mtri/s  error reported %.5f measured %.5f"
+                "  open edges %zu -> %zu  primitives %zu -> %zu\n",
+                input.name.c_str(), ratio, stats.triangles_before, TriangleCount(lod), seconds * 1000.0,
+                stats.triangles_before / seconds / 1e6, stats.error, MeasuredError(input, lod), open_before,
+                OpenEdges(lod), input.primitives.size(), lod.primitives.size());
+  }
+}
+
+int main(int argc, char** argv) {
+  Run(MakeSphere(256));
+  Run(MakeTerrain(512));
+  Run(MakeTessellatedBoxes(500, 8));
+  for (int i = 1; i < argc; i++) {
+    GltfMesh m;
+    m.name = argv[i];
+    m.primitives.emplace_back();
+    if (!LoadObj(argv[i], &m.primitives[0].positions, &m.primitives[0].indices)) {
+      std::cerr << "Failed to read: " << argv[i] << "\n";
+      return 1;
+    }
+    Run(m);
+  }
+  return 0;
+}
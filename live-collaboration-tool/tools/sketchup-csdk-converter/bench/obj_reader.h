@@ -0,0 +1,43 @@
+#pragma once
+
+// 벤치마크용 최소 OBJ 리더.
+// v / f만 읽어 position 인덱스를 정점으로 씁니다 (변환기 model.obj를 그대로 넣을 수 있음).
+// 다각형 f는 부채꼴로 삼각형화합니다.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+inline int ObjIndex(const std::string& token, size_t vertex_count) {
+  const long i = std::strtol(token.c_str(), nullptr, 10);  // "a/b/c" → a
+  return static_cast<int>(i < 0 ? static_cast<long>(vertex_count) + i : i - 1);
+}
+
+// positions(xyz)와 indices(삼각형)에 이어 붙임. 파일을 열지 못하면 false
+inline bool LoadObj(const std::string& path, std::vector<float>* positions, std::vector<uint32_t>* indices) {
+  std::ifstream in(path);
+  if (!in) return false;
+  std::string line;
+  std::vector<int> face;
+  while (std::getline(in, line)) {
+    if (line.size() > 2 && line[0] == 'v' && line[1] == ' ') {
+      float x = 0, y = 0, z = 0;
+      std::sscanf(line.c_str() + 2, "%f %f %f", &x, &y, &z);
+      positions->insert(positions->end(), {x, y, z});
+    } else if (line.size() > 2 && line[0] == 'f' && line[1] == ' ') {
+      std::istringstream ss(line.substr(2));
+      std::string token;
+      face.clear();
+      while (ss >> token) face.push_back(ObjIndex(token, positions->size() / 3));
+      for (size_t k = 1; k + 1 < face.size(); k++) {
+        indices->insert(indices->end(), {static_cast<uint32_t>(face[0]), static_cast<uint32_t>(face[k]),
+                                         static_cast<uint32_t>(face[k + 1])});
+      }
+    }
+  }
+  return true;
+}
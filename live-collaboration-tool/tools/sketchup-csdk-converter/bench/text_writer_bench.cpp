@@ -0,0 +1,106 @@
+// OBJ 텍스트 출력 마이크로벤치마크: std::ofstream << double vs TextWriter(std::to_chars)
+//
+// 사용법: text_writer_bench [triangles=1000000] [precision=6]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "text_writer.h"
+
+namespace fs = std::filesystem;
+
+struct Vertex {
+  double p[3];
+  double n[3];
+  double uv[2];
+};
+
+// ObjWriter와 같은 줄 구성 (v / vt / vn + f a/b/c)
+template <typename Out>
+static void WriteObj(Out& out, const std::vector<Vertex>& verts) {
+  out << "mtllib model.mtl\n";
+  for (const Vertex& v : verts) {
+    out << "v " << v.p[0] << " " << v.p[1] << " " << v.p[2] << "\n";
+    out << "vt " << v.uv[0] << " " << v.uv[1] << "\n";
+    out << "vn " << v.n[0] << " " << v.n[1] << " " << v.n[2] << "\n";
+  }
+  for (size_t i = 0; i + 2 < verts.size(); i += 3) {
+    out << "f";
+    for (size_t k = i + 1; k <= i + 3; k++) out << " " << k << "/" << k << "/" << k;
+    out << "\n";
+  }
+}
+
+static double Seconds(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+  return std::chrono::duration<double>(b - a).count();
+}
+
+static bool SameContents(const fs::path& a, const fs::path& b) {
+  std::ifstream fa(a, std::ios::binary);
+  std::ifstream fb(b, std::ios::binary);
+  std::vector<char> ba((std::istreambuf_iterator<char>(fa)), std::istreambuf_iterator<char>());
+  std::vector<char> bb((std::istreambuf_iterator<char>(fb)), std::istreambuf_iterator<char>());
+  return ba == bb;
+}
+
+int main(int argc, char** argv) {
+  const size_t triangles = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  const int precision = argc > 2 ? std::atoi(argv[2]) : TextWriter::kDefaultPrecision;
+
+  // 건축 모델 스케일(인치 단위 수천~수만)의 임의 좌표
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> pos(-50000.0, 50000.0);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  std::vector<Vertex> verts(triangles * 3);
+  for (Vertex& v : verts) {
+    for (double& c : v.p) c = pos(rng);
+    for (double& c : v.n) c = unit(rng);
+    for (double& c : v.uv) c = unit(rng) * 8.0;
+  }
+
+  const fs::path dir = fs::temp_directory_path();
+  const fs::path stream_path = dir / "text_writer_bench_ofstream.obj";
+  const fs::path writer_path = dir / "text_writer_bench_to_chars.obj";
+
+  auto t0 = std::chrono::steady_clock::now();
+  {
+    std::ofstream out(stream_path, std::ios::out | std::ios::trunc);
+    out.precision(precision);
+    WriteObj(out, verts);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  {
+    TextWriter out;
+    out.open(writer_path);
+    out.set_precision(precision);
+    WriteObj(out, verts);
+    if (!out.close()) {
+      std::cerr << "TextWriter failed\n";
+      return 1;
+    }
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  const double stream_bytes = static_cast<double>(fs::file_size(stream_path));
+  const double writer_bytes = static_cast<double>(fs::file_size(writer_path));
+  const double stream_s = Seconds(t0, t1);
+  const double writer_s = Seconds(t1, t2);
+
+  std::printf("triangles=%zu precision=%d\n", triangles, precision);
+  std::printf("%-16s %12.0f bytes %8.3f s %9.1f MB/s\n", "std::ofstream", stream_bytes, stream_s,
+              stream_bytes / stream_s / 1e6);
+  std::printf("%-16s %12.0f bytes %8.3f s %9.1f MB/s\n", "TextWriter", writer_bytes, writer_s,
+              writer_bytes / writer_s / 1e6);
+  std::printf("speedup=%.2fx identical=%s\n", stream_s / writer_s,
+              SameContents(stream_path, writer_path) ? "yes" : "no");
+
+  fs::remove(stream_path);
+  fs::remove(writer_path);
+  return 0;
+}
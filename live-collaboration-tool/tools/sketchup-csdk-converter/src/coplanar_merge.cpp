@@ -0,0 +1,451 @@
+#include "coplanar_merge.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "union_find.h"
+
+namespace {
+
+// 두 normal 사이 각이 약 0.003도 이하면 같은 평면 (공유 edge가 있으므로 평면도 같음)
+constexpr double kCoplanarDot = 1.0 - 1e-9;
+// 이웃 face 정점의 uv를 한 face의 affine 매핑으로 예측했을 때 허용 오차
+constexpr double kTexcoordTolerance = 1e-4;
+// ear clipping은 정점 수의 제곱에 비례하므로 이보다 큰 다각형은 합치지 않음
+constexpr size_t kMaxPolygonVertices = 2048;
+
+uint64_t DirectedKey(int from, int to) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(from)) << 32) | static_cast<uint32_t>(to);
+}
+
+struct Point2 {
+  double x = 0.0;
+  double y = 0.0;
+};
+
+double Cross(const Point2& o, const Point2& a, const Point2& b) {
+  return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+bool SamePoint(const Point2& a, const Point2& b) { return a.x == b.x && a.y == b.y; }
+
+// normal과 함께 오른손 좌표계를 이루는 평면 두 축
+struct PlaneBasis {
+  double u[3];
+  double v[3];
+
+  explicit PlaneBasis(const double n[3]) {
+    // normal과 가장 덜 평행한 좌표축으로 u = axis × n
+    int axis = 0;
+    if (std::fabs(n[1]) < std::fabs(n[axis])) axis = 1;
+    if (std::fabs(n[2]) < std::fabs(n[axis])) axis = 2;
+    double a[3] = {0.0, 0.0, 0.0};
+    a[axis] = 1.0;
+    u[0] = a[1] * n[2] - a[2] * n[1];
+    u[1] = a[2] * n[0] - a[0] * n[2];
+    u[2] = a[0] * n[1] - a[1] * n[0];
+    const double length = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+    for (double& c : u) c /= length;
+    v[0] = n[1] * u[2] - n[2] * u[1];
+    v[1] = n[2] * u[0] - n[0] * u[2];
+    v[2] = n[0] * u[1] - n[1] * u[0];
+  }
+
+  Point2 project(const std::vector<double>& positions, int id) const {
+    const double* p = &positions[static_cast<size_t>(id) * 3];
+    return {p[0] * u[0] + p[1] * u[1] + p[2] * u[2], p[0] * v[0] + p[1] * v[1] + p[2] * v[2]};
+  }
+};
+
+// face 평면 좌표 → uv affine 매핑 (uv = uv0 + A (p - p0))
+struct TexcoordMap {
+  bool valid = false;
+  Point2 p0;
+  double uv0[2] = {0.0, 0.0};
+  double a[2][2] = {{0.0, 0.0}, {0.0, 0.0}};
+
+  void predict(const Point2& p, double uv[2]) const {
+    const double dx = p.x - p0.x, dy = p.y - p0.y;
+    uv[0] = uv0[0] + a[0][0] * dx + a[0][1] * dy;
+    uv[1] = uv0[1] + a[1][0] * dx + a[1][1] * dy;
+  }
+};
+
+// 합치기 전 face 하나의 준비 정보
+struct FaceInfo {
+  bool reversed = false;  // 바깥 loop가 normal 기준 시계 방향이라 loop를 거꾸로 읽음
+  TexcoordMap uv_map;
+};
+
+double LoopArea(const std::vector<int>& loop, const PlaneBasis& basis, const std::vector<double>& positions) {
+  double area = 0.0;
+  for (size_t i = 0; i < loop.size(); i++) {
+    const Point2 a = basis.project(positions, loop[i]);
+    const Point2 b = basis.project(positions, loop[(i + 1) % loop.size()]);
+    area += a.x * b.y - a.y * b.x;
+  }
+  return 0.5 * area;
+}
+
+// 바깥 loop에서 넓이가 가장 큰 세 정점으로 uv 매핑을 풂
+TexcoordMap SolveTexcoordMap(const CoplanarFace& face, const PlaneBasis& basis, const std::vector<double>& positions) {
+  TexcoordMap map;
+  const std::vector<int>& outer = face.loops[0];
+  if (outer.size() < 3) return map;
+  const Point2 p0 = basis.project(positions, outer[0]);
+  size_t i1 = 0;
+  double best = 0.0;
+  for (size_t i = 1; i < outer.size(); i++) {
+    const Point2 p = basis.project(positions, outer[i]);
+    const double d = (p.x - p0.x) * (p.x - p0.x) + (p.y - p0.y) * (p.y - p0.y);
+    if (d > best) {
+      best = d;
+      i1 = i;
+    }
+  }
+  if (i1 == 0) return map;
+  const Point2 p1 = basis.project(positions, outer[i1]);
+  size_t i2 = 0;
+  best = 0.0;
+  for (size_t i = 1; i < outer.size(); i++) {
+    const double area = std::fabs(Cross(p0, p1, basis.project(positions, outer[i])));
+    if (area > best) {
+      best = area;
+      i2 = i;
+    }
+  }
+  // 일직선에 가까운 face는 매핑을 정할 수 없음
+  const double extent = (p1.x - p0.x) * (p1.x - p0.x) + (p1.y - p0.y) * (p1.y - p0.y);
+  if (i2 == 0 || best <= 1e-9 * extent) return map;
+  const Point2 p2 = basis.project(positions, outer[i2]);
+  const double d1[2] = {p1.x - p0.x, p1.y - p0.y};
+  const double d2[2] = {p2.x - p0.x, p2.y - p0.y};
+  const double det = d1[0] * d2[1] - d1[1] * d2[0];
+  const float* t = face.texcoords.data();
+  for (int c = 0; c < 2; c++) {
+    const double e1 = static_cast<double>(t[i1 * 2 + c]) - t[c];
+    const double e2 = static_cast<double>(t[i2 * 2 + c]) - t[c];
+    // [e1 e2] = A [d1 d2]
+    map.a[c][0] = (e1 * d2[1] - e2 * d1[1]) / det;
+    map.a[c][1] = (e2 * d1[0] - e1 * d2[0]) / det;
+    map.uv0[c] = t[c];
+  }
+  map.p0 = p0;
+  map.valid = true;
+  return map;
+}
+
+// from의 매핑이 to의 모든 정점 uv를 맞히는지
+bool SameTexcoordMap(const FaceInfo& from, const CoplanarFace& to, const PlaneBasis& basis,
+                     const std::vector<double>& positions) {
+  size_t corner = 0;
+  for (const std::vector<int>& loop : to.loops) {
+    for (int id : loop) {
+      double uv[2];
+      from.uv_map.predict(basis.project(positions, id), uv);
+      for (int c = 0; c < 2; c++) {
+        const double actual = to.texcoords[corner * 2 + c];
+        if (std::fabs(uv[c] - actual) > kTexcoordTolerance * (1.0 + std::fabs(actual))) return false;
+      }
+      corner++;
+    }
+  }
+  return true;
+}
+
+bool Mergeable(const CoplanarFace& a, const FaceInfo& ia, const CoplanarFace& b, const FaceInfo& ib,
+               const std::vector<double>& positions) {
+  if (a.material < 0 || a.material != b.material || !ia.uv_map.valid || !ib.uv_map.valid) return false;
+  const double dot = a.normal[0] * b.normal[0] + a.normal[1] * b.normal[1] + a.normal[2] * b.normal[2];
+  if (dot < kCoplanarDot) return false;
+  return SameTexcoordMap(ia, b, PlaneBasis(a.normal), positions);
+}
+
+struct RingVertex {
+  int id = 0;
+  Point2 p;
+};
+
+bool OnSegment(const Point2& a, const Point2& b, const Point2& p) {
+  return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) && std::min(a.y, b.y) <= p.y &&
+         p.y <= std::max(a.y, b.y);
+}
+
+// 선분 ab와 cd가 만나거나 닿는지
+bool SegmentsTouch(const Point2& a, const Point2& b, const Point2& c, const Point2& d) {
+  const double d1 = Cross(c, d, a);
+  const double d2 = Cross(c, d, b);
+  const double d3 = Cross(a, b, c);
+  const double d4 = Cross(a, b, d);
+  if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) return true;
+  if (d1 == 0 && OnSegment(c, d, a)) return true;
+  if (d2 == 0 && OnSegment(c, d, b)) return true;
+  if (d3 == 0 && OnSegment(a, b, c)) return true;
+  if (d4 == 0 && OnSegment(a, b, d)) return true;
+  return false;
+}
+
+// ring[i]에서 m 쪽 방향이 다각형 안쪽인지 (ring은 반시계)
+bool LocallyInside(const std::vector<RingVertex>& ring, size_t i, const Point2& m) {
+  const Point2& p = ring[i].p;
+  const Point2& prev = ring[(i + ring.size() - 1) % ring.size()].p;
+  const Point2& next = ring[(i + 1) % ring.size()].p;
+  if (Cross(prev, p, next) >= 0.0) {
+    // 볼록: next 방향에서 반시계로 prev 방향까지
+    return Cross(p, next, m) > 0.0 && Cross(p, m, prev) > 0.0;
+  }
+  // 오목: 바깥쪽 쐐기(prev 방향 → next 방향)만 아니면 안쪽
+  return !(Cross(p, prev, m) >= 0.0 && Cross(p, m, next) >= 0.0);
+}
+
+// bridge ring[i] - m이 ring이나 남은 구멍의 edge와 닿는지 (두 끝점에 붙은 edge는 제외)
+bool BridgeBlocked(const Point2& p, const Point2& m, const std::vector<RingVertex>& ring,
+                   const std::vector<std::vector<RingVertex>>& holes, size_t first_hole) {
+  auto blocked_by = [&](const std::vector<RingVertex>& loop) {
+    for (size_t k = 0; k < loop.size(); k++) {
+      const Point2& a = loop[k].p;
+      const Point2& b = loop[(k + 1) % loop.size()].p;
+      if (SamePoint(a, p) || SamePoint(b, p) || SamePoint(a, m) || SamePoint(b, m)) continue;
+      if (SegmentsTouch(p, m, a, b)) return true;
+    }
+    return false;
+  };
+  if (blocked_by(ring)) return true;
+  for (size_t h = first_hole; h < holes.size(); h++) {
+    if (blocked_by(holes[h])) return true;
+  }
+  return false;
+}
+
+// 구멍을 가장 가까운 보이는 바깥 정점에 이어 붙여 ring 하나로 만듦 (오른쪽 구멍부터)
+bool BridgeHoles(std::vector<RingVertex>* ring, std::vector<std::vector<RingVertex>> holes) {
+  auto max_x = [](const std::vector<RingVertex>& loop) {
+    size_t best = 0;
+    for (size_t k = 1; k < loop.size(); k++) {
+      if (loop[k].p.x > loop[best].p.x) best = k;
+    }
+    return best;
+  };
+  std::sort(holes.begin(), holes.end(), [&](const std::vector<RingVertex>& a, const std::vector<RingVertex>& b) {
+    return a[max_x(a)].p.x > b[max_x(b)].p.x;
+  });
+  for (size_t h = 0; h < holes.size(); h++) {
+    const std::vector<RingVertex>& hole = holes[h];
+    const size_t mi = max_x(hole);
+    const Point2 m = hole[mi].p;
+    std::vector<size_t> order(ring->size());
+    for (size_t k = 0; k < order.size(); k++) order[k] = k;
+    auto distance = [&](size_t k) {
+      const Point2& p = (*ring)[k].p;
+      return (p.x - m.x) * (p.x - m.x) + (p.y - m.y) * (p.y - m.y);
+    };
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return distance(a) < distance(b); });
+    size_t bridge = ring->size();
+    for (size_t k : order) {
+      const Point2& p = (*ring)[k].p;
+      if (SamePoint(p, m) || !LocallyInside(*ring, k, m)) continue;
+      if (BridgeBlocked(p, m, *ring, holes, h)) continue;
+      bridge = k;
+      break;
+    }
+    if (bridge == ring->size()) return false;
+    // ... P, M, 구멍 한 바퀴, M, P ...
+    std::vector<RingVertex> spliced;
+    spliced.reserve(hole.size() + 2);
+    for (size_t k = 0; k <= hole.size(); k++) spliced.push_back(hole[(mi + k) % hole.size()]);
+    spliced.push_back((*ring)[bridge]);
+    ring->insert(ring->begin() + static_cast<std::ptrdiff_t>(bridge) + 1, spliced.begin(), spliced.end());
+  }
+  return true;
+}
+
+// 반시계 ring을 ear clipping. bridge로 겹친 정점(같은 위치)은 귀 안쪽 검사에서 뺌
+bool Triangulate(const std::vector<RingVertex>& ring, std::vector<int>* triangles) {
+  const size_t n = ring.size();
+  if (n < 3) return false;
+  double lo[2] = {ring[0].p.x, ring[0].p.y};
+  double hi[2] = {lo[0], lo[1]};
+  for (const RingVertex& v : ring) {
+    lo[0] = std::min(lo[0], v.p.x);
+    lo[1] = std::min(lo[1], v.p.y);
+    hi[0] = std::max(hi[0], v.p.x);
+    hi[1] = std::max(hi[1], v.p.y);
+  }
+  const double extent = std::max(hi[0] - lo[0], hi[1] - lo[1]);
+  const double eps = 1e-12 * extent * extent;
+
+  std::vector<size_t> prev(n);
+  std::vector<size_t> next(n);
+  for (size_t i = 0; i < n; i++) {
+    prev[i] = (i + n - 1) % n;
+    next[i] = (i + 1) % n;
+  }
+  auto is_ear = [&](size_t b) {
+    const size_t a = prev[b];
+    const size_t c = next[b];
+    const Point2& pa = ring[a].p;
+    const Point2& pb = ring[b].p;
+    const Point2& pc = ring[c].p;
+    if (Cross(pa, pb, pc) <= eps) return false;
+    for (size_t k = next[c]; k != a; k = next[k]) {
+      const Point2& p = ring[k].p;
+      if (SamePoint(p, pa) || SamePoint(p, pb) || SamePoint(p, pc)) continue;
+      // 경계 위의 정점도 막음 (삼각형 edge 위에 정점이 남으면 T자 틈)
+      if (Cross(pa, pb, p) >= -eps && Cross(pb, pc, p) >= -eps && Cross(pc, pa, p) >= -eps) return false;
+    }
+    return true;
+  };
+
+  triangles->reserve(triangles->size() + (n - 2) * 3);
+  size_t remaining = n;
+  size_t current = 0;
+  size_t misses = 0;
+  while (remaining > 3) {
+    if (is_ear(current)) {
+      triangles->insert(triangles->end(), {ring[prev[current]].id, ring[current].id, ring[next[current]].id});
+      next[prev[current]] = next[current];
+      prev[next[current]] = prev[current];
+      current = next[current];
+      remaining--;
+      misses = 0;
+    } else {
+      current = next[current];
+      if (++misses > remaining) return false;
+    }
+  }
+  if (Cross(ring[prev[current]].p, ring[current].p, ring[next[current]].p) <= eps) return false;
+  triangles->insert(triangles->end(), {ring[prev[current]].id, ring[current].id, ring[next[current]].id});
+  return true;
+}
+
+// 묶음의 경계를 다각형 하나로 이어 삼각형화. 실패하면 false
+bool MergeGroup(const std::vector<CoplanarFace>& faces, const std::vector<FaceInfo>& info,
+                const std::vector<double>& positions, CoplanarGroup* group) {
+  // 묶음의 모든 directed edge (face 방향을 normal 기준 반시계로 맞춤)
+  std::vector<std::pair<int, int>> edges;
+  std::unordered_set<uint64_t> directed;
+  for (int f : group->faces) {
+    for (const std::vector<int>& loop : faces[f].loops) {
+      for (size_t i = 0; i < loop.size(); i++) {
+        int from = loop[i];
+        int to = loop[(i + 1) % loop.size()];
+        if (info[f].reversed) std::swap(from, to);
+        if (from == to || !directed.insert(DirectedKey(from, to)).second) return false;
+        edges.emplace_back(from, to);
+      }
+    }
+  }
+  // 반대 방향 edge가 있으면 안쪽 edge. 남은 경계는 정점마다 나가는 edge가 하나여야 loop로 이어짐
+  std::unordered_map<int, int> boundary_next;
+  for (const std::pair<int, int>& e : edges) {
+    if (directed.count(DirectedKey(e.second, e.first))) continue;
+    if (!boundary_next.emplace(e.first, e.second).second) return false;
+  }
+  if (boundary_next.size() > kMaxPolygonVertices) return false;
+
+  const PlaneBasis basis(faces[group->faces[0]].normal);
+  std::vector<RingVertex> outer;
+  std::vector<std::vector<RingVertex>> holes;
+  std::unordered_set<int> visited;
+  for (const std::pair<int, int>& e : edges) {
+    if (!boundary_next.count(e.first) || visited.count(e.first)) continue;
+    std::vector<RingVertex> loop;
+    double area = 0.0;
+    int id = e.first;
+    do {
+      if (!visited.insert(id).second) return false;
+      loop.push_back({id, basis.project(positions, id)});
+      auto it = boundary_next.find(id);
+      if (it == boundary_next.end()) return false;
+      id = it->second;
+    } while (id != e.first);
+    for (size_t i = 0; i < loop.size(); i++) {
+      const Point2& a = loop[i].p;
+      const Point2& b = loop[(i + 1) % loop.size()].p;
+      area += a.x * b.y - a.y * b.x;
+    }
+    if (area > 0.0) {
+      if (!outer.empty()) return false;
+      outer = std::move(loop);
+    } else {
+      holes.push_back(std::move(loop));
+    }
+  }
+  if (outer.size() < 3) return false;
+  if (!BridgeHoles(&outer, std::move(holes))) return false;
+  return Triangulate(outer, &group->triangles);
+}
+
+}  // namespace
+
+std::vector<CoplanarGroup> MergeCoplanarFaces(const std::vector<CoplanarFace>& faces,
+                                              const std::vector<double>& positions,
+                                              CoplanarMergeStats* stats) {
+  std::vector<CoplanarGroup> result;
+  std::vector<FaceInfo> info(faces.size());
+  for (size_t f = 0; f < faces.size(); f++) {
+    const CoplanarFace& face = faces[f];
+    if (face.material < 0 || face.loops.empty()) continue;
+    size_t corners = 0;
+    for (const std::vector<int>& loop : face.loops) corners += loop.size();
+    if (face.texcoords.size() != corners * 2) continue;
+    const PlaneBasis basis(face.normal);
+    info[f].reversed = LoopArea(face.loops[0], basis, positions) < 0.0;
+    info[f].uv_map = SolveTexcoordMap(face, basis, positions);
+  }
+
+  // 정확히 두 face가 서로 반대 방향으로 쓰는 edge로만 이웃을 정함 (세 face 이상이 만나는 edge는 제외)
+  struct EdgeUse {
+    int face;
+    int from;
+  };
+  std::unordered_map<uint64_t, std::vector<EdgeUse>> uses;
+  for (size_t f = 0; f < faces.size(); f++) {
+    if (!info[f].uv_map.valid) continue;
+    for (const std::vector<int>& loop : faces[f].loops) {
+      for (size_t i = 0; i < loop.size(); i++) {
+        int from = loop[i];
+        int to = loop[(i + 1) % loop.size()];
+        if (info[f].reversed) std::swap(from, to);
+        uses[DirectedKey(std::min(from, to), std::max(from, to))].push_back({static_cast<int>(f), from});
+      }
+    }
+  }
+  UnionFind groups(faces.size());
+  for (const auto& entry : uses) {
+    const std::vector<EdgeUse>& u = entry.second;
+    if (u.size() != 2 || u[0].face == u[1].face || u[0].from == u[1].from) continue;
+    const int a = u[0].face;
+    const int b = u[1].face;
+    if (Mergeable(faces[a], info[a], faces[b], info[b], positions)) groups.unite(a, b);
+  }
+
+  std::unordered_map<int, size_t> group_of;
+  std::vector<CoplanarGroup> candidates;
+  for (size_t f = 0; f < faces.size(); f++) {
+    const int root = groups.find(static_cast<int>(f));
+    auto it = group_of.emplace(root, candidates.size()).first;
+    if (it->second == candidates.size()) candidates.emplace_back();
+    candidates[it->second].faces.push_back(static_cast<int>(f));
+  }
+  CoplanarMergeStats local;
+  for (CoplanarGroup& group : candidates) {
+    if (group.faces.size() < 2) continue;
+    if (!MergeGroup(faces, info, positions, &group)) {
+      local.skipped++;
+      continue;
+    }
+    local.groups++;
+    local.faces += group.faces.size();
+    result.push_back(std::move(group));
+  }
+  if (stats) {
+    stats->groups += local.groups;
+    stats->faces += local.faces;
+    stats->skipped += local.skipped;
+  }
+  return result;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// 동일 평면 face 합치기 (--merge-coplanar).
+// CAD에서 가져온 평면은 같은 material의 작은 face 여러 개로 나뉘어 face마다 따로 테셀레이션되므로 삼각형이
+// 필요보다 많아집니다. 여기서는 edge 하나를 공유하고 normal, material 번호, uv 매핑이 같은 이웃 face를 묶고
+// (union-find), 묶음 안에서 양방향으로 쓰인 안쪽 edge를 지워 남은 경계를 다각형 하나(바깥 loop + 구멍)로 이은 뒤
+// ear clipping으로 다시 삼각형화합니다.
+// - 정점을 그대로 쓰므로(Steiner 점 없음, 경계의 일직선 정점도 유지) 이웃 geometry와 T자 틈이 생기지 않고,
+//   경계 정점 V개, 구멍 H개인 다각형은 V + 2H - 2개(이 정점으로 만들 수 있는 최소) 삼각형이 됩니다.
+// - material 번호가 다르거나 음수인 face, uv가 한 affine 매핑으로 이어지지 않는 face는 합치지 않습니다.
+// - 경계가 한 정점에서 맞닿는 등 다각형 하나로 잇지 못하거나 삼각형화에 실패한 묶음은 그대로 둡니다.
+
+#include <cstddef>
+#include <vector>
+
+struct CoplanarFace {
+  double normal[3] = {0.0, 0.0, 1.0};    // 단위 face normal
+  int material = -1;                     // 같은 값끼리만 합침 (앞/뒷면 material 조합). 음수면 합치지 않음
+  std::vector<std::vector<int>> loops;   // 정점 id. 첫 번째가 바깥 loop, 나머지는 구멍
+  std::vector<float> texcoords;          // loops를 이어 붙인 순서로 정점마다 uv 2개
+};
+
+struct CoplanarGroup {
+  std::vector<int> faces;      // 합친 face (CoplanarFace 인덱스, 2개 이상)
+  std::vector<int> triangles;  // 정점 id 3개씩, normal 기준 반시계
+};
+
+struct CoplanarMergeStats {
+  size_t groups = 0;   // 합친 다각형
+  size_t faces = 0;    // 그 다각형에 든 face
+  size_t skipped = 0;  // 다각형 하나로 잇지 못해 그대로 둔 묶음
+};
+
+// positions: 정점 id별 xyz. stats는 누적되며 nullptr 가능.
+std::vector<CoplanarGroup> MergeCoplanarFaces(const std::vector<CoplanarFace>& faces,
+                                              const std::vector<double>& positions,
+                                              CoplanarMergeStats* stats);
@@ -0,0 +1,85 @@
+#include "draco_encoder.h"
+
+#ifdef SKETCHUP_CONVERTER_HAS_DRACO
+#include "draco/compression/encode.h"
+#include "draco/core/encoder_buffer.h"
+#include "draco/mesh/mesh.h"
+#endif
+
+#ifdef SKETCHUP_CONVERTER_HAS_DRACO
+
+namespace {
+
+// identity mapping: glTF 정점 i == Draco point i
+int AddAttribute(draco::Mesh* mesh,
+                 draco::GeometryAttribute::Type type,
+                 const std::vector<float>& values,
+                 int components,
+                 size_t vertex_count) {
+  draco::GeometryAttribute ga;
+  ga.Init(type, nullptr, static_cast<int8_t>(components), draco::DT_FLOAT32, false,
+          sizeof(float) * components, 0);
+  const int id = mesh->AddAttribute(ga, true, static_cast<uint32_t>(vertex_count));
+  draco::PointAttribute* pa = mesh->attribute(id);
+  for (size_t i = 0; i < vertex_count; i++) {
+    pa->SetAttributeValue(draco::AttributeValueIndex(static_cast<uint32_t>(i)), &values[i * components]);
+  }
+  return id;
+}
+
+}  // namespace
+
+bool DracoAvailable() { return true; }
+
+bool EncodeDracoPrimitive(
+    const GltfPrimitive& prim, const DracoOptions& options, DracoPrimitive* out, std::string* error) {
+  const size_t vertex_count = prim.vertex_count();
+  draco::Mesh mesh;
+  mesh.set_num_points(static_cast<uint32_t>(vertex_count));
+  for (size_t t = 0; t + 2 < prim.indices.size(); t += 3) {
+    draco::Mesh::Face face;
+    for (int k = 0; k < 3; k++) face[k] = draco::PointIndex(prim.indices[t + k]);
+    mesh.AddFace(face);
+  }
+
+  out->position_id = AddAttribute(&mesh, draco::GeometryAttribute::POSITION, prim.positions, 3, vertex_count);
+  if (prim.normals.size() == vertex_count * 3) {
+    out->normal_id = AddAttribute(&mesh, draco::GeometryAttribute::NORMAL, prim.normals, 3, vertex_count);
+  }
+  if (prim.texcoords.size() == vertex_count * 2) {
+    out->texcoord_id = AddAttribute(&mesh, draco::GeometryAttribute::TEX_COORD, prim.texcoords, 2, vertex_count);
+  }
+
+  draco::Encoder encoder;
+  encoder.SetAttributeQuantization(draco::GeometryAttribute::POSITION, options.position_bits);
+  encoder.SetAttributeQuantization(draco::GeometryAttribute::NORMAL, options.normal_bits);
+  encoder.SetAttributeQuantization(draco::GeometryAttribute::TEX_COORD, options.texcoord_bits);
+  // gltf-pipeline compressionLevel과 같은 의미: speed = 10 - level
+  const int speed = 10 - options.compression_level;
+  encoder.SetSpeedOptions(speed, speed);
+  encoder.SetEncodingMethod(draco::MESH_EDGEBREAKER_ENCODING);
+  encoder.SetTrackEncodedProperties(true);
+
+  draco::EncoderBuffer buffer;
+  const draco::Status status = encoder.EncodeMeshToBuffer(mesh, &buffer);
+  if (!status.ok()) {
+    if (error) *error = "Draco encode failed: " + status.error_msg_string();
+    return false;
+  }
+  out->data.assign(reinterpret_cast<const uint8_t*>(buffer.data()),
+                   reinterpret_cast<const uint8_t*>(buffer.data()) + buffer.size());
+  out->vertex_count = encoder.num_encoded_points();
+  out->index_count = encoder.num_encoded_faces() * 3;
+  return true;
+}
+
+#else
+
+bool DracoAvailable() { return false; }
+
+bool EncodeDracoPrimitive(const GltfPrimitive&, const DracoOptions&, DracoPrimitive*, std::string* error) {
+  if (error) *error = "built without Draco (install draco and reconfigure CMake)";
+  return false;
+}
+
+#endif
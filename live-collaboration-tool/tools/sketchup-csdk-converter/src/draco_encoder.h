@@ -0,0 +1,36 @@
+#pragma once
+
+// KHR_draco_mesh_compression용 primitive 인코더.
+// Draco 라이브러리와 함께 빌드된 경우(SKETCHUP_CONVERTER_HAS_DRACO)에만 동작합니다.
+// 없으면 DracoAvailable()이 false이고 EncodeDracoPrimitive는 실패를 반환합니다.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gltf_scene.h"
+
+// 기본값은 기존 gltf-pipeline dracoOptions와 같습니다.
+struct DracoOptions {
+  int position_bits = 14;
+  int normal_bits = 10;
+  int texcoord_bits = 12;
+  int compression_level = 7;  // 0(빠름) ~ 10(작음)
+};
+
+struct DracoPrimitive {
+  std::vector<uint8_t> data;
+  // Draco attribute id (KHR_draco_mesh_compression.attributes), 없으면 -1
+  int position_id = -1;
+  int normal_id = -1;
+  int texcoord_id = -1;
+  // 디코딩 후 정점/인덱스 수 (edgebreaker가 정점을 나누거나 순서를 바꿀 수 있어 accessor count로 사용)
+  size_t vertex_count = 0;
+  size_t index_count = 0;
+};
+
+bool DracoAvailable();
+
+// 성공 시 true. 실패하면 error에 원인을 채웁니다.
+bool EncodeDracoPrimitive(
+    const GltfPrimitive& prim, const DracoOptions& options, DracoPrimitive* out, std::string* error);
@@ -0,0 +1,21 @@
+#pragma once
+
+// face 하나를 로컬 좌표로 테셀레이션한 결과.
+// definition 캐시 등에서 인스턴스마다 재사용하므로 float로 작게 보관합니다.
+// position은 face 기준점(origin, double) 대비 값이라 큰 좌표에서도 float 정밀도를 잃지 않습니다.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct FaceMesh {
+  std::string material;           // 출력 material 이름 (MeshSink::usemtl)
+  double origin[3] = {0.0, 0.0, 0.0};
+  std::vector<float> positions;   // origin 기준 xyz
+  std::vector<float> normals;     // xyz (SDK 값 그대로, 변환 후 정규화)
+  std::vector<float> texcoords;   // uv (STQ를 q로 나눈 값, OBJ 기준 좌하단 원점)
+  std::vector<uint32_t> indices;  // 삼각형 목록 (face 안에서 공유된 정점은 공유 유지)
+
+  size_t vertex_count() const { return positions.size() / 3; }
+  size_t triangle_count() const { return indices.size() / 3; }
+};
@@ -0,0 +1,1001 @@
+#include "glb_writer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#include "json_writer.h"
+#include "mesh_quantize.h"
+#include "meshopt_codec.h"
+
+namespace {
+
+constexpr uint32_t kGlbMagic = 0x46546C67;      // "glTF"
+constexpr uint32_t kGlbVersion = 2;
+constexpr uint32_t kChunkJson = 0x4E4F534A;     // "JSON"
+constexpr uint32_t kChunkBin = 0x004E4942;      // "BIN\0"
+
+constexpr int kTargetArrayBuffer = 34962;
+constexpr int kTargetElementArrayBuffer = 34963;
+constexpr int kComponentByte = 5120;
+constexpr int kComponentShort = 5122;
+constexpr int kComponentFloat = 5126;
+constexpr int kComponentUnsignedShort = 5123;
+constexpr int kComponentUnsignedInt = 5125;
+constexpr int kModeTriangles = 4;
+
+struct BufferView {
+  size_t offset = 0;
+  size_t length = 0;
+  int target = 0;
+  size_t stride = 0;     // 요소 크기 (meshopt 인코딩 단위)
+  bool index = false;    // 인덱스 버퍼 (meshopt mode INDICES)
+  // EXT_meshopt_compression 압축본 위치 (GLB BIN 기준)
+  size_t packed_offset = 0;
+  size_t packed_length = 0;
+  // 요소 뒤에 패딩이 있어 byteStride를 항상 기록해야 하는 정점 view (양자화 속성)
+  bool padded = false;
+  // 비어 있지 않으면 meshopt 인코딩 입력으로 data 대신 사용 (filter "OCTAHEDRAL")
+  std::vector<uint8_t> octahedral;
+};
+
+struct Accessor {
+  int buffer_view = -1;
+  int component_type = kComponentFloat;
+  size_t count = 0;
+  const char* type = "SCALAR";
+  bool normalized = false;
+  bool has_bounds = false;
+  float min[3] = {0, 0, 0};
+  float max[3] = {0, 0, 0};
+};
+
+// BIN 청크 + bufferView/accessor 목록을 함께 쌓는 도우미
+struct BinBuilder {
+  std::vector<uint8_t> data;
+  std::vector<BufferView> views;
+  std::vector<Accessor> accessors;
+
+  int add_view(const void* bytes, size_t length, int target, size_t stride) {
+    // glTF는 accessor 정렬을 요구하므로 4바이트 경계에 맞춥니다.
+    while (data.size() % 4 != 0) data.push_back(0);
+    BufferView v;
+    v.offset = data.size();
+    v.length = length;
+    v.target = target;
+    v.stride = stride;
+    v.index = target == kTargetElementArrayBuffer;
+    const uint8_t* p = static_cast<const uint8_t*>(bytes);
+    data.insert(data.end(), p, p + length);
+    views.push_back(v);
+    return static_cast<int>(views.size() - 1);
+  }
+
+  int add_float_accessor(const std::vector<float>& values, int components, const char* type,
+                         bool with_bounds) {
+    Accessor a;
+    a.buffer_view =
+        add_view(values.data(), values.size() * sizeof(float), kTargetArrayBuffer, components * sizeof(float));
+    a.component_type = kComponentFloat;
+    a.count = values.size() / components;
+    a.type = type;
+    if (with_bounds) set_bounds(values, components, &a);
+    accessors.push_back(a);
+    return static_cast<int>(accessors.size() - 1);
+  }
+
+  // KHR_mesh_quantization 정점 속성. values는 요소당 stride 바이트(패딩 포함)
+  template <typename T>
+  int add_quantized_accessor(const std::vector<T>& values, size_t count, int component_type, const char* type,
+                             bool normalized) {
+    Accessor a;
+    const size_t stride = count > 0 ? values.size() * sizeof(T) / count : 0;
+    a.buffer_view = add_view(values.data(), values.size() * sizeof(T), kTargetArrayBuffer, stride);
+    views[a.buffer_view].padded = true;
+    a.component_type = component_type;
+    a.count = count;
+    a.type = type;
+    a.normalized = normalized;
+    accessors.push_back(a);
+    return static_cast<int>(accessors.size() - 1);
+  }
+
+  // 데이터가 압축 확장(KHR_draco_mesh_compression)에 들어 있는 accessor — bufferView 없음
+  int add_compressed_accessor(int component_type, size_t count, const char* type,
+                              const std::vector<float>* bounds_from = nullptr, int components = 0) {
+    Accessor a;
+    a.component_type = component_type;
+    a.count = count;
+    a.type = type;
+    if (bounds_from) set_bounds(*bounds_from, components, &a);
+    accessors.push_back(a);
+    return static_cast<int>(accessors.size() - 1);
+  }
+
+  static void set_bounds(const std::vector<float>& values, int components, Accessor* a) {
+    const size_t count = values.size() / components;
+    if (count == 0) return;
+    a->has_bounds = true;
+    for (int c = 0; c < components; c++) {
+      a->min[c] = FLT_MAX;
+      a->max[c] = -FLT_MAX;
+    }
+    for (size_t i = 0; i < count; i++) {
+      for (int c = 0; c < components; c++) {
+        const float v = values[i * components + c];
+        a->min[c] = std::min(a->min[c], v);
+        a->max[c] = std::max(a->max[c], v);
+      }
+    }
+  }
+
+  // 정점 속성이 아닌 데이터(인스턴스 TRS 등) — bufferView target 없음
+  int add_plain_float_accessor(const std::vector<float>& values, int components, const char* type) {
+    Accessor a;
+    a.buffer_view = add_view(values.data(), values.size() * sizeof(float), 0, components * sizeof(float));
+    a.component_type = kComponentFloat;
+    a.count = values.size() / components;
+    a.type = type;
+    accessors.push_back(a);
+    return static_cast<int>(accessors.size() - 1);
+  }
+
+  // 정점 수가 kMaxShortIndexVertices 이하면 UNSIGNED_SHORT로 줄여 기록합니다.
+  int add_index_accessor(const std::vector<uint32_t>& indices, size_t vertex_count) {
+    Accessor a;
+    if (vertex_count <= kMaxShortIndexVertices) {
+      std::vector<uint16_t> narrow(indices.begin(), indices.end());
+      a.buffer_view = add_view(narrow.data(), narrow.size() * sizeof(uint16_t), kTargetElementArrayBuffer,
+                               sizeof(uint16_t));
+      a.component_type = kComponentUnsignedShort;
+    } else {
+      a.buffer_view = add_view(indices.data(), indices.size() * sizeof(uint32_t), kTargetElementArrayBuffer,
+                               sizeof(uint32_t));
+      a.component_type = kComponentUnsignedInt;
+    }
+    a.count = indices.size();
+    a.type = "SCALAR";
+    accessors.push_back(a);
+    return static_cast<int>(accessors.size() - 1);
+  }
+
+  // 모든 bufferView를 meshopt로 압축해 packed에 이어 붙입니다. (data는 fallback으로 그대로 유지)
+  std::vector<uint8_t> encode_meshopt() {
+    std::vector<uint8_t> packed;
+    for (BufferView& v : views) {
+      const uint8_t* src = v.octahedral.empty() ? data.data() + v.offset : v.octahedral.data();
+      const size_t count = v.length / v.stride;
+      const std::vector<uint8_t> enc = v.index ? EncodeMeshoptIndices(src, count, v.stride)
+                                               : EncodeMeshoptAttributes(src, count, v.stride);
+      while (packed.size() % 4 != 0) packed.push_back(0);
+      v.packed_offset = packed.size();
+      v.packed_length = enc.size();
+      packed.insert(packed.end(), enc.begin(), enc.end());
+    }
+    while (packed.size() % 4 != 0) packed.push_back(0);
+    return packed;
+  }
+};
+
+struct InstanceRefs {
+  int translation = -1;
+  int rotation = -1;
+  int scale = -1;
+};
+
+struct PrimitiveRefs {
+  int position = -1;
+  int normal = -1;
+  int texcoord = -1;
+  int indices = -1;
+  int material = -1;
+  // KHR_draco_mesh_compression (draco_view < 0이면 압축 안 함)
+  int draco_view = -1;
+  int draco_position = -1;
+  int draco_normal = -1;
+  int draco_texcoord = -1;
+};
+
+// 양자화된 position을 원래 좌표로 되돌리는 변환 D = T(offset) * S(scale)를 node에 합칩니다.
+// - 인스턴싱 node: 인스턴스 TRS * D (균일 스케일이라 다시 TRS로 표현 가능)
+// - 자식이 있는 node: D는 자식에게 전파되면 안 되므로 mesh를 새 자식 node로 옮김
+// - 그 외: node.matrix * D
+void ApplyPositionDequantization(
+    const std::vector<PositionQuantization>& mesh_quant, std::vector<GltfNode>* nodes) {
+  const size_t original = nodes->size();
+  for (size_t i = 0; i < original; i++) {
+    if ((*nodes)[i].mesh < 0) continue;
+    const PositionQuantization& q = mesh_quant[(*nodes)[i].mesh];
+    if (!(*nodes)[i].instances.empty()) {
+      for (GltfInstance& inst : (*nodes)[i].instances) {
+        // t' = t + R * (S * offset), s' = S * scale
+        const double v[3] = {inst.scale[0] * q.offset[0], inst.scale[1] * q.offset[1], inst.scale[2] * q.offset[2]};
+        const double x = inst.rotation[0], y = inst.rotation[1], z = inst.rotation[2], w = inst.rotation[3];
+        const double c1[3] = {y * v[2] - z * v[1] + w * v[0], z * v[0] - x * v[2] + w * v[1],
+                              x * v[1] - y * v[0] + w * v[2]};
+        const double r[3] = {v[0] + 2.0 * (y * c1[2] - z * c1[1]), v[1] + 2.0 * (z * c1[0] - x * c1[2]),
+                             v[2] + 2.0 * (x * c1[1] - y * c1[0])};
+        for (int k = 0; k < 3; k++) {
+          inst.translation[k] = static_cast<float>(inst.translation[k] + r[k]);
+          inst.scale[k] = static_cast<float>(inst.scale[k] * q.scale);
+        }
+      }
+      continue;
+    }
+    GltfNode* target = &(*nodes)[i];
+    if (!target->children.empty()) {
+      GltfNode child;
+      child.name = target->name.empty() ? std::string() : target->name + "_mesh";
+      child.mesh = target->mesh;
+      target->mesh = -1;
+      target->children.push_back(static_cast<int>(nodes->size()));
+      nodes->push_back(child);
+      target = &nodes->back();
+    }
+    double d[16] = {q.scale, 0, 0, 0, 0, q.scale, 0, 0, 0, 0, q.scale, 0, q.offset[0], q.offset[1], q.offset[2], 1};
+    double out[16];
+    for (int col = 0; col < 4; col++) {
+      for (int row = 0; row < 4; row++) {
+        double sum = 0.0;
+        for (int k = 0; k < 4; k++) sum += target->matrix[k * 4 + row] * d[col * 4 + k];
+        out[col * 4 + row] = sum;
+      }
+    }
+    std::copy(out, out + 16, target->matrix);
+    target->has_matrix = true;
+  }
+}
+
+// GLB에 넣은 image 파일 하나 (offset은 BIN 청크 기준)
+struct EmbeddedImage {
+  size_t offset = 0;
+  size_t length = 0;
+};
+
+// embed_images: geometry 뒤에 image 파일을 이어 붙입니다. 부분 다운로드에서도 geometry가 먼저 도착합니다.
+// image_view[uri]는 embedded 인덱스. 같은 uri(중복 제거된 텍스처를 공유하는 image)는 한 번만 넣습니다.
+bool EmbedImageFiles(const GltfScene& scene, const std::filesystem::path& base_dir, size_t bin_offset,
+                     std::vector<uint8_t>* data, std::vector<EmbeddedImage>* embedded,
+                     std::unordered_map<std::string, int>* image_view, std::string* error) {
+  auto embed = [&](const std::string& uri) {
+    if (uri.empty() || image_view->count(uri)) return true;
+    const std::filesystem::path file = base_dir / uri;
+    std::ifstream f(file, std::ios::in | std::ios::binary);
+    if (!f.good()) {
+      if (error) *error = "failed to read image " + file.string();
+      return false;
+    }
+    EmbeddedImage e;
+    e.offset = bin_offset + data->size();
+    data->insert(data->end(), std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    e.length = bin_offset + data->size() - e.offset;
+    while (data->size() % 4 != 0) data->push_back(0);
+    (*image_view)[uri] = static_cast<int>(embedded->size());
+    embedded->push_back(e);
+    return true;
+  };
+  // 원래 image(확장 미지원 클라이언트가 읽는 것)를 먼저, KTX2는 뒤에
+  for (const GltfImage& img : scene.images) {
+    if (!embed(img.uri)) return false;
+  }
+  for (const GltfImage& img : scene.images) {
+    if (!embed(img.basisu_uri)) return false;
+  }
+  return true;
+}
+
+// 루트 extras 안에 rtcCenter (--rtc로 뺀 원점, double 그대로)
+void WriteOrigin(const GltfScene& scene, JsonWriter* j) {
+  j->key("rtcCenter");
+  j->begin_array();
+  for (double v : scene.origin) j->precise_value(v);
+  j->end_array();
+}
+
+void WriteU32(std::ofstream& f, uint32_t v) {
+  // GLB는 little-endian. (macOS arm64/x86_64, Linux x86_64 모두 little-endian)
+  f.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+}  // namespace
+
+bool WriteGlb(const GltfScene& scene,
+              const std::filesystem::path& path,
+              const GlbWriteOptions& options,
+              GlbWriteStats* stats,
+              std::string* error) {
+  if (options.meshopt_compression && options.draco_compression) {
+    if (error) *error = "meshopt and Draco compression are mutually exclusive";
+    return false;
+  }
+  if (options.quantize && options.draco_compression) {
+    if (error) *error = "quantization and Draco compression are mutually exclusive (Draco quantizes itself)";
+    return false;
+  }
+  BinBuilder bin;
+  const bool draco = options.draco_compression;
+  const bool quantize = options.quantize;
+  std::vector<GltfNode> nodes = scene.nodes;
+
+  // 양자화 기준: position은 mesh별, uv는 텍스처 material별 최대 |uv|
+  std::vector<PositionQuantization> mesh_quant;
+  std::vector<double> texcoord_range(scene.materials.size(), 0.0);
+  if (quantize) {
+    mesh_quant.reserve(scene.meshes.size());
+    for (const GltfMesh& mesh : scene.meshes) {
+      mesh_quant.push_back(ComputePositionQuantization(mesh));
+      for (const GltfPrimitive& prim : mesh.primitives) {
+        if (prim.material < 0 || prim.material >= static_cast<int>(scene.materials.size())) continue;
+        double& range = texcoord_range[prim.material];
+        for (float uv : prim.texcoords) range = std::max(range, static_cast<double>(std::fabs(uv)));
+      }
+    }
+    for (double& range : texcoord_range) {
+      if (range == 0.0) range = 1.0;
+    }
+    ApplyPositionDequantization(mesh_quant, &nodes);
+  }
+  size_t draco_raw_bytes = 0;
+  const auto draco_t0 = std::chrono::steady_clock::now();
+
+  // mesh별 primitive accessor 구성 (빈 primitive는 생략)
+  // primitive가 하나도 없는 mesh는 glTF에서 허용되지 않으므로 출력 인덱스를 다시 매깁니다.
+  std::vector<std::vector<PrimitiveRefs>> mesh_refs(scene.meshes.size());
+  std::vector<int> mesh_out_index(scene.meshes.size(), -1);
+  int mesh_out_count = 0;
+  // proxy mesh를 먼저 써서 BIN 앞부분만 받아도 proxy scene을 그릴 수 있게 합니다.
+  std::vector<bool> proxy_mesh(scene.meshes.size(), false);
+  for (int r : scene.proxy_roots) {
+    if (scene.nodes[r].mesh >= 0) proxy_mesh[scene.nodes[r].mesh] = true;
+  }
+  std::vector<size_t> mesh_order;
+  for (size_t m = 0; m < scene.meshes.size(); m++) {
+    if (proxy_mesh[m]) mesh_order.push_back(m);
+  }
+  for (size_t m = 0; m < scene.meshes.size(); m++) {
+    if (!proxy_mesh[m]) mesh_order.push_back(m);
+  }
+  size_t proxy_views = 0;  // 앞에서부터 proxy mesh의 bufferView 수
+  for (size_t m : mesh_order) {
+    for (const GltfPrimitive& prim : scene.meshes[m].primitives) {
+      if (prim.indices.empty() || prim.positions.empty()) continue;
+      PrimitiveRefs refs;
+      refs.material = prim.material;
+      if (draco) {
+        DracoPrimitive dp;
+        if (!EncodeDracoPrimitive(prim, options.draco, &dp, error)) return false;
+        draco_raw_bytes += (prim.positions.size() + prim.normals.size() + prim.texcoords.size()) * sizeof(float) +
+                           prim.indices.size() * (prim.vertex_count() <= kMaxShortIndexVertices ? 2 : 4);
+        refs.draco_view = bin.add_view(dp.data.data(), dp.data.size(), 0, 0);
+        refs.draco_position = dp.position_id;
+        refs.draco_normal = dp.normal_id;
+        refs.draco_texcoord = dp.texcoord_id;
+        refs.position = bin.add_compressed_accessor(kComponentFloat, dp.vertex_count, "VEC3", &prim.positions, 3);
+        if (dp.normal_id >= 0) refs.normal = bin.add_compressed_accessor(kComponentFloat, dp.vertex_count, "VEC3");
+        if (dp.texcoord_id >= 0) {
+          refs.texcoord = bin.add_compressed_accessor(kComponentFloat, dp.vertex_count, "VEC2");
+        }
+        refs.indices = bin.add_compressed_accessor(
+            dp.vertex_count <= kMaxShortIndexVertices ? kComponentUnsignedShort : kComponentUnsignedInt,
+            dp.index_count, "SCALAR");
+        mesh_refs[m].push_back(refs);
+        continue;
+      }
+      if (quantize) {
+        const size_t count = prim.vertex_count();
+        std::vector<int16_t> pos;
+        const double pos_error = QuantizePositions(prim.positions, mesh_quant[m], &pos);
+        refs.position = bin.add_quantized_accessor(pos, count, kComponentShort, "VEC3", false);
+        Accessor& pa = bin.accessors[refs.position];
+        pa.has_bounds = true;
+        for (int c = 0; c < 3; c++) {
+          pa.min[c] = FLT_MAX;
+          pa.max[c] = -FLT_MAX;
+        }
+        for (size_t i = 0; i < count; i++) {
+          for (int c = 0; c < 3; c++) {
+            pa.min[c] = std::min(pa.min[c], static_cast<float>(pos[i * 4 + c]));
+            pa.max[c] = std::max(pa.max[c], static_cast<float>(pos[i * 4 + c]));
+          }
+        }
+        size_t float_bytes = prim.positions.size() * sizeof(float);
+        size_t quantized_bytes = pos.size() * sizeof(int16_t);
+        double normal_error = 0.0;
+        if (prim.normals.size() == prim.positions.size()) {
+          std::vector<int8_t> nrm;
+          normal_error = QuantizeNormals(prim.normals, &nrm);
+          refs.normal = bin.add_quantized_accessor(nrm, count, kComponentByte, "VEC3", true);
+          if (options.meshopt_compression) {
+            // 압축본에는 octahedral(u, v)만 넣고 디코더 필터로 xyz를 복원합니다. fallback은 xyz 그대로
+            std::vector<int8_t> oct;
+            normal_error = EncodeOctahedralNormals(prim.normals, &oct);
+            BufferView& nv = bin.views[bin.accessors[refs.normal].buffer_view];
+            nv.octahedral.assign(reinterpret_cast<const uint8_t*>(oct.data()),
+                                 reinterpret_cast<const uint8_t*>(oct.data()) + oct.size());
+          }
+          float_bytes += prim.normals.size() * sizeof(float);
+          quantized_bytes += nrm.size();
+        }
+        double texcoord_error = 0.0;
+        const bool textured = prim.material >= 0 && prim.material < static_cast<int>(scene.materials.size()) &&
+                              scene.materials[prim.material].image >= 0;
+        if (textured && prim.texcoords.size() / 2 == count) {
+          std::vector<int16_t> uv;
+          texcoord_error = QuantizeTexcoords(prim.texcoords, texcoord_range[prim.material], &uv);
+          refs.texcoord = bin.add_quantized_accessor(uv, count, kComponentShort, "VEC2", true);
+          quantized_bytes += uv.size() * sizeof(int16_t);
+        }
+        // 텍스처 없는 material의 uv는 렌더링에 쓰이지 않으므로 생략
+        float_bytes += prim.texcoords.size() * sizeof(float);
+        refs.indices = bin.add_index_accessor(prim.indices, prim.vertex_count());
+        mesh_refs[m].push_back(refs);
+        if (stats) {
+          stats->float_vertex_bytes += float_bytes;
+          stats->quantized_vertex_bytes += quantized_bytes;
+          stats->position_error = std::max(stats->position_error, pos_error);
+          stats->normal_error_degrees = std::max(stats->normal_error_degrees, normal_error);
+          stats->texcoord_error = std::max(stats->texcoord_error, texcoord_error);
+        }
+        continue;
+      }
+      refs.position = bin.add_float_accessor(prim.positions, 3, "VEC3", true);
+      if (prim.normals.size() == prim.positions.size()) {
+        refs.normal = bin.add_float_accessor(prim.normals, 3, "VEC3", false);
+      }
+      if (prim.texcoords.size() / 2 == prim.vertex_count()) {
+        refs.texcoord = bin.add_float_accessor(prim.texcoords, 2, "VEC2", false);
+      }
+      refs.indices = bin.add_index_accessor(prim.indices, prim.vertex_count());
+      mesh_refs[m].push_back(refs);
+    }
+    if (!mesh_refs[m].empty()) mesh_out_index[m] = mesh_out_count++;
+    if (proxy_mesh[m]) proxy_views = bin.views.size();
+  }
+  if (draco && stats) {
+    stats->geometry_bytes = draco_raw_bytes;
+    stats->compressed_bytes = bin.data.size();
+    stats->encode_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - draco_t0).count();
+  }
+
+  // 인스턴싱 node의 TRS accessor
+  std::vector<InstanceRefs> instance_refs(nodes.size());
+  bool uses_instancing = false;
+  for (size_t n = 0; n < nodes.size(); n++) {
+    const GltfNode& node = nodes[n];
+    if (node.instances.empty() || node.mesh < 0 || mesh_out_index[node.mesh] < 0) continue;
+    std::vector<float> t, r, sc;
+    t.reserve(node.instances.size() * 3);
+    r.reserve(node.instances.size() * 4);
+    sc.reserve(node.instances.size() * 3);
+    for (const GltfInstance& inst : node.instances) {
+      t.insert(t.end(), inst.translation, inst.translation + 3);
+      r.insert(r.end(), inst.rotation, inst.rotation + 4);
+      sc.insert(sc.end(), inst.scale, inst.scale + 3);
+    }
+    instance_refs[n].translation = bin.add_plain_float_accessor(t, 3, "VEC3");
+    instance_refs[n].rotation = bin.add_plain_float_accessor(r, 4, "VEC4");
+    instance_refs[n].scale = bin.add_plain_float_accessor(sc, 3, "VEC3");
+    uses_instancing = true;
+  }
+  while (bin.data.size() % 4 != 0) bin.data.push_back(0);
+
+  // meshopt: GLB BIN(buffer 0)에는 압축본, 원본은 외부 fallback 버퍼(buffer 1)
+  const bool meshopt = options.meshopt_compression && !bin.data.empty();
+  std::vector<uint8_t> packed;
+  std::filesystem::path fallback_path;
+  if (meshopt) {
+    const auto t0 = std::chrono::steady_clock::now();
+    packed = bin.encode_meshopt();
+    const auto t1 = std::chrono::steady_clock::now();
+    fallback_path = path.parent_path() / (path.stem().string() + ".fallback.bin");
+    if (stats) {
+      stats->compressed_bytes = packed.size();
+      stats->encode_seconds = std::chrono::duration<double>(t1 - t0).count();
+      stats->fallback_path = fallback_path;
+    }
+  }
+  if (stats && !draco) stats->geometry_bytes = bin.data.size();
+  const std::vector<uint8_t>& glb_bin = meshopt ? packed : bin.data;
+  size_t proxy_bin_end = 0;  // GLB BIN 기준 proxy geometry 끝
+  for (size_t v = 0; v < proxy_views; v++) {
+    const BufferView& view = bin.views[v];
+    const size_t end = meshopt ? view.packed_offset + view.packed_length : view.offset + view.length;
+    proxy_bin_end = std::max(proxy_bin_end, end);
+  }
+
+  // embed_images: image 파일은 BIN 청크에서 geometry(압축본) 뒤에 놓이고 항상 buffer 0을 가리킵니다.
+  std::vector<uint8_t> image_data;
+  std::vector<EmbeddedImage> embedded;
+  std::unordered_map<std::string, int> image_view;
+  if (options.embed_images && !EmbedImageFiles(scene, path.parent_path(), glb_bin.size(), &image_data, &embedded,
+                                               &image_view, error)) {
+    return false;
+  }
+  if (stats) {
+    stats->embedded_images = embedded.size();
+    stats->embedded_image_bytes = image_data.size();
+  }
+  const size_t bin_size = glb_bin.size() + image_data.size();
+  // embedded image의 bufferView 인덱스 (geometry view 뒤)
+  auto image_ref = [&](const std::string& uri, JsonWriter& j) {
+    auto it = image_view.find(uri);
+    if (it == image_view.end()) {
+      j.field("uri", uri);
+    } else {
+      j.field("bufferView", bin.views.size() + it->second);
+    }
+  };
+
+  std::vector<const char*> extensions_used;
+  std::vector<const char*> extensions_required;
+  if (uses_instancing) {
+    // 인스턴싱을 무시하면 인스턴스 하나만 그려지므로 필수 확장으로 표시
+    extensions_used.push_back("EXT_mesh_gpu_instancing");
+    extensions_required.push_back("EXT_mesh_gpu_instancing");
+  }
+  if (meshopt) {
+    // fallback 버퍼가 있으므로 필수는 아님
+    extensions_used.push_back("EXT_meshopt_compression");
+  }
+  // 텍스처를 쓰는 양자화 uv가 있으면 material에 KHR_texture_transform scale을 붙입니다.
+  bool uses_texture_transform = false;
+  std::vector<bool> material_transform(scene.materials.size(), false);
+  if (quantize) {
+    for (size_t m = 0; m < scene.meshes.size(); m++) {
+      for (const PrimitiveRefs& p : mesh_refs[m]) {
+        if (p.texcoord >= 0 && p.material >= 0) {
+          material_transform[p.material] = true;
+          uses_texture_transform = true;
+        }
+      }
+    }
+  }
+  if (quantize && mesh_out_count > 0) {
+    // 양자화 속성을 float로 읽으면 모델이 깨지므로 필수
+    extensions_used.push_back("KHR_mesh_quantization");
+    extensions_required.push_back("KHR_mesh_quantization");
+    if (uses_texture_transform) {
+      extensions_used.push_back("KHR_texture_transform");
+      extensions_required.push_back("KHR_texture_transform");
+    }
+  }
+  bool uses_basisu = false;
+  for (const GltfImage& img : scene.images) uses_basisu = uses_basisu || !img.basisu_uri.empty();
+  if (uses_basisu) {
+    // PNG/JPEG source가 fallback으로 남아 있으므로 필수는 아님
+    extensions_used.push_back("KHR_texture_basisu");
+  }
+  bool uses_lod = false;
+  for (const GltfNode& n : nodes) uses_lod = uses_lod || !n.lods.empty();
+  if (uses_lod) {
+    // 가장 자세한 LOD가 원래 node에 있으므로 필수는 아님
+    extensions_used.push_back("MSFT_lod");
+  }
+  if (draco && mesh_out_count > 0) {
+    // 압축되지 않은 정점 데이터가 없으므로 필수
+    extensions_used.push_back("KHR_draco_mesh_compression");
+    extensions_required.push_back("KHR_draco_mesh_compression");
+  }
+
+  JsonWriter j;
+  j.begin_object();
+
+  j.key("asset");
+  j.begin_object();
+  j.field("version", "2.0");
+  j.field("generator", "sketchup-csdk-converter");
+  j.end_object();
+
+  if (!extensions_used.empty()) {
+    j.key("extensionsUsed");
+    j.begin_array();
+    for (const char* e : extensions_used) j.value(e);
+    j.end_array();
+  }
+  if (!extensions_required.empty()) {
+    j.key("extensionsRequired");
+    j.begin_array();
+    for (const char* e : extensions_required) j.value(e);
+    j.end_array();
+  }
+
+  j.field("scene", 0);
+  j.key("scenes");
+  j.begin_array();
+  j.begin_object();
+  j.key("nodes");
+  j.begin_array();
+  for (int r : scene.roots) j.value(r);
+  j.end_array();
+  j.end_object();
+  if (!scene.proxy_roots.empty()) {
+    j.begin_object();
+    j.field("name", "proxy");
+    j.key("nodes");
+    j.begin_array();
+    for (int r : scene.proxy_roots) j.value(r);
+    j.end_array();
+    j.end_object();
+  }
+  j.end_array();
+
+  if (!nodes.empty()) {
+    j.key("nodes");
+    j.begin_array();
+    for (size_t i = 0; i < nodes.size(); i++) {
+      const GltfNode& n = nodes[i];
+      j.begin_object();
+      if (!n.name.empty()) j.field("name", n.name);
+      if (n.mesh >= 0 && mesh_out_index[n.mesh] >= 0) j.field("mesh", mesh_out_index[n.mesh]);
+      if (n.has_matrix) {
+        j.key("matrix");
+        j.begin_array();
+        for (double v : n.matrix) j.value(v);
+        j.end_array();
+      }
+      if (!n.children.empty()) {
+        j.key("children");
+        j.begin_array();
+        for (int c : n.children) j.value(c);
+        j.end_array();
+      }
+      if (instance_refs[i].translation >= 0 || !n.lods.empty()) {
+        j.key("extensions");
+        j.begin_object();
+        if (instance_refs[i].translation >= 0) {
+          j.key("EXT_mesh_gpu_instancing");
+          j.begin_object();
+          j.key("attributes");
+          j.begin_object();
+          j.field("TRANSLATION", instance_refs[i].translation);
+          j.field("ROTATION", instance_refs[i].rotation);
+          j.field("SCALE", instance_refs[i].scale);
+          j.end_object();
+          j.end_object();
+        }
+        if (!n.lods.empty()) {
+          j.key("MSFT_lod");
+          j.begin_object();
+          j.key("ids");
+          j.begin_array();
+          for (int id : n.lods) j.value(id);
+          j.end_array();
+          j.end_object();
+        }
+        j.end_object();
+      }
+      if (!n.lod_coverage.empty() || n.bounds.valid) {
+        j.key("extras");
+        j.begin_object();
+        if (!n.lod_coverage.empty()) {
+          j.key("MSFT_screencoverage");
+          j.begin_array();
+          for (double c : n.lod_coverage) j.value(c);
+          j.end_array();
+        }
+        if (n.bounds.valid) {
+          // 부모 좌표 기준 culling 볼륨 (matrix를 적용한 뒤라 quantize 합성에도 그대로)
+          j.key("bounds");
+          j.begin_object();
+          j.key("min");
+          j.begin_array();
+          for (double v : n.bounds.min) j.value(v);
+          j.end_array();
+          j.key("max");
+          j.begin_array();
+          for (double v : n.bounds.max) j.value(v);
+          j.end_array();
+          j.key("sphere");
+          j.begin_array();
+          for (double v : n.bounds.sphere) j.value(v);
+          j.end_array();
+          j.end_object();
+        }
+        j.end_object();
+      }
+      j.end_object();
+    }
+    j.end_array();
+  }
+
+  if (mesh_out_count > 0) {
+    j.key("meshes");
+    j.begin_array();
+    for (size_t m : mesh_order) {
+      if (mesh_out_index[m] < 0) continue;
+      j.begin_object();
+      if (!scene.meshes[m].name.empty()) j.field("name", scene.meshes[m].name);
+      j.key("primitives");
+      j.begin_array();
+      for (const PrimitiveRefs& p : mesh_refs[m]) {
+        j.begin_object();
+        j.key("attributes");
+        j.begin_object();
+        j.field("POSITION", p.position);
+        if (p.normal >= 0) j.field("NORMAL", p.normal);
+        if (p.texcoord >= 0) j.field("TEXCOORD_0", p.texcoord);
+        j.end_object();
+        j.field("indices", p.indices);
+        if (p.material >= 0) j.field("material", p.material);
+        j.field("mode", kModeTriangles);
+        if (p.draco_view >= 0) {
+          j.key("extensions");
+          j.begin_object();
+          j.key("KHR_draco_mesh_compression");
+          j.begin_object();
+          j.field("bufferView", p.draco_view);
+          j.key("attributes");
+          j.begin_object();
+          j.field("POSITION", p.draco_position);
+          if (p.draco_normal >= 0) j.field("NORMAL", p.draco_normal);
+          if (p.draco_texcoord >= 0) j.field("TEXCOORD_0", p.draco_texcoord);
+          j.end_object();
+          j.end_object();
+          j.end_object();
+        }
+        j.end_object();
+      }
+      j.end_array();
+      j.end_object();
+    }
+    j.end_array();
+  }
+
+  if (!scene.materials.empty()) {
+    j.key("materials");
+    j.begin_array();
+    for (size_t mi = 0; mi < scene.materials.size(); mi++) {
+      const GltfMaterial& mat = scene.materials[mi];
+      j.begin_object();
+      if (!mat.name.empty()) j.field("name", mat.name);
+      j.key("pbrMetallicRoughness");
+      j.begin_object();
+      j.key("baseColorFactor");
+      j.begin_array();
+      for (float c : mat.base_color) j.value(static_cast<double>(c));
+      j.end_array();
+      if (mat.image >= 0) {
+        j.key("baseColorTexture");
+        j.begin_object();
+        j.field("index", mat.image);  // texture i == image i
+        if (material_transform[mi]) {
+          // 정규화 int16 uv([-1, 1])를 원래 범위로 복원
+          j.key("extensions");
+          j.begin_object();
+          j.key("KHR_texture_transform");
+          j.begin_object();
+          j.key("scale");
+          j.begin_array();
+          j.value(texcoord_range[mi]);
+          j.value(texcoord_range[mi]);
+          j.end_array();
+          j.end_object();
+          j.end_object();
+        }
+        j.end_object();
+      }
+      j.field("metallicFactor", 0.0);
+      j.field("roughnessFactor", 1.0);
+      j.end_object();
+      // SketchUp face는 양면이 보이는 것이 기본
+      j.field("doubleSided", true);
+      j.end_object();
+    }
+    j.end_array();
+  }
+
+  if (!scene.images.empty()) {
+    j.key("samplers");
+    j.begin_array();
+    j.begin_object();
+    j.field("wrapS", 10497);  // REPEAT (SketchUp 텍스처는 타일링됨)
+    j.field("wrapT", 10497);
+    j.end_object();
+    j.end_array();
+
+    // KTX2 image는 원래 image들 뒤에 이어 붙입니다. (texture i == image i 유지)
+    j.key("textures");
+    j.begin_array();
+    size_t basisu_image = scene.images.size();
+    for (size_t i = 0; i < scene.images.size(); i++) {
+      j.begin_object();
+      j.field("sampler", 0);
+      j.field("source", i);
+      if (!scene.images[i].basisu_uri.empty()) {
+        j.key("extensions");
+        j.begin_object();
+        j.key("KHR_texture_basisu");
+        j.begin_object();
+        j.field("source", basisu_image++);
+        j.end_object();
+        j.end_object();
+      }
+      j.end_object();
+    }
+    j.end_array();
+
+    j.key("images");
+    j.begin_array();
+    for (const GltfImage& img : scene.images) {
+      j.begin_object();
+      image_ref(img.uri, j);
+      if (!img.mime_type.empty()) j.field("mimeType", img.mime_type);
+      j.end_object();
+    }
+    for (const GltfImage& img : scene.images) {
+      if (img.basisu_uri.empty()) continue;
+      j.begin_object();
+      image_ref(img.basisu_uri, j);
+      j.field("mimeType", "image/ktx2");
+      j.end_object();
+    }
+    j.end_array();
+  }
+
+  if (bin_size > 0) {
+    j.key("buffers");
+    j.begin_array();
+    j.begin_object();
+    j.field("byteLength", bin_size);
+    j.end_object();
+    if (meshopt) {
+      j.begin_object();
+      j.field("uri", fallback_path.filename().string());
+      j.field("byteLength", bin.data.size());
+      j.key("extensions");
+      j.begin_object();
+      j.key("EXT_meshopt_compression");
+      j.begin_object();
+      j.field("fallback", true);
+      j.end_object();
+      j.end_object();
+      j.end_object();
+    }
+    j.end_array();
+
+    j.key("bufferViews");
+    j.begin_array();
+    for (const BufferView& v : bin.views) {
+      j.begin_object();
+      j.field("buffer", meshopt ? 1 : 0);
+      j.field("byteOffset", v.offset);
+      j.field("byteLength", v.length);
+      // byteStride는 정점 속성 view에만 허용 (인스턴스 TRS view는 target이 없음). 압축본 stride는 확장 쪽에
+      if ((meshopt || v.padded) && v.target == kTargetArrayBuffer) j.field("byteStride", v.stride);
+      if (v.target != 0) j.field("target", v.target);
+      if (meshopt) {
+        j.key("extensions");
+        j.begin_object();
+        j.key("EXT_meshopt_compression");
+        j.begin_object();
+        j.field("buffer", 0);
+        j.field("byteOffset", v.packed_offset);
+        j.field("byteLength", v.packed_length);
+        j.field("byteStride", v.stride);
+        j.field("count", v.length / v.stride);
+        j.field("mode", v.index ? "INDICES" : "ATTRIBUTES");
+        if (!v.octahedral.empty()) j.field("filter", "OCTAHEDRAL");
+        j.end_object();
+        j.end_object();
+      }
+      j.end_object();
+    }
+    for (const EmbeddedImage& e : embedded) {
+      j.begin_object();
+      j.field("buffer", 0);
+      j.field("byteOffset", e.offset);
+      j.field("byteLength", e.length);
+      j.end_object();
+    }
+    j.end_array();
+  }
+
+  if (!bin.accessors.empty()) {
+    j.key("accessors");
+    j.begin_array();
+    for (const Accessor& a : bin.accessors) {
+      j.begin_object();
+      if (a.buffer_view >= 0) j.field("bufferView", a.buffer_view);
+      j.field("componentType", a.component_type);
+      if (a.normalized) j.field("normalized", true);
+      j.field("count", a.count);
+      j.field("type", a.type);
+      if (a.has_bounds) {
+        j.key("min");
+        j.begin_array();
+        for (float v : a.min) j.value(static_cast<double>(v));
+        j.end_array();
+        j.key("max");
+        j.begin_array();
+        for (float v : a.max) j.value(static_cast<double>(v));
+        j.end_array();
+      }
+      j.end_object();
+    }
+    j.end_array();
+  }
+
+  const bool has_bin = bin_size > 0;
+  std::string json;
+  if (proxy_views > 0) {
+    // 범위 요청용 색인 (파일 기준 바이트 오프셋): 헤더 + JSON + proxy까지 받으면 proxy scene을 그릴 수 있음.
+    // 오프셋이 JSON 길이에 달려 있으므로 길이가 더 변하지 않을 때까지 다시 씁니다.
+    std::string head = j.str();  // 닫는 '}' 전
+    size_t json_length = head.size();
+    for (;;) {
+      const size_t bin_start = 12 + 8 + json_length + 8;
+      JsonWriter index;
+      index.begin_object();
+      if (scene.has_origin) WriteOrigin(scene, &index);
+      index.key("progressive");
+      index.begin_object();
+      index.field("proxyScene", 1);
+      index.field("proxyEnd", bin_start + proxy_bin_end);
+      index.field("geometryEnd", bin_start + glb_bin.size());
+      index.field("byteLength", bin_start + bin_size);
+      index.end_object();
+      index.end_object();
+      json = head + ",\"extras\":" + index.str() + "}";
+      while (json.size() % 4 != 0) json.push_back(' ');
+      if (json.size() == json_length) break;
+      json_length = json.size();
+    }
+    if (stats) stats->proxy_end = 12 + 8 + json.size() + 8 + proxy_bin_end;
+  } else {
+    if (scene.has_origin) {
+      j.key("extras");
+      j.begin_object();
+      WriteOrigin(scene, &j);
+      j.end_object();
+    }
+    j.end_object();
+    json = j.str();
+    while (json.size() % 4 != 0) json.push_back(' ');
+  }
+
+  const uint64_t total = 12 + 8 + json.size() + (has_bin ? 8 + static_cast<uint64_t>(bin_size) : 0);
+  if (stats) stats->file_bytes = static_cast<size_t>(total);
+  if (total > UINT32_MAX) {
+    if (error) *error = "GLB exceeds 4GB limit";
+    return false;
+  }
+
+  if (meshopt) {
+    std::ofstream fb(fallback_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    fb.write(reinterpret_cast<const char*>(bin.data.data()), static_cast<std::streamsize>(bin.data.size()));
+    if (!fb.good()) {
+      if (error) *error = "failed to write " + fallback_path.string();
+      return false;
+    }
+  }
+
+  std::ofstream f(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!f.good()) {
+    if (error) *error = "failed to open " + path.string();
+    return false;
+  }
+  WriteU32(f, kGlbMagic);
+  WriteU32(f, kGlbVersion);
+  WriteU32(f, static_cast<uint32_t>(total));
+  WriteU32(f, static_cast<uint32_t>(json.size()));
+  WriteU32(f, kChunkJson);
+  f.write(json.data(), static_cast<std::streamsize>(json.size()));
+  if (has_bin) {
+    WriteU32(f, static_cast<uint32_t>(bin_size));
+    WriteU32(f, kChunkBin);
+    f.write(reinterpret_cast<const char*>(glb_bin.data()), static_cast<std::streamsize>(glb_bin.size()));
+    f.write(reinterpret_cast<const char*>(image_data.data()), static_cast<std::streamsize>(image_data.size()));
+  }
+  if (!f.good()) {
+    if (error) *error = "failed to write " + path.string();
+    return false;
+  }
+  return true;
+}
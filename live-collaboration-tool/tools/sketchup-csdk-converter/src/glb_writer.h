@@ -0,0 +1,54 @@
+#pragma once
+
+// GltfScene → 바이너리 glTF(.glb) 직렬화.
+
+#include <filesystem>
+#include <string>
+
+#include "draco_encoder.h"
+#include "gltf_scene.h"
+
+struct GlbWriteOptions {
+  // EXT_meshopt_compression: 정점/인덱스 bufferView를 압축해 GLB BIN에 넣고,
+  // 원본은 확장 미지원 클라이언트용 fallback 버퍼(<stem>.fallback.bin, 외부 파일)로 기록
+  bool meshopt_compression = false;
+  // KHR_draco_mesh_compression: primitive 정점/인덱스를 Draco로 압축 (DracoAvailable()일 때만)
+  bool draco_compression = false;
+  DracoOptions draco;
+  // KHR_mesh_quantization: position int16 (mesh 바운딩 박스 기준, node 변환으로 복원),
+  // normal int8, 텍스처 material의 uv int16 (KHR_texture_transform scale로 복원)
+  bool quantize = false;
+  // image(PNG/JPEG/KTX2) 파일을 읽어 GLB BIN의 geometry 뒤에 bufferView로 넣고 uri 대신 bufferView로 참조.
+  // 같은 uri는 한 번만 넣습니다. 파일은 GLB 기준 상대 경로(GltfImage::uri)로 찾습니다.
+  bool embed_images = false;
+};
+
+struct GlbWriteStats {
+  size_t geometry_bytes = 0;    // 압축 전 bufferView 데이터
+  size_t compressed_bytes = 0;  // meshopt/Draco 압축 후 (압축하지 않았으면 0)
+  double encode_seconds = 0.0;
+  std::filesystem::path fallback_path;  // meshopt 사용 시 기록한 fallback 버퍼
+  // quantize 사용 시 정점 속성 크기 (float 기준 → 양자화 후)와 최대 오차
+  size_t float_vertex_bytes = 0;
+  size_t quantized_vertex_bytes = 0;
+  double position_error = 0.0;        // 모델 단위
+  double normal_error_degrees = 0.0;  // meshopt 사용 시 octahedral 디코딩 기준
+  double texcoord_error = 0.0;        // 텍스처 반복 단위
+  // embed_images 사용 시 GLB에 넣은 image 파일 수와 바이트
+  size_t embedded_images = 0;
+  size_t embedded_image_bytes = 0;
+  // scene.proxy_roots 사용 시 proxy를 그리는 데 필요한 파일 앞부분 (헤더 + JSON + proxy geometry)과 파일 크기
+  size_t proxy_end = 0;
+  size_t file_bytes = 0;
+};
+
+// 성공 시 true. 실패하면 error에 원인을 채웁니다. stats는 nullptr 가능.
+bool WriteGlb(const GltfScene& scene,
+              const std::filesystem::path& path,
+              const GlbWriteOptions& options,
+              GlbWriteStats* stats,
+              std::string* error);
+
+inline bool WriteGlb(const GltfScene& scene, const std::filesystem::path& path, std::string* error) {
+  return WriteGlb(scene, path, GlbWriteOptions{}, nullptr, error);
+}
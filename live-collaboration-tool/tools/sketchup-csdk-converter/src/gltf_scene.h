@@ -0,0 +1,89 @@
+#pragma once
+
+// GLB 출력용 중간 표현(IR).
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct GltfMaterial {
+  std::string name;
+  float base_color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+  int image = -1;  // GltfScene::images 인덱스 (-1이면 색상만)
+};
+
+struct GltfImage {
+  // 외부 파일 참조(uri). GLB 기준 상대 경로 (예: "model/tex_1.png")
+  std::string uri;
+  std::string mime_type;
+  // 비어 있지 않으면 같은 텍스처의 KTX2 파일 (KHR_texture_basisu, uri는 확장 미지원 클라이언트용 fallback)
+  std::string basisu_uri;
+};
+
+// 인덱스 형식별 primitive 최대 정점 수.
+// glTF는 인덱스에 형식의 최댓값(primitive restart 값)을 쓰지 못하게 하므로 65535 / 2^32-1개까지입니다.
+constexpr size_t kMaxShortIndexVertices = 0xFFFF;
+constexpr size_t kMaxIntIndexVertices = 0xFFFFFFFFu;
+
+// 하나의 material을 쓰는 삼각형 묶음
+struct GltfPrimitive {
+  int material = -1;
+  std::vector<float> positions;  // xyz
+  std::vector<float> normals;    // xyz
+  std::vector<float> texcoords;  // uv
+  std::vector<uint32_t> indices;
+
+  size_t vertex_count() const { return positions.size() / 3; }
+};
+
+struct GltfMesh {
+  std::string name;
+  std::vector<GltfPrimitive> primitives;
+};
+
+// EXT_mesh_gpu_instancing 인스턴스 하나 (node 로컬 공간 기준 TRS)
+struct GltfInstance {
+  float translation[3] = {0.0f, 0.0f, 0.0f};
+  float rotation[4] = {0.0f, 0.0f, 0.0f, 1.0f};  // quaternion xyzw
+  float scale[3] = {1.0f, 1.0f, 1.0f};
+};
+
+// 컬링용 바운딩 볼륨 (scene_bounds.h). node에서는 부모 좌표 기준 (root node는 세계 좌표)
+struct GltfBounds {
+  bool valid = false;
+  double min[3] = {0.0, 0.0, 0.0};
+  double max[3] = {0.0, 0.0, 0.0};
+  double sphere[4] = {0.0, 0.0, 0.0, 0.0};  // 중심 xyz, 반지름
+};
+
+struct GltfNode {
+  std::string name;
+  int mesh = -1;
+  std::vector<int> children;
+  // 부모 기준 로컬 변환 (column-major). has_matrix=false면 단위 행렬
+  bool has_matrix = false;
+  double matrix[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+  // 비어 있지 않으면 mesh를 인스턴스 수만큼 그립니다 (EXT_mesh_gpu_instancing)
+  std::vector<GltfInstance> instances;
+  // MSFT_lod: 점점 낮은 LOD node (scene 트리에 넣지 않는 별도 node)와
+  // LOD별 최소 화면 비율 (MSFT_screencoverage, 이 node 포함 lods.size() + 1개)
+  std::vector<int> lods;
+  std::vector<double> lod_coverage;
+  // mesh(인스턴스 포함)와 자식 전체를 감싸는 범위 (node.extras.bounds)
+  GltfBounds bounds;
+};
+
+struct GltfScene {
+  std::vector<GltfMaterial> materials;
+  std::vector<GltfImage> images;
+  std::vector<GltfMesh> meshes;
+  std::vector<GltfNode> nodes;
+  std::vector<int> roots;  // scene.nodes
+  // 비어 있지 않으면 coarse-first 배치: 이 node들(자식 없이 mesh만 가진 proxy)의 mesh를 BIN 맨 앞에 쓰고
+  // 두 번째 glTF scene으로 내보냅니다. roots에는 넣지 않습니다.
+  std::vector<int> proxy_roots;
+  // --rtc: 모든 위치에서 뺀 원점 (SketchUp 좌표, inch). 루트 extras.rtcCenter로 기록
+  bool has_origin = false;
+  double origin[3] = {0.0, 0.0, 0.0};
+};
@@ -0,0 +1,175 @@
+#include "image_resample.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 출력 픽셀 i가 덮는 입력 구간 [i * scale, (i + 1) * scale)의 픽셀별 가중치
+struct Span {
+  size_t first = 0;
+  std::vector<float> weights;
+};
+
+std::vector<Span> BuildSpans(size_t src, size_t dst) {
+  std::vector<Span> spans(dst);
+  const double scale = static_cast<double>(src) / dst;
+  for (size_t i = 0; i < dst; i++) {
+    const double begin = i * scale;
+    const double end = std::max(begin + 1e-9, (i + 1) * scale);
+    Span& s = spans[i];
+    s.first = std::min(src - 1, static_cast<size_t>(begin));
+    const size_t last = std::min(src - 1, static_cast<size_t>(std::ceil(end) - 1));
+    for (size_t k = s.first; k <= last; k++) {
+      const double w = std::min<double>(end, k + 1.0) - std::max<double>(begin, static_cast<double>(k));
+      s.weights.push_back(static_cast<float>(std::max(w, 0.0)));
+    }
+    if (s.weights.empty()) s.weights.push_back(1.0f);
+  }
+  return spans;
+}
+
+inline uint64_t Mix(uint64_t z) {
+  // splitmix64 finalizer
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+}  // namespace
+
+float SrgbToLinear(uint8_t v) {
+  const float c = v / 255.0f;
+  return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+uint8_t LinearToSrgb(float c) {
+  c = std::max(0.0f, std::min(1.0f, c));
+  const float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+  return static_cast<uint8_t>(s * 255.0f + 0.5f);
+}
+
+RgbaImage ResampleImage(const RgbaImage& src, size_t width, size_t height) {
+  RgbaImage dst;
+  dst.width = std::max<size_t>(1, width);
+  dst.height = std::max<size_t>(1, height);
+  dst.pixels.assign(dst.width * dst.height * 4, 0);
+  if (src.width == 0 || src.height == 0) return dst;
+
+  float to_linear[256];
+  for (int i = 0; i < 256; i++) to_linear[i] = SrgbToLinear(static_cast<uint8_t>(i));
+
+  // 가로 → 세로 순서의 분리 필터. 중간값은 (선형 색 * 알파, 알파) 누적
+  const std::vector<Span> xs = BuildSpans(src.width, dst.width);
+  const std::vector<Span> ys = BuildSpans(src.height, dst.height);
+  std::vector<float> rows(src.height * dst.width * 4);
+  for (size_t y = 0; y < src.height; y++) {
+    const uint8_t* in = &src.pixels[y * src.width * 4];
+    for (size_t x = 0; x < dst.width; x++) {
+      float acc[4] = {0, 0, 0, 0};
+      const Span& s = xs[x];
+      for (size_t k = 0; k < s.weights.size(); k++) {
+        const uint8_t* p = in + (s.first + k) * 4;
+        const float wa = s.weights[k] * (p[3] / 255.0f);
+        acc[0] += to_linear[p[0]] * wa;
+        acc[1] += to_linear[p[1]] * wa;
+        acc[2] += to_linear[p[2]] * wa;
+        acc[3] += wa;
+      }
+      float total = 0.0f;
+      for (float w : s.weights) total += w;
+      float* out = &rows[(y * dst.width + x) * 4];
+      for (int c = 0; c < 4; c++) out[c] = acc[c] / total;
+    }
+  }
+  for (size_t y = 0; y < dst.height; y++) {
+    const Span& s = ys[y];
+    float total = 0.0f;
+    for (float w : s.weights) total += w;
+    for (size_t x = 0; x < dst.width; x++) {
+      float acc[4] = {0, 0, 0, 0};
+      for (size_t k = 0; k < s.weights.size(); k++) {
+        const float* p = &rows[((s.first + k) * dst.width + x) * 4];
+        for (int c = 0; c < 4; c++) acc[c] += p[c] * s.weights[k];
+      }
+      uint8_t* out = &dst.pixels[(y * dst.width + x) * 4];
+      const float alpha = acc[3] / total;
+      for (int c = 0; c < 3; c++) out[c] = acc[3] > 0.0f ? LinearToSrgb(acc[c] / acc[3]) : 0;
+      out[3] = static_cast<uint8_t>(std::min(255.0f, alpha * 255.0f + 0.5f));
+    }
+  }
+  return dst;
+}
+
+void TextureTargetSize(size_t width,
+                       size_t height,
+                       double max_area_ratio,
+                       double texels_per_unit,
+                       size_t max_size,
+                       size_t* out_width,
+                       size_t* out_height) {
+  size_t w = width;
+  size_t h = height;
+  if (texels_per_unit > 0.0 && max_area_ratio > 0.0 && width > 0 && height > 0) {
+    // 원본 크기에서의 밀도 = sqrt(W * H / ratio). 필요한 배율 s = 목표 밀도 / 현재 밀도
+    const double s = texels_per_unit * std::sqrt(max_area_ratio / (static_cast<double>(width) * height));
+    auto pow2_at_least = [](double v) {
+      size_t p = 1;
+      while (static_cast<double>(p) < v) p <<= 1;
+      return p;
+    };
+    if (s < 1.0) {
+      w = std::min(width, pow2_at_least(width * s));
+      h = std::min(height, pow2_at_least(height * s));
+    }
+  }
+  if (max_size > 0 && std::max(w, h) > max_size) {
+    const double f = static_cast<double>(max_size) / std::max(w, h);
+    w = std::max<size_t>(1, static_cast<size_t>(std::lround(w * f)));
+    h = std::max<size_t>(1, static_cast<size_t>(std::lround(h * f)));
+  }
+  *out_width = w;
+  *out_height = h;
+}
+
+uint64_t HashPixels(size_t width, size_t height, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  const uint64_t seed = Mix(0x9E3779B97F4A7C15ull ^ width) ^ Mix(static_cast<uint64_t>(height) << 1);
+  // 8바이트씩 4개 lane에 나눠 누적 (곱셈 의존 사슬을 나눠 큰 텍스처에서도 빠르게)
+  uint64_t lane[4] = {seed, seed ^ 0x632BE59BD9B4E019ull, seed ^ 0x85EBCA77C2B2AE63ull, seed ^ 0xC2B2AE3D27D4EB4Full};
+  auto block = [&lane](const uint8_t* p) {
+    for (int k = 0; k < 4; k++) {
+      uint64_t w;
+      std::memcpy(&w, p + k * 8, 8);
+      lane[k] = (lane[k] ^ w) * 0x9FB21C651E98DF25ull;
+      lane[k] ^= lane[k] >> 29;
+    }
+  };
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) block(bytes + i);
+  uint8_t last[32] = {};  // 남은 바이트는 0으로 채운 블록 하나로 (길이는 마지막에 섞음)
+  if (i < size) std::memcpy(last, bytes + i, size - i);
+  block(last);
+  const uint64_t h = Mix(lane[0]) + Mix(lane[1]) * 3 + Mix(lane[2]) * 5 + Mix(lane[3]) * 7;
+  return Mix(h ^ size);
+}
+
+bool SamePixels(const RgbaImage& a, const RgbaImage& b) {
+  return a.width == b.width && a.height == b.height && a.pixels == b.pixels;
+}
+
+bool PixelContentIndex::find(uint64_t hash, const RgbaImage& image, size_t* value) const {
+  const auto range = entries_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (SamePixels(*it->second.first, image)) {
+      *value = it->second.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+void PixelContentIndex::add(uint64_t hash, std::shared_ptr<const RgbaImage> image, size_t value) {
+  entries_.emplace(hash, std::make_pair(std::move(image), value));
+}
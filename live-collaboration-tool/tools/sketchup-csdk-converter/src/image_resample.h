@@ -0,0 +1,57 @@
+#pragma once
+
+// 텍스처 축소(리샘플링), 목표 해상도 계산, 픽셀 내용 해시/비교.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 8비트 4채널 픽셀 (채널 3이 알파). 행 순서와 RGBA/BGRA 배치는 호출한 쪽이 정합니다.
+struct RgbaImage {
+  size_t width = 0;
+  size_t height = 0;
+  std::vector<uint8_t> pixels;
+};
+
+// sRGB 8비트 ↔ 선형 [0, 1] 변환 (선형은 범위를 벗어나면 잘라 냄). 밉맵/축소가 선형 공간에서 평균하는 데 씁니다.
+float SrgbToLinear(uint8_t v);
+uint8_t LinearToSrgb(float c);
+
+// 면적 가중 평균으로 width x height로 줄입니다. (확대도 동작하지만 최근접에 가깝습니다)
+// 색 채널은 sRGB → 선형으로 바꿔 알파 가중 평균하고, 알파는 선형으로 평균합니다.
+RgbaImage ResampleImage(const RgbaImage& src, size_t width, size_t height);
+
+// 텍스처를 얼마나 줄여도 되는지 계산합니다.
+// - max_area_ratio: 이 텍스처를 쓰는 face들의 (월드 면적 / uv 면적) 최댓값 (월드 단위² / 텍스처 반복²)
+// - texels_per_unit: 유지할 텍셀 밀도 (월드 단위당 텍셀, 0이면 밀도 기준 축소 안 함)
+// - max_size: 긴 변 상한 (0이면 상한 없음)
+// 밀도를 지키는 가장 작은 2의 거듭제곱(원본 이하)을 고른 뒤 max_size로 제한합니다. 줄일 필요가 없으면 원본 크기.
+void TextureTargetSize(size_t width,
+                       size_t height,
+                       double max_area_ratio,
+                       double texels_per_unit,
+                       size_t max_size,
+                       size_t* out_width,
+                       size_t* out_height);
+
+// 디코딩된 픽셀의 내용 해시 (비암호화 64비트). 크기가 다르면 같은 바이트여도 다른 값이 됩니다.
+// 같은 이미지가 여러 material/texture id로 들어 있을 때 한 번만 기록하는 데 씁니다.
+uint64_t HashPixels(size_t width, size_t height, const void* data, size_t size);
+
+// 크기와 픽셀 바이트가 모두 같으면 true
+bool SamePixels(const RgbaImage& a, const RgbaImage& b);
+
+// 픽셀 내용 → 값(기록한 텍스처 인덱스 등). HashPixels로 찾은 뒤 SamePixels로 확인하므로
+// 해시가 충돌한 다른 이미지는 같은 것으로 보지 않습니다. 비교용으로 처음 등록한 픽셀을 보관합니다.
+class PixelContentIndex {
+ public:
+  // image와 같은 픽셀이 등록돼 있으면 그 값을 value에 채우고 true
+  bool find(uint64_t hash, const RgbaImage& image, size_t* value) const;
+  void add(uint64_t hash, std::shared_ptr<const RgbaImage> image, size_t value);
+
+ private:
+  std::unordered_multimap<uint64_t, std::pair<std::shared_ptr<const RgbaImage>, size_t>> entries_;
+};
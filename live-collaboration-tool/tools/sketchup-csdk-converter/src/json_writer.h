@@ -0,0 +1,116 @@
+#pragma once
+
+// 최소한의 스트리밍 JSON 작성기 (glTF/부가 메타데이터 출력용).
+// 쉼표/키 순서만 관리하며, 스키마 검증은 하지 않습니다.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class JsonWriter {
+ public:
+  void begin_object() {
+    before_value();
+    out_.push_back('{');
+    first_.push_back(true);
+  }
+  void end_object() {
+    out_.push_back('}');
+    first_.pop_back();
+  }
+  void begin_array() {
+    before_value();
+    out_.push_back('[');
+    first_.push_back(true);
+  }
+  void end_array() {
+    out_.push_back(']');
+    first_.pop_back();
+  }
+
+  void key(const char* k) {
+    before_value();
+    append_string(k);
+    out_.push_back(':');
+    after_key_ = true;
+  }
+
+  void value(const std::string& s) {
+    before_value();
+    append_string(s.c_str());
+  }
+  void value(const char* s) {
+    before_value();
+    append_string(s);
+  }
+  void value(bool b) {
+    before_value();
+    out_ += b ? "true" : "false";
+  }
+  void value(int64_t v) {
+    before_value();
+    out_ += std::to_string(v);
+  }
+  void value(int v) { value(static_cast<int64_t>(v)); }
+  void value(size_t v) { value(static_cast<int64_t>(v)); }
+  void value(double v) {
+    before_value();
+    if (!std::isfinite(v)) v = 0.0;  // JSON에는 NaN/Inf가 없음
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", v);
+    out_ += buf;
+  }
+  // 원점/ECEF 변환처럼 큰 값에 작은 차이가 중요한 double (왕복 가능한 17자리)
+  void precise_value(double v) {
+    before_value();
+    if (!std::isfinite(v)) v = 0.0;
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", v);
+    out_ += buf;
+  }
+
+  // key + value 축약
+  template <typename T>
+  void field(const char* k, const T& v) {
+    key(k);
+    value(v);
+  }
+
+  const std::string& str() const { return out_; }
+
+ private:
+  void before_value() {
+    if (after_key_) {
+      after_key_ = false;
+      return;
+    }
+    if (!first_.empty()) {
+      if (!first_.back()) out_.push_back(',');
+      first_.back() = false;
+    }
+  }
+
+  void append_string(const char* s) {
+    out_.push_back('"');
+    for (const char* p = s; *p; ++p) {
+      const unsigned char c = static_cast<unsigned char>(*p);
+      if (c == '"' || c == '\\') {
+        out_.push_back('\\');
+        out_.push_back(static_cast<char>(c));
+      } else if (c < 0x20) {
+        char esc[8];
+        std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+        out_ += esc;
+      } else {
+        out_.push_back(static_cast<char>(c));
+      }
+    }
+    out_.push_back('"');
+  }
+
+  std::string out_;
+  std::vector<bool> first_;
+  bool after_key_ = false;
+};
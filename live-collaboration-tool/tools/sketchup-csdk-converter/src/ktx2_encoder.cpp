@@ -0,0 +1,157 @@
+#include "ktx2_encoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+#ifdef SKETCHUP_CONVERTER_HAS_KTX
+#include <ktx.h>
+#endif
+
+namespace {
+
+// 2x2 박스 필터 (홀수 크기는 가장자리 픽셀을 한 번 더 사용)
+RgbaImage Downsample(const RgbaImage& src, const float* to_linear) {
+  RgbaImage dst;
+  dst.width = std::max<size_t>(1, src.width / 2);
+  dst.height = std::max<size_t>(1, src.height / 2);
+  dst.pixels.resize(dst.width * dst.height * 4);
+  for (size_t y = 0; y < dst.height; y++) {
+    const size_t y0 = std::min(y * 2, src.height - 1);
+    const size_t y1 = std::min(y * 2 + 1, src.height - 1);
+    for (size_t x = 0; x < dst.width; x++) {
+      const size_t x0 = std::min(x * 2, src.width - 1);
+      const size_t x1 = std::min(x * 2 + 1, src.width - 1);
+      const uint8_t* p[4] = {&src.pixels[(y0 * src.width + x0) * 4], &src.pixels[(y0 * src.width + x1) * 4],
+                             &src.pixels[(y1 * src.width + x0) * 4], &src.pixels[(y1 * src.width + x1) * 4]};
+      uint8_t* out = &dst.pixels[(y * dst.width + x) * 4];
+      for (int c = 0; c < 3; c++) {
+        const float sum = to_linear[p[0][c]] + to_linear[p[1][c]] + to_linear[p[2][c]] + to_linear[p[3][c]];
+        out[c] = LinearToSrgb(sum * 0.25f);
+      }
+      out[3] = static_cast<uint8_t>((p[0][3] + p[1][3] + p[2][3] + p[3][3] + 2) / 4);  // 알파는 선형
+    }
+  }
+  return dst;
+}
+
+}  // namespace
+
+std::vector<RgbaImage> BuildMipChain(const RgbaImage& base) {
+  float to_linear[256];
+  for (int i = 0; i < 256; i++) to_linear[i] = SrgbToLinear(static_cast<uint8_t>(i));
+
+  std::vector<RgbaImage> chain;
+  chain.push_back(base);
+  while (chain.back().width > 1 || chain.back().height > 1) {
+    chain.push_back(Downsample(chain.back(), to_linear));
+  }
+  return chain;
+}
+
+#ifdef SKETCHUP_CONVERTER_HAS_KTX
+
+bool Ktx2Available() { return true; }
+
+bool EncodeKtx2(const RgbaImage& image, bool uastc, const Ktx2Options& options, const std::filesystem::path& path,
+                size_t* bytes, unsigned* levels, std::string* error) {
+  if (image.width == 0 || image.height == 0 || image.width % 4 != 0 || image.height % 4 != 0) {
+    if (error) *error = "KTX2 base size must be a non-zero multiple of 4";
+    return false;
+  }
+  const std::vector<RgbaImage> chain = BuildMipChain(image);
+
+  constexpr uint32_t kVkFormatR8G8B8A8Srgb = 43;  // VK_FORMAT_R8G8B8A8_SRGB
+  ktxTextureCreateInfo info = {};
+  info.vkFormat = kVkFormatR8G8B8A8Srgb;
+  info.baseWidth = static_cast<ktx_uint32_t>(image.width);
+  info.baseHeight = static_cast<ktx_uint32_t>(image.height);
+  info.baseDepth = 1;
+  info.numDimensions = 2;
+  info.numLevels = static_cast<ktx_uint32_t>(chain.size());
+  info.numLayers = 1;
+  info.numFaces = 1;
+  info.isArray = KTX_FALSE;
+  info.generateMipmaps = KTX_FALSE;
+
+  ktxTexture2* texture = nullptr;
+  KTX_error_code rc = ktxTexture2_Create(&info, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &texture);
+  if (rc != KTX_SUCCESS) {
+    if (error) *error = std::string("ktxTexture2_Create: ") + ktxErrorString(rc);
+    return false;
+  }
+  for (size_t level = 0; level < chain.size() && rc == KTX_SUCCESS; level++) {
+    rc = ktxTexture_SetImageFromMemory(ktxTexture(texture), static_cast<ktx_uint32_t>(level), 0, 0,
+                                       chain[level].pixels.data(), chain[level].pixels.size());
+  }
+
+  if (rc == KTX_SUCCESS) {
+    ktxBasisParams params = {};
+    params.structSize = sizeof(params);
+    params.uastc = uastc ? KTX_TRUE : KTX_FALSE;
+    params.threadCount = 1;  // 텍스처 단위로 병렬화하므로 텍스처 안에서는 단일 스레드
+    params.compressionLevel = static_cast<ktx_uint32_t>(options.etc1s_level);
+    params.qualityLevel = static_cast<ktx_uint32_t>(options.etc1s_quality);
+    params.uastcFlags = KTX_PACK_UASTC_LEVEL_DEFAULT;
+    rc = ktxTexture2_CompressBasisEx(texture, &params);
+  }
+  // UASTC는 그대로면 픽셀당 1바이트라 zstd로 한 번 더 줄입니다. (ETC1S는 자체 supercompression 사용)
+  if (rc == KTX_SUCCESS && uastc) {
+    rc = ktxTexture2_DeflateZstd(texture, static_cast<ktx_uint32_t>(options.uastc_zstd_level));
+  }
+
+  ktx_uint8_t* data = nullptr;
+  ktx_size_t size = 0;
+  if (rc == KTX_SUCCESS) rc = ktxTexture_WriteToMemory(ktxTexture(texture), &data, &size);
+  ktxTexture_Destroy(ktxTexture(texture));
+  if (rc != KTX_SUCCESS) {
+    if (error) *error = std::string("KTX2 encode failed: ") + ktxErrorString(rc);
+    return false;
+  }
+
+  std::ofstream f(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  f.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+  std::free(data);
+  if (!f.good()) {
+    if (error) *error = "failed to write " + path.string();
+    return false;
+  }
+  if (bytes) *bytes = size;
+  if (levels) *levels = static_cast<unsigned>(chain.size());
+  return true;
+}
+
+#else
+
+bool Ktx2Available() { return false; }
+
+bool EncodeKtx2(const RgbaImage&, bool, const Ktx2Options&, const std::filesystem::path&, size_t*, unsigned*,
+                std::string* error) {
+  if (error) *error = "built without libktx (install KTX-Software and reconfigure CMake)";
+  return false;
+}
+
+#endif
+
+void EncodeKtx2Jobs(std::vector<Ktx2Job>* jobs, const Ktx2Options& options, unsigned threads) {
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < jobs->size(); i = next++) {
+      Ktx2Job& job = (*jobs)[i];
+      const auto t0 = std::chrono::steady_clock::now();
+      job.ok = EncodeKtx2(job.image, job.uastc, options, job.path, &job.bytes, &job.levels, &job.error);
+      job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+      // 인코딩이 끝난 픽셀은 바로 놓아 동시에 잡고 있는 메모리를 줄입니다.
+      job.image.pixels = std::vector<uint8_t>();
+    }
+  };
+  const unsigned count = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(jobs->size())));
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < count; t++) pool.emplace_back(worker);
+  worker();
+  for (std::thread& t : pool) t.join();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// KHR_texture_basisu용 KTX2(Basis Universal) 텍스처 인코더.
+// - 색상 텍스처: ETC1S (작고 빠르게 트랜스코딩)
+// - 알파를 쓰는 텍스처: UASTC + zstd (ETC1S는 알파 품질이 떨어짐)
+// mip 체인은 여기서 sRGB 기준 박스 필터로 미리 만들어 넣습니다.
+// libktx와 함께 빌드된 경우(SKETCHUP_CONVERTER_HAS_KTX)에만 인코딩하며, 없으면 Ktx2Available()이 false입니다.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "image_resample.h"  // RgbaImage (KTX2에는 위→아래 행 순서의 RGBA로 넘깁니다)
+
+struct Ktx2Options {
+  int etc1s_quality = 128;  // 1 ~ 255
+  int etc1s_level = 2;      // 0 ~ 5 (높을수록 느리고 작음)
+  int uastc_zstd_level = 18;
+};
+
+struct Ktx2Job {
+  RgbaImage image;
+  bool uastc = false;  // 알파 사용 텍스처
+  std::filesystem::path path;
+  // 결과
+  bool ok = false;
+  std::string error;
+  size_t bytes = 0;
+  unsigned levels = 0;
+  double seconds = 0.0;
+};
+
+bool Ktx2Available();
+
+// base를 포함한 mip 체인 (1x1까지). 색상은 선형 공간에서 평균합니다.
+std::vector<RgbaImage> BuildMipChain(const RgbaImage& base);
+
+// 성공 시 true. 실패하면 error에 원인을 채웁니다. KHR_texture_basisu는 base 크기가 4의 배수여야 합니다.
+bool EncodeKtx2(const RgbaImage& image, bool uastc, const Ktx2Options& options, const std::filesystem::path& path,
+                size_t* bytes, unsigned* levels, std::string* error);
+
+// jobs를 threads개 스레드로 나눠 인코딩하고 각 job에 결과를 채웁니다. (threads 0 = 1)
+void EncodeKtx2Jobs(std::vector<Ktx2Job>* jobs, const Ktx2Options& options, unsigned threads);
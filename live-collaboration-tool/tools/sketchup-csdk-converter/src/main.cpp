@@ -4,28 +4,121 @@
 #include <SketchUpAPI/geometry/point3d.h>
 #include <SketchUpAPI/geometry/transformation.h>
 #include <SketchUpAPI/geometry/vector3d.h>
+#include <SketchUpAPI/model/image_rep.h>
 #include <SketchUpAPI/model/component_definition.h>
 #include <SketchUpAPI/model/component_instance.h>
+#include <SketchUpAPI/model/edge.h>
 #include <SketchUpAPI/model/entities.h>
 #include <SketchUpAPI/model/face.h>
 #include <SketchUpAPI/model/group.h>
+#include <SketchUpAPI/model/location.h>
+#include <SketchUpAPI/model/loop.h>
 #include <SketchUpAPI/model/material.h>
 #include <SketchUpAPI/model/mesh_helper.h>
 #include <SketchUpAPI/model/model.h>
+#include <SketchUpAPI/model/texture.h>
 #include <SketchUpAPI/model/texture_writer.h>
+#include <SketchUpAPI/model/vertex.h>
 #include <SketchUpAPI/unicodestring.h>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cfloat>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "coplanar_merge.h"
+#include "face_mesh.h"
+#include "glb_writer.h"
+#include "gltf_scene.h"
+#include "image_resample.h"
+#include "ktx2_encoder.h"
+#include "mesh_optimize.h"
+#include "mesh_simplify.h"
+#include "png_writer.h"
+#include "scene_bounds.h"
+#include "scene_proxy.h"
+#include "smoothing_groups.h"
+#include "text_writer.h"
+#include "texture_atlas.h"
+#include "tileset_writer.h"
+#include "transform_math.h"
+#include "vertex_weld.h"
+#include "worker_pool.h"
+
 namespace fs = std::filesystem;
 
+// CLI로 조정하는 출력 옵션
+struct ExportOptions {
+  // 정점 용접: (position, normal, uv)를 epsilon 격자로 합쳐 공유 인덱스로 출력
+  bool weld = true;
+  double weld_epsilon = 1e-5;  // 0이면 완전히 같은 값만 합침
+  // OBJ/MTL 실수 출력 유효 숫자 수 (기존 std::ostream 기본값과 같은 6)
+  int precision = TextWriter::kDefaultPrecision;
+  // 모델 bounding box 중심(double)을 빼고 출력 (RTC). float/짧은 유효 숫자로도 큰 좌표가 떨리지 않게
+  bool rtc = false;
+  // soft/smooth edge로 이어진 face의 꼭짓점 normal을 평균 (smoothing group). 이어진 정점은 용접으로 공유됨
+  bool smooth_normals = false;
+  // 같은 entities에서 material과 uv 매핑이 같은 이웃 동일 평면 face를 다각형 하나로 합쳐 다시 삼각형화
+  bool merge_coplanar = false;
+  // GLB 배치: flat = 월드 좌표로 구운 단일 mesh,
+  //           instanced = definition마다 mesh 하나 + EXT_mesh_gpu_instancing
+  //           hierarchy = group/인스턴스마다 node(로컬 변환) + definition마다 공유 mesh
+  enum class GlbLayout { kFlat, kInstanced, kHierarchy };
+  GlbLayout glb_layout = GlbLayout::kFlat;
+  // GLB primitive 최대 정점 수. 넘으면 같은 material의 primitive를 새로 엽니다.
+  // (--glb-index-bits 16: 모든 primitive를 UNSIGNED_SHORT 인덱스로)
+  size_t glb_max_primitive_vertices = kMaxIntIndexVertices;
+  // GLB 기록 전 primitive마다 정점 캐시 / overdraw / fetch 순서 최적화
+  bool optimize_meshes = true;
+  // GLB bufferView를 EXT_meshopt_compression으로 압축 (+ model.fallback.bin)
+  bool meshopt_compression = false;
+  // GLB primitive를 KHR_draco_mesh_compression으로 압축 (Draco와 함께 빌드된 경우)
+  bool draco_compression = false;
+  DracoOptions draco;
+  // GLB 정점 속성을 KHR_mesh_quantization 정수형으로 기록 (face마다 uv를 원점 근처로 옮김)
+  bool quantize = false;
+  // 원본 인코딩(JPEG/PNG)을 그대로 쓸 수 있는 텍스처는 PNG로 다시 인코딩하지 않음
+  bool keep_original_textures = true;
+  // GLB 텍스처를 KTX2(Basis Universal)로도 인코딩해 KHR_texture_basisu로 참조 (libktx와 함께 빌드된 경우)
+  bool ktx2 = false;
+  // GLB 텍스처(KTX2 포함)를 GLB 안에 bufferView로 넣고 model/ 파일은 지움 (--external-textures로 끔)
+  bool embed_textures = true;
+  // GLB에서 uv가 [0, 1] 안에 머무는(반복하지 않는) 작은 텍스처를 atlas 페이지로 묶고 material을 합침
+  bool atlas = false;
+  size_t atlas_max_texture_size = 256;  // 긴 변이 이 값 이하인 텍스처만 (px)
+  // GLB mesh마다 quadric 단순화 LOD를 만들어 MSFT_lod로 연결 (원본 포함 단계 수 2~4, 0 = 끔)
+  int lod_levels = 0;
+  // GLB 앞부분에 모델 전체를 줄인 proxy를 두고 범위 요청용 바이트 색인을 기록 (삼각형 예산)
+  bool progressive = false;
+  size_t proxy_triangles = 10000;
+  // flat GLB를 모델 박스의 정육면체 칸(긴 변 N칸)별 mesh/node로 나눠 node마다 culling 볼륨을 갖게 함 (0 = 끔)
+  size_t flat_grid = 0;
+  // GLB를 loose octree tile로 나눠 3D Tiles(tileset.json + tiles/*.glb)로 씀 (flat 배치만)
+  bool tiles = false;
+  size_t tile_max_triangles = 50000;  // 이보다 많은 삼각형이 든 tile은 8개로 나눔
+  // 텍스처 긴 변 상한 (px, 0 = 제한 없음)
+  size_t max_texture_size = 0;
+  // 유지할 텍셀 밀도 (px/m, 0 = 끔). 이 밀도를 넘는 텍스처는 2의 거듭제곱 크기로 줄입니다.
+  double texel_density = 0.0;
+  // 텍스처 인코딩/기록과 KTX2 인코딩 worker 수 (0 = cgroup quota/affinity를 반영한 사용 가능 CPU 수)
+  unsigned threads = 0;
+  // flat 출력에서 인스턴스가 이만큼 이상 쓰이는 definition은 로컬 테셀레이션을 캐시 (0 = 끔)
+  size_t cache_min_instances = 2;
+};
+
 static SUTransformation IdentityTransform() {
   SUTransformation t{};
   for (int i = 0; i < 16; i++) t.values[i] = 0.0;
@@ -45,25 +138,171 @@ static void Normalize(SUVector3D* v) {
   }
 }
 
-struct ObjWriter {
-  std::ofstream obj;
-  std::ofstream mtl;
-  fs::path base_dir;
-  size_t next_index = 1;  // OBJ is 1-based
-  std::string current_usemtl;
-  std::unordered_set<std::string> written_mtls;
-  std::unordered_set<long> written_textures;
+// face 텍스처 한 장의 출력 정보 (TessellateFace에서 결정)
+struct TextureSource {
+  long id = 0;                         // SUTextureWriter texture id
+  SUTextureRef original = SU_INVALID;  // 유효하면 원본 파일 바이트를 그대로 기록
+  bool alpha = false;                  // SUTextureGetUseAlphaChannel
+};
 
-  explicit ObjWriter(const fs::path& out_dir) {
-    base_dir = out_dir;
-    const fs::path obj_path = out_dir / "model.obj";
-    const fs::path mtl_path = out_dir / "model.mtl";
-    obj.open(obj_path, std::ios::out | std::ios::trunc);
-    mtl.open(mtl_path, std::ios::out | std::ios::trunc);
-    obj << "mtllib model.mtl\n";
+// ImageRep 픽셀을 위→아래 RGBA8로 읽습니다. (SUColor 기준이라 플랫폼 채널 배치와 무관)
+static bool ImageRepRgba(SUImageRepRef image, RgbaImage* out) {
+  size_t width = 0;
+  size_t height = 0;
+  if (SUImageRepGetPixelDimensions(image, &width, &height) != SU_ERROR_NONE || width == 0 || height == 0) {
+    return false;
   }
+  std::vector<SUColor> colors(width * height);
+  if (SUImageRepGetDataAsColors(image, colors.data()) != SU_ERROR_NONE) return false;
 
-  bool ok() const { return obj.good() && mtl.good(); }
+  // ImageRep은 아래 행부터 저장되어 있어 뒤집습니다.
+  out->width = width;
+  out->height = height;
+  out->pixels.resize(width * height * 4);
+  for (size_t y = 0; y < height; y++) {
+    const SUColor* row = &colors[(height - 1 - y) * width];
+    uint8_t* dst = &out->pixels[y * width * 4];
+    for (size_t x = 0; x < width; x++) {
+      dst[x * 4 + 0] = row[x].red;
+      dst[x * 4 + 1] = row[x].green;
+      dst[x * 4 + 2] = row[x].blue;
+      dst[x * 4 + 3] = row[x].alpha;
+    }
+  }
+  return true;
+}
+
+// texture writer가 기록하는 것과 같은 이미지(colorize/펼침 반영)를 위→아래 RGBA8로 읽습니다.
+// width/height가 0이 아니면 그 크기로 리샘플합니다.
+static bool TextureWriterRgba(
+    SUTextureWriterRef texture_writer, long texture_id, size_t width, size_t height, RgbaImage* out) {
+  SUImageRepRef image = SU_INVALID;
+  if (SUImageRepCreate(&image) != SU_ERROR_NONE) return false;
+  RgbaImage source;
+  const bool ok = SUTextureWriterGetImageRep(texture_writer, texture_id, &image) == SU_ERROR_NONE &&
+                  ImageRepRgba(image, &source);
+  SUImageRepRelease(&image);
+  if (!ok) return false;
+  const bool keep = width == 0 || height == 0 || (width == source.width && height == source.height);
+  *out = keep ? std::move(source) : ResampleImage(source, width, height);
+  return true;
+}
+
+// face에서 추출한 지오메트리를 받는 출력 대상 (obj / glb 공통)
+struct MeshSink {
+  virtual ~MeshSink() = default;
+
+  virtual void ensure_color_material(const std::string& raw_name, double r, double g, double b) = 0;
+  // source.original이 유효하면 원본 이미지 바이트를 그대로 기록하고, 아니면 texture writer로 다시 인코딩.
+  // 픽셀 내용이 이미 기록한 텍스처와 같으면 새로 기록하지 않고 그 파일을 참조합니다.
+  virtual void ensure_texture_material(
+      SUTextureWriterRef texture_writer,
+      const TextureSource& source,
+      const std::string& material_name,
+      const std::string& texture_rel_path) = 0;
+  virtual void usemtl(const std::string& name) = 0;
+  // face 하나의 정점을 넣기 직전에 호출 (vertex_count는 용접 전 최대치).
+  // anchor는 face 바운딩 박스 중심(세계 좌표)으로, wants_face_anchor()가 true일 때만 채워집니다.
+  virtual void begin_face(size_t vertex_count, const SUPoint3D* anchor) {
+    (void)vertex_count;
+    (void)anchor;
+  }
+  virtual bool wants_face_anchor() const { return false; }
+  // --rtc: 출력 좌표에서 뺀 원점 (SketchUp 좌표). 정점을 넣기 전에 한 번 호출
+  virtual void record_origin(const double origin[3]) { (void)origin; }
+  // true면 face마다 uv를 정수만큼 옮겨 원점 근처에 둡니다 (REPEAT 샘플링이라 결과는 같음)
+  virtual bool shift_face_uvs() const { return false; }
+  // 반환값은 add_triangle에 그대로 넘기는 sink 내부 인덱스
+  virtual size_t add_vertex(const SUPoint3D& p, const SUVector3D& n, double u, double v) = 0;
+  virtual void add_triangle(size_t a, size_t b, size_t c) = 0;
+
+  const WeldStats& weld_stats() const { return stats; }
+  size_t textures_original() const { return original_textures; }
+  size_t textures_reencoded() const { return reencoded_textures; }
+  size_t textures_deduplicated() const { return deduplicated_textures; }
+  size_t textures_async() const { return async_textures; }
+
+  // 있으면 PNG 재인코딩과 파일 기록을 이 풀에서 순회와 동시에 합니다 (zlib과 함께 빌드된 경우).
+  // 순회가 끝나면 finish_textures()로 기다려야 합니다.
+  WorkerPool* texture_pool = nullptr;
+
+  // 풀에 넘긴 텍스처 기록을 기다리고, 실패한 것은 SDK로 다시 기록합니다. 순회 스레드에서 호출
+  void finish_textures(SUTextureWriterRef texture_writer) {
+    if (!texture_pool) return;
+    texture_pool->wait();
+    for (const AsyncFailure& f : failed_async) {
+      const WrittenTexture& t = written_list[f.index];
+      std::cerr << "Texture " << t.rel_path << ": " << f.error << ", writing with the SDK\n";
+      SUTextureWriterWriteTexture(texture_writer, t.id, texture_path(t.rel_path).string().c_str(), false);
+      async_textures--;
+    }
+    failed_async.clear();
+  }
+
+  // TessellateFace가 원본 텍스처를 고를지 여부 (--png-textures면 false)
+  bool keep_original_textures = true;
+  // --texel-density / --atlas: EmitFaceMesh가 텍스처 material마다 사용량(TextureUsage)을 모을지 여부
+  bool track_texture_usage = false;
+  // --smooth-normals: face를 테셀레이션하기 전에 entities마다 smoothing group을 만들지 여부
+  bool smooth_normals = false;
+  SmoothingStats smoothing;
+  // --merge-coplanar: entities마다 테셀레이션한 face를 모아 동일 평면 face를 합친 뒤 출력할지 여부
+  bool merge_coplanar = false;
+  CoplanarMergeStats coplanar;
+  size_t coplanar_triangles_before = 0;  // 합치기 전 SUMeshHelper 삼각형 (테셀레이션한 face마다)
+  size_t coplanar_triangles_after = 0;   // 합친 뒤 출력한 삼각형
+
+  // 텍스처 material 하나를 쓰는 face들의 집계
+  struct TextureUsage {
+    double max_area_ratio = 0.0;  // (월드 면적 / uv 면적) 최댓값
+    float uv_min[2] = {FLT_MAX, FLT_MAX};
+    float uv_max[2] = {-FLT_MAX, -FLT_MAX};
+  };
+
+  // 기록한 텍스처 (기록 순서). 내용이 같은 텍스처는 항목 하나를 여러 texture id/material이 공유합니다.
+  struct WrittenTexture {
+    long id = 0;  // 처음 기록한 texture id (픽셀을 다시 읽을 때 사용)
+    std::string rel_path;
+    std::vector<std::string> materials;
+    size_t width = 0;  // ResizeTextures가 정한 크기 (0이면 원본 그대로)
+    size_t height = 0;
+  };
+  const std::vector<WrittenTexture>& written() const { return written_list; }
+  std::vector<WrittenTexture>& written() { return written_list; }
+  fs::path texture_path(const std::string& rel_path) const { return base_dir / rel_path; }
+  const WrittenTexture* find_written(long texture_id) const {
+    auto it = written_textures.find(texture_id);
+    return it != written_textures.end() ? &written_list[it->second] : nullptr;
+  }
+
+  // face 하나의 텍스처 사용량. uv 면적이 0에 가까운 face(한 점으로 찍힌 uv)는 밀도를 정할 수 없어 면적비에서 뺍니다.
+  void add_texture_usage(const std::string& material,
+                         double world_area,
+                         double uv_area,
+                         const float uv_min[2],
+                         const float uv_max[2]) {
+    TextureUsage& usage = texture_usage_map[material];
+    if (uv_area > 1e-12 && world_area > 0.0) {
+      usage.max_area_ratio = std::max(usage.max_area_ratio, world_area / uv_area);
+    }
+    for (int c = 0; c < 2; c++) {
+      usage.uv_min[c] = std::min(usage.uv_min[c], uv_min[c]);
+      usage.uv_max[c] = std::max(usage.uv_max[c], uv_max[c]);
+    }
+  }
+  // material의 사용량. 그 material로 출력된 face가 없으면 nullptr
+  const TextureUsage* texture_usage(const std::string& material) const {
+    auto it = texture_usage_map.find(material);
+    return it != texture_usage_map.end() ? &it->second : nullptr;
+  }
+  // 텍스처를 쓰는 face 중 (월드 면적 / uv 면적) 최댓값. 모은 값이 없으면 0
+  double texture_area_ratio(const WrittenTexture& texture) const {
+    double ratio = 0.0;
+    for (const std::string& material : texture.materials) {
+      if (const TextureUsage* usage = texture_usage(material)) ratio = std::max(ratio, usage->max_area_ratio);
+    }
+    return ratio;
+  }
 
   static std::string sanitize_name(const std::string& s) {
     std::string out;
@@ -80,14 +319,192 @@ struct ObjWriter {
     return out;
   }
 
-  void usemtl(const std::string& name) {
+ protected:
+  fs::path base_dir;
+  std::unordered_map<long, size_t> written_textures;  // texture id → written_list 인덱스
+  PixelContentIndex written_content;  // 픽셀 내용 → written_list 인덱스
+  std::vector<WrittenTexture> written_list;
+  std::unordered_map<std::string, TextureUsage> texture_usage_map;
+  WeldStats stats;
+  size_t original_textures = 0;
+  size_t reencoded_textures = 0;
+  size_t deduplicated_textures = 0;
+  size_t async_textures = 0;
+  struct AsyncFailure {
+    size_t index;  // written_list 인덱스
+    std::string error;
+  };
+  std::mutex failed_mutex;  // worker가 failed_async에 기록
+  std::vector<AsyncFailure> failed_async;
+
+  // texture id당 한 번만 base_dir/texture_rel_path에 기록하고, material이 참조할 경로를 돌려줍니다.
+  // 디코딩된 픽셀이 이미 기록한 텍스처와 같으면(라이브러리 material 중복, 같은 결과의 colorize 사본 등)
+  // 기록하지 않고 그 텍스처의 경로를 돌려줍니다.
+  // source.original이 유효하면 모델에 저장된 파일 바이트를 그대로 쓰고(확장자가 원본 형식과 같을 때),
+  // 실패하거나 original이 없으면 확장자 형식으로 다시 인코딩합니다. PNG는 texture_pool이 있으면
+  // 여기서 읽은 픽셀을 worker가 인코딩/기록하고, 없으면 texture writer가 이 스레드에서 기록합니다.
+  // (SDK 호출인 픽셀 읽기와 원본 바이트 복사는 순회 스레드에 남습니다)
+  std::string write_texture_once(SUTextureWriterRef texture_writer,
+                                 const TextureSource& source,
+                                 const std::string& material_name,
+                                 const std::string& texture_rel_path) {
+    auto known = written_textures.find(source.id);
+    if (known != written_textures.end()) {
+      WrittenTexture& written = written_list[known->second];
+      if (std::find(written.materials.begin(), written.materials.end(), material_name) == written.materials.end()) {
+        written.materials.push_back(material_name);
+      }
+      return written.rel_path;
+    }
+    // 경로가 material 출력 전에 정해져야 하므로(OBJ mtl은 바로 기록) 해시는 여기서 계산합니다.
+    // 해시가 같아도 크기/픽셀을 비교하므로 픽셀은 written_content와 PNG worker가 함께 보관합니다.
+    auto pixels = std::make_shared<RgbaImage>();
+    const bool captured = TextureWriterRgba(texture_writer, source.id, 0, 0, pixels.get());
+    if (captured) {
+      const uint64_t hash = HashPixels(pixels->width, pixels->height, pixels->pixels.data(), pixels->pixels.size());
+      size_t same = 0;
+      if (written_content.find(hash, *pixels, &same)) {
+        written_textures.emplace(source.id, same);
+        WrittenTexture& written = written_list[same];
+        if (std::find(written.materials.begin(), written.materials.end(), material_name) == written.materials.end()) {
+          written.materials.push_back(material_name);
+        }
+        deduplicated_textures++;
+        return written.rel_path;
+      }
+      written_content.add(hash, pixels, written_list.size());
+    }
+    written_textures.emplace(source.id, written_list.size());
+    WrittenTexture written;
+    written.id = source.id;
+    written.rel_path = texture_rel_path;
+    written.materials.push_back(material_name);
+    written_list.push_back(written);
+
+    const fs::path tex_abs = base_dir / texture_rel_path;
+    fs::create_directories(tex_abs.parent_path());
+    if (!SUIsInvalid(source.original) &&
+        SUTextureWriteOriginalToFile(source.original, tex_abs.string().c_str()) == SU_ERROR_NONE) {
+      original_textures++;
+      return texture_rel_path;
+    }
+    if (captured && texture_pool && PngAvailable() && tex_abs.extension() == ".png") {
+      const size_t index = written_list.size() - 1;
+      texture_pool->submit([this, index, tex_abs, image = std::move(pixels)]() {
+        std::string error;
+        if (WritePng(*image, tex_abs, &error)) return;
+        std::lock_guard<std::mutex> lock(failed_mutex);
+        failed_async.push_back(AsyncFailure{index, error});
+      });
+      async_textures++;
+      reencoded_textures++;
+      return texture_rel_path;
+    }
+    SUTextureWriterWriteTexture(texture_writer, source.id, tex_abs.string().c_str(), false);
+    reencoded_textures++;
+    return texture_rel_path;
+  }
+};
+
+// v/vt/vn은 바로 기록하고, f는 material별로 모아 finish()에서 material당 한 번의 usemtl 아래 이어서
+// 기록합니다. face 순서대로 usemtl을 바꾸면 Assimp가 작은 그룹마다 mesh를 따로 만들기 때문입니다.
+struct ObjWriter : MeshSink {
+  TextWriter obj;
+  TextWriter mtl;
+  std::string current_usemtl;
+  std::unordered_set<std::string> written_mtls;
+
+  // material별 삼각형 (corners 핸들 3개씩), 처음 쓰인 순서대로
+  struct FaceGroup {
+    std::string material;
+    std::vector<uint32_t> corners;
+  };
+  std::vector<FaceGroup> groups;
+  std::unordered_map<std::string, size_t> group_for_material;
+  size_t current_group = 0;
+  size_t usemtl_runs = 0;  // face 순서대로 썼다면 나왔을 usemtl 수 (보고용)
+
+  // position / normal / uv를 각각 따로 용접 (OBJ의 f a/b/c는 속성별 인덱스를 가짐)
+  bool weld;
+  WeldPool<3> position_pool;
+  WeldPool<3> normal_pool;
+  WeldPool<2> texcoord_pool;
+  // add_vertex 핸들 → (v, vt, vn) 1-based 인덱스
+  std::vector<std::array<uint32_t, 3>> corners;
+
+  ObjWriter(const fs::path& out_dir, const ExportOptions& options)
+      : weld(options.weld),
+        position_pool(options.weld_epsilon),
+        normal_pool(options.weld_epsilon),
+        texcoord_pool(options.weld_epsilon) {
+    base_dir = out_dir;
+    keep_original_textures = options.keep_original_textures;
+    track_texture_usage = options.texel_density > 0.0 || options.atlas;
+    smooth_normals = options.smooth_normals;
+    merge_coplanar = options.merge_coplanar;
+    // usemtl 이전의 face는 이름 없는 그룹 (usemtl 없이 기록)
+    groups.push_back(FaceGroup{});
+    group_for_material.emplace("", 0);
+    const fs::path obj_path = out_dir / "model.obj";
+    const fs::path mtl_path = out_dir / "model.mtl";
+    obj.open(obj_path);
+    mtl.open(mtl_path);
+    obj.set_precision(options.precision);
+    mtl.set_precision(options.precision);
+    obj << "mtllib model.mtl\n";
+  }
+
+  // 주석으로만 남김 (OBJ에는 원점 개념이 없음). --precision과 상관없이 전체 자릿수로
+  void record_origin(const double origin[3]) override {
+    char line[128];
+    std::snprintf(line, sizeof(line), "# rtc_center %.17g %.17g %.17g\n", origin[0], origin[1], origin[2]);
+    obj << line;
+  }
+
+  bool ok() const { return obj.good() && mtl.good(); }
+
+  // 모아 둔 f를 material별로 기록하고 파일을 닫습니다. 기록 중 오류가 있었으면 false.
+  bool finish() {
+    for (const FaceGroup& g : groups) {
+      if (g.corners.empty()) continue;
+      if (!g.material.empty()) obj << "usemtl " << g.material << "\n";
+      for (size_t i = 0; i + 2 < g.corners.size(); i += 3) {
+        obj << "f";
+        for (size_t k = 0; k < 3; k++) {
+          const auto& c = corners[g.corners[i + k]];
+          obj << " " << c[0] << "/" << c[1] << "/" << c[2];
+        }
+        obj << "\n";
+      }
+    }
+    const bool obj_ok = obj.close();
+    const bool mtl_ok = mtl.close();
+    return obj_ok && mtl_ok;
+  }
+
+  void usemtl(const std::string& name) override {
     if (name.empty()) return;
     if (name == current_usemtl) return;
-    obj << "usemtl " << name << "\n";
     current_usemtl = name;
+    usemtl_runs++;
+    auto it = group_for_material.find(name);
+    if (it == group_for_material.end()) {
+      it = group_for_material.emplace(name, groups.size()).first;
+      groups.push_back(FaceGroup{name, {}});
+    }
+    current_group = it->second;
   }
 
-  void ensure_color_material(const std::string& raw_name, double r, double g, double b) {
+  // 실제로 기록되는 usemtl 수
+  size_t material_groups() const {
+    size_t n = 0;
+    for (const FaceGroup& g : groups) {
+      if (!g.material.empty() && !g.corners.empty()) n++;
+    }
+    return n;
+  }
+
+  void ensure_color_material(const std::string& raw_name, double r, double g, double b) override {
     const std::string name = sanitize_name(raw_name);
     if (written_mtls.count(name)) return;
     written_mtls.insert(name);
@@ -101,49 +518,531 @@ struct ObjWriter {
 
   void ensure_texture_material(
       SUTextureWriterRef texture_writer,
-      long texture_id,
+      const TextureSource& source,
       const std::string& material_name,
-      const std::string& texture_rel_path) {
-    if (!written_mtls.count(material_name)) {
-      written_mtls.insert(material_name);
-      mtl << "newmtl " << material_name << "\n";
-      mtl << "Kd 1 1 1\n";
-      mtl << "Ka 0 0 0\n";
-      mtl << "Ks 0 0 0\n";
-      mtl << "d 1\n";
-      mtl << "illum 2\n";
-      mtl << "map_Kd " << texture_rel_path << "\n\n";
+      const std::string& texture_rel_path) override {
+    if (written_mtls.count(material_name)) return;
+    written_mtls.insert(material_name);
+    const std::string path = write_texture_once(texture_writer, source, material_name, texture_rel_path);
+    mtl << "newmtl " << material_name << "\n";
+    mtl << "Kd 1 1 1\n";
+    mtl << "Ka 0 0 0\n";
+    mtl << "Ks 0 0 0\n";
+    mtl << "d 1\n";
+    mtl << "illum 2\n";
+    mtl << "map_Kd " << path << "\n\n";
+  }
+
+  // 이미 출력된 값이면 기존 인덱스를 재사용 (weld=false면 항상 새로 출력)
+  size_t add_vertex(const SUPoint3D& p, const SUVector3D& n, double u, double v) override {
+    bool inserted = true;
+    const uint32_t vi = weld ? position_pool.insert({p.x, p.y, p.z}, &inserted)
+                             : static_cast<uint32_t>(stats.positions);
+    if (inserted) {
+      obj << "v " << p.x << " " << p.y << " " << p.z << "\n";
+      stats.positions++;
     }
 
-    if (written_textures.count(texture_id)) return;
-    written_textures.insert(texture_id);
+    const uint32_t ti = weld ? texcoord_pool.insert({u, v}, &inserted)
+                             : static_cast<uint32_t>(stats.texcoords);
+    if (inserted) {
+      obj << "vt " << u << " " << v << "\n";
+      stats.texcoords++;
+    }
 
-    const fs::path tex_abs = base_dir / texture_rel_path;
-    fs::create_directories(tex_abs.parent_path());
-    // png로 강제 출력
-    SUTextureWriterWriteTexture(texture_writer, texture_id, tex_abs.string().c_str(), false);
+    const uint32_t ni = weld ? normal_pool.insert({n.x, n.y, n.z}, &inserted)
+                             : static_cast<uint32_t>(stats.normals);
+    if (inserted) {
+      obj << "vn " << n.x << " " << n.y << " " << n.z << "\n";
+      stats.normals++;
+    }
+
+    corners.push_back({vi + 1, ti + 1, ni + 1});  // OBJ is 1-based
+    return corners.size() - 1;
+  }
+
+  void add_triangle(size_t a, size_t b, size_t c) override {
+    groups[current_group].corners.insert(groups[current_group].corners.end(),
+        {static_cast<uint32_t>(a), static_cast<uint32_t>(b), static_cast<uint32_t>(c)});
+    stats.corners += 3;
+  }
+};
+
+// SDK 메시 데이터를 바로 GltfScene에 쌓아 model.glb로 기록 (OBJ → Assimp 왕복 없음)
+// - mesh 0 / node 0: 월드 좌표로 구운 루트 mesh
+// - 추가 mesh는 add_mesh로 만들고 set_active_mesh로 face 출력 대상을 바꿉니다.
+// - mesh 안에서는 material마다 primitive 하나 (정점 수가 max_primitive_vertices를 넘으면 나눔)
+struct GlbWriter : MeshSink {
+  GltfScene scene;
+  std::unordered_map<std::string, int> material_index;
+
+  // glTF 정점은 모든 속성이 인덱스를 공유하므로 (position, normal, uv) 묶음으로 용접.
+  // primitive마다 인덱스 공간이 따로라 풀도 primitive별로 둡니다.
+  bool weld;
+  double weld_epsilon;
+  size_t max_primitive_vertices;
+  bool quantize;
+  bool ktx2;
+  size_t primitive_splits = 0;
+
+  // --ktx2: 순회가 끝난 뒤 KTX2로 인코딩할 텍스처 (scene.images 인덱스)
+  struct Ktx2Texture {
+    long texture_id;  // 0이면 image.uri 파일에서 읽음 (atlas 페이지)
+    int image;
+    bool alpha;
+  };
+  std::vector<Ktx2Texture> ktx2_textures;
+  std::unordered_map<std::string, int> image_for_path;  // 텍스처 경로 → scene.images 인덱스 (내용이 같은 텍스처는 공유)
+
+  struct MeshState {
+    std::unordered_map<int, size_t> primitive_for_material;
+    std::vector<WeldPool<8>> pools;
+    BoundsAccumulator bounds;  // 새로 넣은 정점으로 바로 키우는 culling 볼륨
+  };
+  std::vector<MeshState> mesh_states;  // scene.meshes와 같은 순서
+  int active_mesh = 0;
+  static constexpr size_t kNoPrimitive = static_cast<size_t>(-1);
+  size_t current = kNoPrimitive;  // active mesh의 primitive 인덱스
+  int current_material = -1;      // 마지막 usemtl (mesh를 바꾼 뒤 primitive를 다시 고를 때)
+
+  // --flat-grid: 모델 박스를 정육면체 칸으로 나눠 월드 좌표 face를 칸별 mesh/node(node 0의 자식)로 보냄
+  double grid_origin[3] = {0.0, 0.0, 0.0};
+  double grid_cell = 0.0;  // 0이면 끔
+  int grid_dims[3] = {1, 1, 1};
+  std::unordered_map<int, int> mesh_for_cell;  // 칸 번호 → mesh
+
+  GlbWriter(const fs::path& out_dir, const ExportOptions& options)
+      : weld(options.weld),
+        weld_epsilon(options.weld_epsilon),
+        max_primitive_vertices(options.glb_max_primitive_vertices),
+        quantize(options.quantize),
+        ktx2(options.ktx2) {
+    base_dir = out_dir;
+    keep_original_textures = options.keep_original_textures;
+    track_texture_usage = options.texel_density > 0.0 || options.atlas;
+    smooth_normals = options.smooth_normals;
+    merge_coplanar = options.merge_coplanar;
+    add_mesh("model");
+    scene.roots.push_back(add_node("model", 0));
+  }
+
+  int add_mesh(const std::string& name) {
+    scene.meshes.push_back(GltfMesh{name, {}});
+    mesh_states.emplace_back();
+    return static_cast<int>(scene.meshes.size() - 1);
+  }
+
+  int add_node(const std::string& name, int mesh) {
+    GltfNode node;
+    node.name = name;
+    node.mesh = mesh;
+    scene.nodes.push_back(node);
+    return static_cast<int>(scene.nodes.size() - 1);
+  }
+
+  void set_active_mesh(int mesh) {
+    if (mesh == active_mesh) return;
+    active_mesh = mesh;
+    current = kNoPrimitive;
+  }
+
+  void ensure_color_material(const std::string& raw_name, double r, double g, double b) override {
+    const std::string name = sanitize_name(raw_name);
+    if (material_index.count(name)) return;
+    GltfMaterial m;
+    m.name = name;
+    m.base_color[0] = static_cast<float>(r);
+    m.base_color[1] = static_cast<float>(g);
+    m.base_color[2] = static_cast<float>(b);
+    material_index[name] = static_cast<int>(scene.materials.size());
+    scene.materials.push_back(m);
+  }
+
+  void ensure_texture_material(
+      SUTextureWriterRef texture_writer,
+      const TextureSource& source,
+      const std::string& material_name,
+      const std::string& texture_rel_path) override {
+    if (material_index.count(material_name)) return;
+    const std::string path = write_texture_once(texture_writer, source, material_name, texture_rel_path);
+    auto it = image_for_path.find(path);
+    if (it == image_for_path.end()) {
+      GltfImage img;
+      img.uri = path;
+      img.mime_type = fs::path(path).extension() == ".jpg" ? "image/jpeg" : "image/png";
+      it = image_for_path.emplace(path, static_cast<int>(scene.images.size())).first;
+      if (ktx2) ktx2_textures.push_back(Ktx2Texture{source.id, it->second, source.alpha});
+      scene.images.push_back(img);
+    } else if (ktx2 && source.alpha) {
+      // 내용이 같은 텍스처 중 하나라도 알파를 쓰면 UASTC로
+      for (Ktx2Texture& t : ktx2_textures) {
+        if (t.image == it->second) t.alpha = true;
+      }
+    }
+    GltfMaterial m;
+    m.name = material_name;
+    m.image = it->second;
+    material_index[material_name] = static_cast<int>(scene.materials.size());
+    scene.materials.push_back(m);
+  }
+
+  void usemtl(const std::string& name) override {
+    auto it = material_index.find(name);
+    current_material = it != material_index.end() ? it->second : -1;
+    if (grid_cell > 0.0) {
+      // 칸은 begin_face에서 정해지므로 primitive도 그때 고름 (이전 칸에 빈 primitive를 만들지 않게)
+      current = kNoPrimitive;
+      return;
+    }
+    select_material(current_material);
+  }
+
+  void select_material(int mat) {
+    MeshState& ms = mesh_states[active_mesh];
+    auto pit = ms.primitive_for_material.find(mat);
+    if (pit == ms.primitive_for_material.end()) {
+      pit = ms.primitive_for_material.emplace(mat, open_primitive(mat)).first;
+    }
+    current = pit->second;
+  }
+
+  // face가 들어가면 인덱스 한계를 넘는 경우 같은 material의 primitive를 새로 엽니다.
+  // face 하나는 항상 한 primitive에 들어가야 하므로 face 단위로만 나눕니다.
+  void begin_face(size_t vertex_count, const SUPoint3D* anchor) override {
+    if (anchor && grid_cell > 0.0) {
+      set_active_mesh(grid_mesh(*anchor));
+      if (current == kNoPrimitive) select_material(current_material);
+    }
+    if (current == kNoPrimitive) usemtl("default");
+    const GltfPrimitive& prim = scene.meshes[active_mesh].primitives[current];
+    if (prim.vertex_count() == 0 || prim.vertex_count() + vertex_count <= max_primitive_vertices) return;
+    const int mat = prim.material;
+    current = open_primitive(mat);
+    mesh_states[active_mesh].primitive_for_material[mat] = current;
+    primitive_splits++;
+  }
+
+  bool wants_face_anchor() const override { return grid_cell > 0.0; }
+
+  void record_origin(const double origin[3]) override {
+    scene.has_origin = true;
+    std::copy(origin, origin + 3, scene.origin);
+  }
+
+  // 모델 박스(SketchUp 단위)의 긴 변을 cells칸으로 나눈 정육면체 격자를 켭니다. flat 배치에서만
+  void set_grid(const SUPoint3D& lo, const SUPoint3D& hi, size_t cells) {
+    const double extent[3] = {hi.x - lo.x, hi.y - lo.y, hi.z - lo.z};
+    const double longest = std::max({extent[0], extent[1], extent[2]});
+    if (cells == 0 || !(longest > 0.0)) return;
+    grid_cell = longest / static_cast<double>(cells);
+    grid_origin[0] = lo.x;
+    grid_origin[1] = lo.y;
+    grid_origin[2] = lo.z;
+    for (int k = 0; k < 3; k++) {
+      grid_dims[k] = std::max(1, static_cast<int>(std::ceil(extent[k] / grid_cell)));
+      grid_dims[k] = std::min(grid_dims[k], static_cast<int>(cells));
+    }
   }
 
-  // v/vt/vn를 모두 동일 인덱스로 추가(삼각형마다 유니크 정점으로 단순화)
-  size_t add_vertex(const SUPoint3D& p, const SUVector3D& n, double u, double v) {
-    obj << "v " << p.x << " " << p.y << " " << p.z << "\n";
-    obj << "vt " << u << " " << v << "\n";
-    obj << "vn " << n.x << " " << n.y << " " << n.z << "\n";
-    return next_index++;
+  // anchor가 속한 칸의 mesh (없으면 만들어 node 0 아래에 붙임). 박스 밖 anchor는 가장 가까운 칸으로
+  int grid_mesh(const SUPoint3D& anchor) {
+    const double p[3] = {anchor.x, anchor.y, anchor.z};
+    int cell[3];
+    for (int k = 0; k < 3; k++) {
+      const double c = std::floor((p[k] - grid_origin[k]) / grid_cell);
+      cell[k] = static_cast<int>(std::clamp(c, 0.0, static_cast<double>(grid_dims[k] - 1)));
+    }
+    const int key = (cell[2] * grid_dims[1] + cell[1]) * grid_dims[0] + cell[0];
+    auto it = mesh_for_cell.find(key);
+    if (it != mesh_for_cell.end()) return it->second;
+    const std::string name =
+        "cell_" + std::to_string(cell[0]) + "_" + std::to_string(cell[1]) + "_" + std::to_string(cell[2]);
+    const int mesh = add_mesh(name);
+    scene.nodes[0].children.push_back(add_node(name, mesh));
+    mesh_for_cell.emplace(key, mesh);
+    return mesh;
+  }
+
+  // 모든 node에 culling 볼륨을 채웁니다. 순회 중 모은 mesh 범위를 쓰고, 나중에 만든 mesh는 정점에서 구함
+  void compute_bounds() {
+    std::vector<GltfBounds> streamed(mesh_states.size());
+    for (size_t m = 0; m < mesh_states.size(); m++) streamed[m] = mesh_states[m].bounds.bounds();
+    ComputeNodeBounds(&scene, streamed);
+  }
+
+  // 양자화 uv는 범위가 좁을수록 정밀하므로 face마다 원점 근처로 옮깁니다.
+  bool shift_face_uvs() const override { return quantize; }
+
+  size_t open_primitive(int mat) {
+    auto& prims = scene.meshes[active_mesh].primitives;
+    prims.push_back(GltfPrimitive{});
+    prims.back().material = mat;
+    mesh_states[active_mesh].pools.emplace_back(weld_epsilon);
+    return prims.size() - 1;
+  }
+
+  size_t add_vertex(const SUPoint3D& p, const SUVector3D& n, double u, double v) override {
+    if (current == kNoPrimitive) usemtl("default");
+    GltfPrimitive& prim = scene.meshes[active_mesh].primitives[current];
+    if (weld) {
+      bool inserted = false;
+      const uint32_t index =
+          mesh_states[active_mesh].pools[current].insert({p.x, p.y, p.z, n.x, n.y, n.z, u, v}, &inserted);
+      if (!inserted) return index;
+    }
+    const size_t index = prim.vertex_count();
+    stats.vertices++;
+    prim.positions.insert(prim.positions.end(),
+        {static_cast<float>(p.x), static_cast<float>(p.y), static_cast<float>(p.z)});
+    mesh_states[active_mesh].bounds.add(prim.positions[index * 3], prim.positions[index * 3 + 1],
+                                        prim.positions[index * 3 + 2]);
+    prim.normals.insert(prim.normals.end(),
+        {static_cast<float>(n.x), static_cast<float>(n.y), static_cast<float>(n.z)});
+    prim.texcoords.insert(prim.texcoords.end(),
+        {static_cast<float>(u), static_cast<float>(1.0 - v)});  // glTF UV 원점은 좌상단
+    return index;
+  }
+
+  void add_triangle(size_t a, size_t b, size_t c) override {
+    GltfPrimitive& prim = scene.meshes[active_mesh].primitives[current];
+    prim.indices.insert(prim.indices.end(),
+        {static_cast<uint32_t>(a), static_cast<uint32_t>(b), static_cast<uint32_t>(c)});
+    stats.corners += 3;
+  }
+
+  // 각 mesh에서 merge[material]인 primitive들을 정점 한계(max_primitive_vertices) 안에서 하나로 합칩니다.
+  void merge_primitives(const std::vector<bool>& merge) {
+    for (GltfMesh& mesh : scene.meshes) {
+      std::vector<GltfPrimitive> merged;
+      std::unordered_map<int, size_t> open;  // material → merged 인덱스
+      for (GltfPrimitive& prim : mesh.primitives) {
+        const bool mergeable = prim.material >= 0 && merge[prim.material];
+        auto it = mergeable ? open.find(prim.material) : open.end();
+        if (it != open.end() &&
+            merged[it->second].vertex_count() + prim.vertex_count() <= max_primitive_vertices) {
+          GltfPrimitive& dst = merged[it->second];
+          const uint32_t base = static_cast<uint32_t>(dst.vertex_count());
+          dst.positions.insert(dst.positions.end(), prim.positions.begin(), prim.positions.end());
+          dst.normals.insert(dst.normals.end(), prim.normals.begin(), prim.normals.end());
+          dst.texcoords.insert(dst.texcoords.end(), prim.texcoords.begin(), prim.texcoords.end());
+          for (uint32_t index : prim.indices) dst.indices.push_back(base + index);
+          continue;
+        }
+        if (mergeable) open[prim.material] = merged.size();
+        merged.push_back(std::move(prim));
+      }
+      mesh.primitives = std::move(merged);
+    }
+  }
+
+  // drop_material / drop_image로 표시한 항목을 지우고 남은 인덱스를 당깁니다. (순회가 끝난 뒤에만)
+  void remove_unused(const std::vector<bool>& drop_material, const std::vector<bool>& drop_image) {
+    std::vector<int> image_remap(scene.images.size(), -1);
+    std::vector<GltfImage> images;
+    for (size_t i = 0; i < scene.images.size(); i++) {
+      if (drop_image[i]) continue;
+      image_remap[i] = static_cast<int>(images.size());
+      images.push_back(std::move(scene.images[i]));
+    }
+    scene.images = std::move(images);
+    std::vector<int> material_remap(scene.materials.size(), -1);
+    std::vector<GltfMaterial> materials;
+    for (size_t m = 0; m < scene.materials.size(); m++) {
+      if (drop_material[m]) continue;
+      material_remap[m] = static_cast<int>(materials.size());
+      materials.push_back(std::move(scene.materials[m]));
+      if (materials.back().image >= 0) materials.back().image = image_remap[materials.back().image];
+    }
+    scene.materials = std::move(materials);
+    for (GltfMesh& mesh : scene.meshes) {
+      for (GltfPrimitive& prim : mesh.primitives) {
+        if (prim.material >= 0) prim.material = material_remap[prim.material];
+      }
+    }
+    std::vector<Ktx2Texture> kept;
+    for (Ktx2Texture& t : ktx2_textures) {
+      if (image_remap[t.image] < 0) continue;
+      t.image = image_remap[t.image];
+      kept.push_back(t);
+    }
+    ktx2_textures = std::move(kept);
+    material_index.clear();
+    image_for_path.clear();
+    for (size_t m = 0; m < scene.materials.size(); m++) material_index[scene.materials[m].name] = static_cast<int>(m);
+    for (size_t i = 0; i < scene.images.size(); i++) image_for_path[scene.images[i].uri] = static_cast<int>(i);
+  }
+
+  // --lod: 이보다 작은 mesh는 LOD를 만들지 않음
+  static constexpr size_t kLodMinTriangles = 64;
+  // LOD 1의 최대 오차 (mesh 바운딩 박스 긴 변 대비). 단계마다 두 배
+  static constexpr double kLodMaxError = 0.01;
+  // 화면 높이 기준 이 비율(1080p에서 1px) 이하의 오차면 그 LOD를 써도 된다고 봅니다.
+  static constexpr double kLodPixelError = 1.0 / 1080.0;
+
+  struct LodStats {
+    size_t meshes = 0;                // LOD를 만든 mesh 수
+    std::vector<size_t> triangles;    // 단계별 삼각형 수 합 (0 = 원본, 단계가 모자란 mesh는 마지막 LOD로 셈)
+    double max_error = 0.0;
+    double seconds = 0.0;
+  };
+
+  // 오차가 error(긴 변 대비)인 LOD를 쓸 수 있는 최대 화면 면적 비율 (MSFT_screencoverage)
+  static double LodCoverage(double error) {
+    const double size = error > 0.0 ? kLodPixelError / error : 1.0;  // 화면 높이 대비 mesh 크기
+    return std::min(1.0, size * size);
+  }
+
+  // --lod: mesh마다 삼각형을 단계별로 절반씩 줄인 LOD mesh를 만들고, 그 mesh를 쓰는 node에 MSFT_lod로
+  // 연결합니다. instanced/hierarchy 배치는 definition마다 mesh 하나라 인스턴스 수와 상관없이
+  // definition당 한 번만 단순화합니다. (순회가 끝난 뒤에만)
+  LodStats build_lods(int levels) {
+    LodStats lod_stats;
+    lod_stats.triangles.assign(levels, 0);
+    const auto t0 = std::chrono::steady_clock::now();
+    const size_t mesh_count = scene.meshes.size();
+    std::vector<std::vector<int>> lod_meshes(mesh_count);
+    std::vector<std::vector<double>> lod_coverage(mesh_count);
+    for (size_t m = 0; m < mesh_count; m++) {
+      size_t triangles = 0;
+      for (const GltfPrimitive& p : scene.meshes[m].primitives) triangles += p.indices.size() / 3;
+      lod_stats.triangles[0] += triangles;
+      size_t previous = triangles;
+      int level = 1;
+      for (; level < levels && triangles >= kLodMinTriangles; level++) {
+        SimplifyStats simplify;
+        GltfMesh lod = SimplifyMesh(scene.meshes[m], std::ldexp(1.0, -level),
+                                    kLodMaxError * std::ldexp(1.0, level - 1), &simplify);
+        // 오차 한도 때문에 거의 줄지 않으면 더 낮은 단계도 의미가 없음
+        if (simplify.triangles_after == 0 || simplify.triangles_after * 5 > previous * 4) break;
+        previous = simplify.triangles_after;
+        lod_stats.triangles[level] += previous;
+        lod_stats.max_error = std::max(lod_stats.max_error, simplify.error);
+        lod.name = scene.meshes[m].name + "_lod" + std::to_string(level);
+        lod_meshes[m].push_back(static_cast<int>(scene.meshes.size()));
+        lod_coverage[m].push_back(LodCoverage(simplify.error));
+        scene.meshes.push_back(std::move(lod));
+      }
+      for (; level < levels; level++) lod_stats.triangles[level] += previous;
+      if (!lod_meshes[m].empty()) lod_stats.meshes++;
+    }
+
+    const size_t node_count = scene.nodes.size();
+    for (size_t i = 0; i < node_count; i++) {
+      const int m = scene.nodes[i].mesh;
+      if (m < 0 || static_cast<size_t>(m) >= mesh_count || lod_meshes[m].empty()) continue;
+      size_t target = i;
+      if (!scene.nodes[i].children.empty()) {
+        // MSFT_lod는 자식까지 통째로 바꾸므로 mesh를 새 자식 node로 옮김
+        GltfNode child;
+        child.name = scene.nodes[i].name.empty() ? std::string() : scene.nodes[i].name + "_mesh";
+        child.mesh = m;
+        child.instances = std::move(scene.nodes[i].instances);
+        scene.nodes[i].mesh = -1;
+        scene.nodes[i].instances.clear();
+        scene.nodes[i].children.push_back(static_cast<int>(scene.nodes.size()));
+        scene.nodes.push_back(std::move(child));
+        target = scene.nodes.size() - 1;
+      }
+      for (size_t k = 0; k < lod_meshes[m].size(); k++) {
+        GltfNode lod = scene.nodes[target];
+        lod.lods.clear();
+        if (!lod.name.empty()) lod.name += "_lod" + std::to_string(k + 1);
+        lod.mesh = lod_meshes[m][k];
+        scene.nodes[target].lods.push_back(static_cast<int>(scene.nodes.size()));
+        scene.nodes.push_back(std::move(lod));
+      }
+      // LOD k의 최소 비율은 LOD k+1로 바꿔도 되는 크기. 마지막 LOD는 항상 그림 (0)
+      std::vector<double>& coverage = scene.nodes[target].lod_coverage;
+      for (double c : lod_coverage[m]) coverage.push_back(coverage.empty() ? c : std::min(coverage.back(), c));
+      coverage.push_back(0.0);
+    }
+    lod_stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return lod_stats;
+  }
+
+  // --progressive: 그려지는 모든 mesh를 세계 좌표 proxy 하나로 줄여 두 번째 scene으로 둡니다.
+  // (mesh 최적화 전, 순회가 끝난 뒤에만)
+  ProxyStats build_proxy(size_t target_triangles) {
+    ProxyStats proxy_stats;
+    GltfMesh proxy = BuildSceneProxy(scene, target_triangles, max_primitive_vertices, &proxy_stats);
+    if (proxy.primitives.empty()) return proxy_stats;
+    const int mesh = add_mesh(proxy.name);
+    scene.meshes[mesh].primitives = std::move(proxy.primitives);
+    scene.proxy_roots.push_back(add_node("proxy", mesh));
+    return proxy_stats;
+  }
+
+  bool write(const GlbWriteOptions& options, GlbWriteStats* stats, std::string* error) const {
+    return WriteGlb(scene, base_dir / "model.glb", options, stats, error);
   }
 
-  void add_triangle(size_t a, size_t b, size_t c) {
-    obj << "f " << a << "/" << a << "/" << a
-        << " " << b << "/" << b << "/" << b
-        << " " << c << "/" << c << "/" << c << "\n";
+  // --tiles: model.glb 대신 base_dir/tileset.json + base_dir/tiles/*.glb
+  bool write_tiles(const TilesetOptions& options, TilesetStats* stats, std::string* error) const {
+    return WriteTileset(scene, base_dir, options, stats, error);
   }
 };
 
+// --glb-layout instanced: component definition마다 mesh 하나 + 인스턴스 TRS 목록
+struct InstancingState {
+  struct Definition {
+    int mesh = -1;
+    int node = -1;
+  };
+  std::unordered_map<void*, Definition> definitions;  // key: SUComponentDefinitionRef.ptr
+  size_t instances = 0;
+  size_t baked = 0;  // TRS로 표현할 수 없어(shear 등) 루트 mesh에 구운 인스턴스
+};
+
+// --glb-layout hierarchy: SketchUp 계층을 node 트리로 유지
+struct HierarchyState {
+  std::unordered_map<void*, int> mesh_for_definition;  // key: SUComponentDefinitionRef.ptr (루트는 nullptr)
+  size_t nodes = 0;
+};
+
+// --smooth-normals: face 하나에서 다른 face와 부드럽게 이어진 꼭짓점.
+// 로컬 위치를 양자화한 키(positions의 인덱스)로 평균 normal을 찾습니다.
+struct FaceSmoothing {
+  static constexpr double kPositionEpsilon = 1e-6;
+  WeldPool<3> positions{kPositionEpsilon};
+  std::vector<SUVector3D> normals;
+};
+using SmoothingMap = std::unordered_map<void*, FaceSmoothing>;  // key: SUFaceRef.ptr
+
+// definition별 로컬 테셀레이션 캐시.
+// flat 출력에서 같은 definition의 인스턴스마다 SUMeshHelper/material/SUTextureWriterLoadFace를
+// 반복 호출하지 않고, 첫 인스턴스에서 만든 FaceMesh를 변환만 해서 다시 출력합니다.
+struct TessellationCache {
+  std::unordered_set<void*> eligible;  // 사전 패스에서 고른 definition (SUComponentDefinitionRef.ptr)
+  std::unordered_map<void*, std::vector<FaceMesh>> entries;
+  size_t faces_tessellated = 0;  // 캐시에 넣으려고 테셀레이션한 face
+  size_t faces_replayed = 0;     // 캐시에서 다시 출력한 face (SDK 호출 생략)
+};
+
 static SUResult ExportEntitiesOBJ(
     SUEntitiesRef entities,
     const SUTransformation* parent_xf,
+    SUComponentDefinitionRef owner_def,
+    SUTextureWriterRef texture_writer,
+    MeshSink& out,
+    TessellationCache* cache);
+
+static SUResult ExportEntitiesInstanced(
+    SUEntitiesRef entities,
+    int owner_mesh,
+    const SUTransformation* xf_in_owner,
+    const SUTransformation* world_xf,
+    SUTextureWriterRef texture_writer,
+    GlbWriter& out,
+    InstancingState& state);
+
+static SUResult ExportEntitiesHierarchy(
+    SUEntitiesRef entities,
+    SUComponentDefinitionRef owner_def,
+    int node,
+    const SUTransformation* xf,
     SUTextureWriterRef texture_writer,
-    ObjWriter& out);
+    GlbWriter& out,
+    HierarchyState& state);
 
 // SUString -> std::string (UTF-8)
 static std::string SUStringToUTF8(SUStringRef s) {
@@ -157,11 +1056,146 @@ static std::string SUStringToUTF8(SUStringRef s) {
   return out;
 }
 
-static SUResult ExportFaceOBJ(
+// face의 front/back material 텍스처. type에는 material 종류를 채웁니다. (없으면 SU_INVALID)
+static SUTextureRef FaceMaterialTexture(SUFaceRef face, bool back, SUMaterialType* type) {
+  *type = SUMaterialType_Colored;
+  SUMaterialRef mat = SU_INVALID;
+  const SUResult got = back ? SUFaceGetBackMaterial(face, &mat) : SUFaceGetFrontMaterial(face, &mat);
+  SUTextureRef tex = SU_INVALID;
+  if (got != SU_ERROR_NONE || SUIsInvalid(mat)) return tex;
+  SUMaterialGetType(mat, type);
+  SUMaterialGetTexture(mat, &tex);
+  return tex;
+}
+
+// 텍스처를 원본 파일 그대로 내보낼 수 있으면 확장자(".jpg" / ".png")를, 아니면 빈 문자열을 돌려줍니다.
+// colorize된 material은 색을 입힌 이미지가, affine이 아닌(왜곡/투영) 텍스처는 펼친 이미지가 필요하므로
+// texture writer로 다시 인코딩해야 합니다. glTF/브라우저가 바로 읽지 못하는 형식(bmp/tif 등)도 마찬가지입니다.
+static std::string OriginalTextureExtension(
+    SUTextureRef tex, SUMaterialType type, SUTextureWriterRef texture_writer, long texture_id) {
+  if (SUIsInvalid(tex) || type != SUMaterialType_Textured) return {};
+  bool affine = false;
+  if (SUTextureWriterIsTextureAffine(texture_writer, texture_id, &affine) != SU_ERROR_NONE || !affine) return {};
+
+  SUStringRef su_name = SU_INVALID;
+  SUStringCreate(&su_name);
+  std::string file_name;
+  if (SUTextureGetFileName(tex, &su_name) == SU_ERROR_NONE) file_name = SUStringToUTF8(su_name);
+  SUStringRelease(&su_name);
+
+  std::string ext = fs::path(file_name).extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+  if (ext == ".jpeg") ext = ".jpg";
+  if (ext != ".jpg" && ext != ".png") return {};
+  return ext;
+}
+
+// 같은 entities의 face들에서 soft/smooth edge를 모아 smoothing group을 만들고 (smoothing_groups.h),
+// 평균 normal을 받은 꼭짓점이 있는 face만 map에 넣습니다.
+static void BuildSmoothing(const std::vector<SUFaceRef>& faces, SmoothingMap* map, SmoothingStats* stats) {
+  std::unordered_map<void*, int> face_index;
+  for (size_t f = 0; f < faces.size(); f++) face_index.emplace(faces[f].ptr, static_cast<int>(f));
+  std::unordered_map<void*, int> vertex_index;
+  std::vector<SUPoint3D> vertex_positions;
+  auto vertex_id = [&](SUVertexRef v) {
+    auto it = vertex_index.find(v.ptr);
+    if (it != vertex_index.end()) return it->second;
+    SUPoint3D p{0.0, 0.0, 0.0};
+    SUVertexGetPosition(v, &p);
+    vertex_positions.push_back(p);
+    return vertex_index.emplace(v.ptr, static_cast<int>(vertex_positions.size() - 1)).first->second;
+  };
+
+  std::vector<SmoothingFace> sfaces(faces.size());
+  std::vector<SmoothingEdge> edges;
+  std::unordered_set<void*> seen_edges;
+  for (size_t f = 0; f < faces.size(); f++) {
+    SUVector3D n{0.0, 0.0, 1.0};
+    SUFaceGetNormal(faces[f], &n);
+    Normalize(&n);
+    sfaces[f].normal[0] = n.x;
+    sfaces[f].normal[1] = n.y;
+    sfaces[f].normal[2] = n.z;
+
+    size_t count = 0;
+    SUFaceGetNumVertices(faces[f], &count);
+    std::vector<SUVertexRef> vertices(count);
+    size_t got = 0;
+    if (count > 0) SUFaceGetVertices(faces[f], count, vertices.data(), &got);
+    for (size_t i = 0; i < got; i++) sfaces[f].vertices.push_back(vertex_id(vertices[i]));
+
+    count = 0;
+    SUFaceGetNumEdges(faces[f], &count);
+    std::vector<SUEdgeRef> face_edges(count);
+    got = 0;
+    if (count > 0) SUFaceGetEdges(faces[f], count, face_edges.data(), &got);
+    for (size_t i = 0; i < got; i++) {
+      const SUEdgeRef edge = face_edges[i];
+      if (!seen_edges.insert(edge.ptr).second) continue;
+      bool soft = false;
+      bool smooth = false;
+      SUEdgeGetSoft(edge, &soft);
+      SUEdgeGetSmooth(edge, &smooth);
+      if (!soft && !smooth) continue;
+      size_t face_count = 0;
+      SUEdgeGetNumFaces(edge, &face_count);
+      if (face_count < 2) continue;
+      std::vector<SUFaceRef> edge_faces(face_count);
+      size_t got_faces = 0;
+      SUEdgeGetFaces(edge, face_count, edge_faces.data(), &got_faces);
+      SmoothingEdge e;
+      for (size_t k = 0; k < got_faces; k++) {
+        auto it = face_index.find(edge_faces[k].ptr);
+        if (it == face_index.end()) continue;
+        bool reversed = false;
+        SUEdgeReversedInFace(edge, edge_faces[k], &reversed);
+        e.faces.push_back(it->second);
+        e.reversed.push_back(reversed);
+      }
+      if (e.faces.size() < 2) continue;
+      SUVertexRef start = SU_INVALID;
+      SUVertexRef end = SU_INVALID;
+      SUEdgeGetStartVertex(edge, &start);
+      SUEdgeGetEndVertex(edge, &end);
+      e.v0 = vertex_id(start);
+      e.v1 = vertex_id(end);
+      edges.push_back(std::move(e));
+    }
+  }
+  if (edges.empty()) return;
+
+  const std::vector<std::vector<SmoothCorner>> corners = BuildSmoothingGroups(sfaces, edges, stats);
+  for (size_t f = 0; f < faces.size(); f++) {
+    if (corners[f].empty()) continue;
+    FaceSmoothing& fs = (*map)[faces[f].ptr];
+    for (const SmoothCorner& c : corners[f]) {
+      const SUPoint3D& p = vertex_positions[sfaces[f].vertices[c.corner]];
+      bool inserted = false;
+      fs.positions.insert({p.x, p.y, p.z}, &inserted);
+      if (inserted) fs.normals.push_back(SUVector3D{c.normal[0], c.normal[1], c.normal[2]});
+    }
+  }
+}
+
+static const FaceSmoothing* FindSmoothing(const SmoothingMap& map, SUFaceRef face) {
+  auto it = map.find(face.ptr);
+  return it != map.end() ? &it->second : nullptr;
+}
+
+// face를 로컬 좌표로 테셀레이션해 FaceMesh에 채웁니다.
+// material/texture는 이 단계에서 결정되어 out에 등록(ensure_*)되고 이름만 FaceMesh에 남습니다.
+// smoothing이 있으면 그 꼭짓점과 같은 위치의 정점은 평균 normal을 씁니다.
+static SUResult TessellateFace(
     SUFaceRef face,
-    const SUTransformation* xf,
     SUTextureWriterRef texture_writer,
-    ObjWriter& out) {
+    MeshSink& out,
+    FaceMesh* fm,
+    const FaceSmoothing* smoothing = nullptr) {
+  fm->positions.clear();
+  fm->normals.clear();
+  fm->texcoords.clear();
+  fm->indices.clear();
+
   // material/texture 결정 (front 기준)
   std::string mtl_name = "default";
   out.ensure_color_material("default", 0.8, 0.8, 0.8);
@@ -172,7 +1206,7 @@ static SUResult ExportFaceOBJ(
     SUStringCreate(&su_name);
     if (SUMaterialGetNameLegacyBehavior(front_mat, &su_name) == SU_ERROR_NONE) {
       const std::string raw = SUStringToUTF8(su_name);
-      if (!raw.empty()) mtl_name = ObjWriter::sanitize_name(raw);
+      if (!raw.empty()) mtl_name = MeshSink::sanitize_name(raw);
     }
     SUStringRelease(&su_name);
 
@@ -190,7 +1224,7 @@ static SUResult ExportFaceOBJ(
       SUStringCreate(&su_name);
       if (SUMaterialGetNameLegacyBehavior(back_mat, &su_name) == SU_ERROR_NONE) {
         const std::string raw = SUStringToUTF8(su_name);
-        if (!raw.empty()) mtl_name = ObjWriter::sanitize_name(raw);
+        if (!raw.empty()) mtl_name = MeshSink::sanitize_name(raw);
       }
       SUStringRelease(&su_name);
 
@@ -210,12 +1244,23 @@ static SUResult ExportFaceOBJ(
     const long chosen_tex_id = front_tex_id != 0 ? front_tex_id : back_tex_id;
     use_back_texture = (front_tex_id == 0 && back_tex_id != 0);
     const std::string tex_mtl = std::string("tex_") + std::to_string(chosen_tex_id);
-    const std::string tex_rel = std::string("model/") + tex_mtl + ".png";
-    out.ensure_texture_material(texture_writer, chosen_tex_id, tex_mtl, tex_rel);
+    TextureSource source;
+    source.id = chosen_tex_id;
+    SUMaterialType type = SUMaterialType_Colored;
+    const SUTextureRef texture = FaceMaterialTexture(face, use_back_texture, &type);
+    if (!SUIsInvalid(texture)) SUTextureGetUseAlphaChannel(texture, &source.alpha);
+    std::string ext;
+    if (out.keep_original_textures) {
+      ext = OriginalTextureExtension(texture, type, texture_writer, chosen_tex_id);
+      if (!ext.empty()) source.original = texture;
+    }
+    if (ext.empty()) ext = ".png";
+    const std::string tex_rel = std::string("model/") + tex_mtl + ext;
+    out.ensure_texture_material(texture_writer, source, tex_mtl, tex_rel);
     mtl_name = tex_mtl;
   }
 
-  out.usemtl(mtl_name);
+  fm->material = mtl_name;
 
   SUMeshHelperRef mesh = SU_INVALID;
   SUResult res = SUMeshHelperCreateWithTextureWriter(&mesh, face, texture_writer);
@@ -239,17 +1284,23 @@ static SUResult ExportFaceOBJ(
     for (size_t i = 0; i < num_vertices; i++) normals[i] = SUVector3D{0, 0, 1};
     got_normals = num_vertices;
   }
+  if (smoothing) {
+    // 테셀레이션 정점은 face 꼭짓점 위치 그대로 나오므로 위치 키로 찾음
+    for (size_t vi = 0; vi < num_vertices; vi++) {
+      uint32_t k = 0;
+      if (smoothing->positions.find({vertices[vi].x, vertices[vi].y, vertices[vi].z}, &k)) {
+        normals[vi] = smoothing->normals[k];
+      }
+    }
+  }
 
-  std::vector<SUPoint3D> front_stq(num_vertices);
-  std::vector<SUPoint3D> back_stq(num_vertices);
+  // 쓰는 면의 STQ만 받음 (double 버퍼 하나)
+  std::vector<SUPoint3D> stq_coords(num_vertices);
   size_t got_stq = 0;
-  const bool has_stq =
-      (SUMeshHelperGetFrontSTQCoords(mesh, num_vertices, front_stq.data(), &got_stq) == SU_ERROR_NONE) &&
-      (got_stq == num_vertices);
-  size_t got_back_stq = 0;
-  const bool has_back_stq =
-      (SUMeshHelperGetBackSTQCoords(mesh, num_vertices, back_stq.data(), &got_back_stq) == SU_ERROR_NONE) &&
-      (got_back_stq == num_vertices);
+  const SUResult stq_res =
+      use_back_texture ? SUMeshHelperGetBackSTQCoords(mesh, num_vertices, stq_coords.data(), &got_stq)
+                       : SUMeshHelperGetFrontSTQCoords(mesh, num_vertices, stq_coords.data(), &got_stq);
+  const bool can_use_stq = stq_res == SU_ERROR_NONE && got_stq == num_vertices;
 
   size_t num_triangles = 0;
   SUMeshHelperGetNumTriangles(mesh, &num_triangles);
@@ -267,104 +1318,1038 @@ static SUResult ExportFaceOBJ(
     return SU_ERROR_GENERIC;
   }
 
-  // 삼각형 출력: 각 tri vertex를 유니크 정점으로 써서 OBJ 단순화
-  for (size_t t = 0; t < num_triangles; t++) {
-    size_t tri_idx[3];
-    for (int k = 0; k < 3; k++) {
-      const size_t vi = indices[t * 3 + k];
-      SUPoint3D p = vertices[vi];
-      SUPoint3DTransform(xf, &p);
-
-      SUVector3D n = normals[vi];
-      SUVector3DTransform(xf, &n);
-      Normalize(&n);
-
-      double u = 0.0;
-      double v = 0.0;
-      const bool can_use_stq = (!use_back_texture && has_stq) || (use_back_texture && has_back_stq);
-      if (can_use_stq) {
-        const SUPoint3D stq = use_back_texture ? back_stq[vi] : front_stq[vi];
-        const double q = (stq.z == 0.0 ? 1.0 : stq.z);
-        u = stq.x / q;
-        v = stq.y / q;
-      }
+  // 로컬 좌표 → float 버퍼 (첫 정점을 기준점으로)
+  fm->origin[0] = vertices[0].x;
+  fm->origin[1] = vertices[0].y;
+  fm->origin[2] = vertices[0].z;
+  fm->positions.reserve(num_vertices * 3);
+  fm->normals.reserve(num_vertices * 3);
+  fm->texcoords.reserve(num_vertices * 2);
+  for (size_t vi = 0; vi < num_vertices; vi++) {
+    fm->positions.insert(fm->positions.end(), {
+        static_cast<float>(vertices[vi].x - fm->origin[0]),
+        static_cast<float>(vertices[vi].y - fm->origin[1]),
+        static_cast<float>(vertices[vi].z - fm->origin[2])});
+    fm->normals.insert(fm->normals.end(), {
+        static_cast<float>(normals[vi].x), static_cast<float>(normals[vi].y), static_cast<float>(normals[vi].z)});
+    double u = 0.0;
+    double v = 0.0;
+    if (can_use_stq) {
+      const SUPoint3D& stq = stq_coords[vi];
+      const double q = (stq.z == 0.0 ? 1.0 : stq.z);
+      u = stq.x / q;
+      v = stq.y / q;
+    }
+    fm->texcoords.insert(fm->texcoords.end(), {static_cast<float>(u), static_cast<float>(v)});
+  }
 
-      tri_idx[k] = out.add_vertex(p, n, u, v);
+  fm->indices.reserve(num_indices);
+  for (size_t i = 0; i < num_indices; i++) {
+    if (indices[i] >= num_vertices) {
+      SUMeshHelperRelease(&mesh);
+      return SU_ERROR_GENERIC;
     }
-    out.add_triangle(tri_idx[0], tri_idx[1], tri_idx[2]);
+    fm->indices.push_back(static_cast<uint32_t>(indices[i]));
   }
 
   SUMeshHelperRelease(&mesh);
   return SU_ERROR_NONE;
 }
 
-static void usage() {
-  std::cerr
-      << "sketchup-csdk-converter --input <file.skp> --outputDir <dir> --format <obj|dae>\n"
-      << "\n"
-      << "Output contract:\n"
-      << "  format=obj => <outputDir>/model.obj, <outputDir>/model.mtl, (optional) <outputDir>/model/* textures\n"
-      << "  format=dae => <outputDir>/model.dae, (optional) <outputDir>/model/* textures\n";
-}
-
-int main(int argc, char** argv) {
-  std::string input;
-  std::string outputDir;
-  std::string format = "obj";
+// 로컬 FaceMesh를 xf로 변환해 out에 출력합니다.
+// face 안에서 공유된 정점은 한 번만 변환/출력하고, face 사이의 중복은 sink의 용접 단계에서 합쳐집니다.
+static void EmitFaceMesh(const FaceMesh& fm, const SUTransformation* xf, MeshSink& out) {
+  if (fm.indices.empty()) return;
+  out.usemtl(fm.material);
 
-  // 지원 1) positional: <input> <outputDir> [format]
-  // - 서버 기본 args 규약(["{input}","{output}","{format}"])과 호환
-  if (argc >= 3 && argv[1][0] != '-' && argv[2][0] != '-') {
-    input = argv[1];
-    outputDir = argv[2];
-    if (argc >= 4 && argv[3][0] != '-') format = argv[3];
+  const size_t num_vertices = fm.vertex_count();
+  if (out.wants_face_anchor() && num_vertices > 0) {
+    // 로컬 박스 중심을 옮기면 (affine이라) 옮긴 face 박스의 중심
+    float lo[3] = {fm.positions[0], fm.positions[1], fm.positions[2]};
+    float hi[3] = {lo[0], lo[1], lo[2]};
+    for (size_t vi = 1; vi < num_vertices; vi++) {
+      for (int c = 0; c < 3; c++) {
+        lo[c] = std::min(lo[c], fm.positions[vi * 3 + c]);
+        hi[c] = std::max(hi[c], fm.positions[vi * 3 + c]);
+      }
+    }
+    SUPoint3D anchor{fm.origin[0] + (static_cast<double>(lo[0]) + hi[0]) * 0.5,
+                     fm.origin[1] + (static_cast<double>(lo[1]) + hi[1]) * 0.5,
+                     fm.origin[2] + (static_cast<double>(lo[2]) + hi[2]) * 0.5};
+    SUPoint3DTransform(xf, &anchor);
+    out.begin_face(num_vertices, &anchor);
   } else {
-    // 지원 2) flags: --input/--outputDir/--format
-    for (int i = 1; i < argc; i++) {
-      std::string a = argv[i];
-      if ((a == "--input" || a == "-i") && i + 1 < argc) {
-        input = argv[++i];
-      } else if ((a == "--outputDir" || a == "-o") && i + 1 < argc) {
-        outputDir = argv[++i];
-      } else if ((a == "--format" || a == "-f") && i + 1 < argc) {
-        format = argv[++i];
-      } else if (a == "--help" || a == "-h") {
-        usage();
-        return 0;
-      } else {
-        std::cerr << "Unknown argument: " << a << "\n";
-        usage();
-        return 2;
+    out.begin_face(num_vertices, nullptr);
+  }
+  // face uv 중심을 [0, 1) 안으로 옮기는 정수 이동량
+  double du = 0.0;
+  double dv = 0.0;
+  if (out.shift_face_uvs() && num_vertices > 0) {
+    float lo[2] = {fm.texcoords[0], fm.texcoords[1]};
+    float hi[2] = {lo[0], lo[1]};
+    for (size_t vi = 1; vi < num_vertices; vi++) {
+      for (int c = 0; c < 2; c++) {
+        lo[c] = std::min(lo[c], fm.texcoords[vi * 2 + c]);
+        hi[c] = std::max(hi[c], fm.texcoords[vi * 2 + c]);
       }
     }
+    du = std::floor((static_cast<double>(lo[0]) + hi[0]) * 0.5);
+    dv = std::floor((static_cast<double>(lo[1]) + hi[1]) * 0.5);
   }
+  // 변환된 위치로 면적을 재므로 캐시에서 다시 출력하는 face도 인스턴스 스케일이 반영됩니다.
+  const bool track = out.track_texture_usage && fm.material.rfind("tex_", 0) == 0;
+  // 면적용 변환 위치는 첫 정점 기준 float (큰 좌표에서도 차이는 정확)
+  std::vector<float> world;
+  SUPoint3D world_base{0.0, 0.0, 0.0};
+  if (track) world.resize(num_vertices * 3);
+  std::vector<size_t> sink_index(num_vertices);
+  for (size_t vi = 0; vi < num_vertices; vi++) {
+    SUPoint3D p{fm.origin[0] + fm.positions[vi * 3 + 0],
+                fm.origin[1] + fm.positions[vi * 3 + 1],
+                fm.origin[2] + fm.positions[vi * 3 + 2]};
+    SUPoint3DTransform(xf, &p);
+    if (track) {
+      if (vi == 0) world_base = p;
+      world[vi * 3 + 0] = static_cast<float>(p.x - world_base.x);
+      world[vi * 3 + 1] = static_cast<float>(p.y - world_base.y);
+      world[vi * 3 + 2] = static_cast<float>(p.z - world_base.z);
+    }
 
-  if (input.empty() || outputDir.empty()) {
-    usage();
-    return 2;
-  }
-  if (!(format == "obj" || format == "dae")) {
-    std::cerr << "Invalid --format: " << format << " (expected obj|dae)\n";
-    return 2;
-  }
+    SUVector3D n{fm.normals[vi * 3 + 0], fm.normals[vi * 3 + 1], fm.normals[vi * 3 + 2]};
+    SUVector3DTransform(xf, &n);
+    Normalize(&n);
 
-  if (format == "dae") {
-    std::cerr << "DAE export is not implemented yet. Use --format obj for now.\n";
-    return 2;
+    sink_index[vi] = out.add_vertex(p, n, fm.texcoords[vi * 2 + 0] - du, fm.texcoords[vi * 2 + 1] - dv);
   }
 
-  fs::path out_dir(outputDir);
-  fs::create_directories(out_dir);
-  // 텍스처 폴더 규약(선택): outputDir/model/*
-  fs::create_directories(out_dir / "model");
+  for (size_t t = 0; t + 2 < fm.indices.size(); t += 3) {
+    out.add_triangle(sink_index[fm.indices[t]], sink_index[fm.indices[t + 1]], sink_index[fm.indices[t + 2]]);
+  }
 
-  ObjWriter writer(out_dir);
-  if (!writer.ok()) {
-    std::cerr << "Failed to open output files in: " << outputDir << "\n";
-    return 1;
+  if (track) {
+    double world_area = 0.0;
+    double uv_area = 0.0;
+    for (size_t t = 0; t + 2 < fm.indices.size(); t += 3) {
+      const uint32_t a = fm.indices[t];
+      const uint32_t b = fm.indices[t + 1];
+      const uint32_t c = fm.indices[t + 2];
+      const float* wa = &world[a * 3];
+      const float* wb = &world[b * 3];
+      const float* wc = &world[c * 3];
+      const double e1[3] = {static_cast<double>(wb[0]) - wa[0], static_cast<double>(wb[1]) - wa[1],
+                            static_cast<double>(wb[2]) - wa[2]};
+      const double e2[3] = {static_cast<double>(wc[0]) - wa[0], static_cast<double>(wc[1]) - wa[1],
+                            static_cast<double>(wc[2]) - wa[2]};
+      const double cx = e1[1] * e2[2] - e1[2] * e2[1];
+      const double cy = e1[2] * e2[0] - e1[0] * e2[2];
+      const double cz = e1[0] * e2[1] - e1[1] * e2[0];
+      world_area += 0.5 * std::sqrt(cx * cx + cy * cy + cz * cz);
+      const float* ta = &fm.texcoords[a * 2];
+      const float* tb = &fm.texcoords[b * 2];
+      const float* tc = &fm.texcoords[c * 2];
+      uv_area += 0.5 * std::fabs(static_cast<double>(tb[0] - ta[0]) * (tc[1] - ta[1]) -
+                                 static_cast<double>(tb[1] - ta[1]) * (tc[0] - ta[0]));
+    }
+    float uv_min[2] = {FLT_MAX, FLT_MAX};
+    float uv_max[2] = {-FLT_MAX, -FLT_MAX};
+    for (size_t vi = 0; vi < num_vertices; vi++) {
+      for (int c = 0; c < 2; c++) {
+        uv_min[c] = std::min(uv_min[c], fm.texcoords[vi * 2 + c]);
+        uv_max[c] = std::max(uv_max[c], fm.texcoords[vi * 2 + c]);
+      }
+    }
+    out.add_texture_usage(fm.material, world_area, uv_area, uv_min, uv_max);
   }
+}
 
-  // SDK init (headless)
+// --merge-coplanar: 테셀레이션한 face들 중 합칠 수 있는 동일 평면 face를 다각형 하나로 합칩니다 (coplanar_merge.h).
+// 합친 묶음은 FaceMesh 하나가 되어 첫 face 자리에 남고 나머지는 meshes에서 빠집니다.
+// 앞/뒷면 material과 출력 material 이름이 모두 같은 face만 같은 material 번호를 받아 서로 합쳐집니다.
+static void MergeCoplanar(const std::vector<SUFaceRef>& faces, std::vector<FaceMesh>* meshes, MeshSink& out) {
+  std::unordered_map<void*, int> vertex_index;
+  std::vector<double> positions;
+  auto vertex_id = [&](SUVertexRef v) {
+    auto it = vertex_index.find(v.ptr);
+    if (it != vertex_index.end()) return it->second;
+    SUPoint3D p{0.0, 0.0, 0.0};
+    SUVertexGetPosition(v, &p);
+    positions.insert(positions.end(), {p.x, p.y, p.z});
+    return vertex_index.emplace(v.ptr, static_cast<int>(positions.size() / 3 - 1)).first->second;
+  };
+  std::map<std::tuple<std::string, void*, void*>, int> material_index;
+  std::vector<CoplanarFace> cfaces(faces.size());
+  // face 꼭짓점(loops 순서) → 그 face FaceMesh의 정점
+  std::vector<std::vector<uint32_t>> corner_vertex(faces.size());
+  for (size_t f = 0; f < faces.size(); f++) {
+    const FaceMesh& fm = (*meshes)[f];
+    out.coplanar_triangles_before += fm.triangle_count();
+    if (fm.indices.empty()) continue;
+    CoplanarFace& cf = cfaces[f];
+    SUVector3D n{0.0, 0.0, 1.0};
+    SUFaceGetNormal(faces[f], &n);
+    Normalize(&n);
+    cf.normal[0] = n.x;
+    cf.normal[1] = n.y;
+    cf.normal[2] = n.z;
+
+    SULoopRef outer = SU_INVALID;
+    if (SUFaceGetOuterLoop(faces[f], &outer) != SU_ERROR_NONE) continue;
+    std::vector<SULoopRef> loops(1, outer);
+    size_t inner_count = 0;
+    SUFaceGetNumInnerLoops(faces[f], &inner_count);
+    if (inner_count > 0) {
+      loops.resize(1 + inner_count);
+      size_t got = 0;
+      SUFaceGetInnerLoops(faces[f], inner_count, loops.data() + 1, &got);
+      loops.resize(1 + got);
+    }
+    bool matched = true;
+    for (SULoopRef loop : loops) {
+      size_t count = 0;
+      SULoopGetNumVertices(loop, &count);
+      std::vector<SUVertexRef> vertices(count);
+      size_t got = 0;
+      if (count > 0) SULoopGetVertices(loop, count, vertices.data(), &got);
+      cf.loops.emplace_back();
+      for (size_t i = 0; i < got && matched; i++) {
+        const int id = vertex_id(vertices[i]);
+        cf.loops.back().push_back(id);
+        // 테셀레이션 정점은 loop 꼭짓점 위치 그대로 나오므로 위치로 찾음 (FaceMesh는 origin 기준 float)
+        const double local[3] = {positions[id * 3] - fm.origin[0], positions[id * 3 + 1] - fm.origin[1],
+                                 positions[id * 3 + 2] - fm.origin[2]};
+        const double tolerance = 1e-6 * (1.0 + std::fabs(local[0]) + std::fabs(local[1]) + std::fabs(local[2]));
+        size_t vi = 0;
+        for (; vi < fm.vertex_count(); vi++) {
+          const float* q = &fm.positions[vi * 3];
+          if (std::fabs(q[0] - local[0]) <= tolerance && std::fabs(q[1] - local[1]) <= tolerance &&
+              std::fabs(q[2] - local[2]) <= tolerance) {
+            break;
+          }
+        }
+        if (vi == fm.vertex_count()) {
+          matched = false;
+          break;
+        }
+        corner_vertex[f].push_back(static_cast<uint32_t>(vi));
+        cf.texcoords.insert(cf.texcoords.end(), {fm.texcoords[vi * 2], fm.texcoords[vi * 2 + 1]});
+      }
+    }
+    if (!matched) continue;  // material -1: 합치지 않음
+
+    SUMaterialRef front = SU_INVALID;
+    SUMaterialRef back = SU_INVALID;
+    SUFaceGetFrontMaterial(faces[f], &front);
+    SUFaceGetBackMaterial(faces[f], &back);
+    const auto key = std::make_tuple(fm.material, front.ptr, back.ptr);
+    cf.material = material_index.emplace(key, static_cast<int>(material_index.size())).first->second;
+  }
+
+  const std::vector<CoplanarGroup> groups = MergeCoplanarFaces(cfaces, positions, &out.coplanar);
+  for (const CoplanarGroup& group : groups) {
+    // 정점 id → normal/uv를 가져올 (face, FaceMesh 정점). 같은 묶음이면 uv 매핑이 같으므로 어느 face든 됨
+    std::unordered_map<int, std::pair<int, uint32_t>> source;
+    for (int f : group.faces) {
+      size_t corner = 0;
+      for (const std::vector<int>& loop : cfaces[f].loops) {
+        for (int id : loop) source.emplace(id, std::make_pair(f, corner_vertex[f][corner++]));
+      }
+    }
+    FaceMesh merged;
+    merged.material = (*meshes)[group.faces[0]].material;
+    std::unordered_map<int, uint32_t> local_index;
+    for (int id : group.triangles) {
+      auto it = local_index.find(id);
+      if (it == local_index.end()) {
+        const double* p = &positions[id * 3];
+        if (local_index.empty()) std::copy(p, p + 3, merged.origin);
+        const std::pair<int, uint32_t>& src = source.at(id);
+        const FaceMesh& fm = (*meshes)[src.first];
+        merged.positions.insert(merged.positions.end(), {static_cast<float>(p[0] - merged.origin[0]),
+                                                         static_cast<float>(p[1] - merged.origin[1]),
+                                                         static_cast<float>(p[2] - merged.origin[2])});
+        merged.normals.insert(merged.normals.end(), fm.normals.begin() + src.second * 3,
+                              fm.normals.begin() + src.second * 3 + 3);
+        merged.texcoords.insert(merged.texcoords.end(), fm.texcoords.begin() + src.second * 2,
+                                fm.texcoords.begin() + src.second * 2 + 2);
+        it = local_index.emplace(id, static_cast<uint32_t>(local_index.size())).first;
+      }
+      merged.indices.push_back(it->second);
+    }
+    for (int f : group.faces) (*meshes)[f] = FaceMesh();
+    (*meshes)[group.faces[0]] = std::move(merged);
+  }
+  meshes->erase(std::remove_if(meshes->begin(), meshes->end(), [](const FaceMesh& fm) { return fm.indices.empty(); }),
+                meshes->end());
+  for (const FaceMesh& fm : *meshes) out.coplanar_triangles_after += fm.triangle_count();
+}
+
+// entities 하나의 face들을 테셀레이션해 xf로 출력합니다. smoothing group과 동일 평면 face 합치기는
+// 같은 entities의 face끼리만 이어지므로 여기서 face 목록 단위로 처리합니다.
+// keep이 있으면 출력한 FaceMesh를 모아 둡니다 (definition 캐시).
+static SUResult ExportFaces(
+    const std::vector<SUFaceRef>& faces,
+    const SUTransformation* xf,
+    SUTextureWriterRef texture_writer,
+    MeshSink& out,
+    std::vector<FaceMesh>* keep = nullptr) {
+  SmoothingMap smoothing;
+  if (out.smooth_normals) BuildSmoothing(faces, &smoothing, &out.smoothing);
+  if (!out.merge_coplanar) {
+    if (keep) keep->resize(faces.size());
+    FaceMesh scratch;
+    for (size_t i = 0; i < faces.size(); i++) {
+      FaceMesh& fm = keep ? (*keep)[i] : scratch;
+      const SUResult r = TessellateFace(faces[i], texture_writer, out, &fm, FindSmoothing(smoothing, faces[i]));
+      if (r != SU_ERROR_NONE) return r;
+      EmitFaceMesh(fm, xf, out);
+    }
+    return SU_ERROR_NONE;
+  }
+  // 합치려면 이웃 face의 테셀레이션이 모두 있어야 하므로 entities 단위로 모아 둔 뒤 출력
+  std::vector<FaceMesh> meshes(faces.size());
+  for (size_t i = 0; i < faces.size(); i++) {
+    const SUResult r = TessellateFace(faces[i], texture_writer, out, &meshes[i], FindSmoothing(smoothing, faces[i]));
+    if (r != SU_ERROR_NONE) return r;
+  }
+  MergeCoplanar(faces, &meshes, out);
+  for (const FaceMesh& fm : meshes) EmitFaceMesh(fm, xf, out);
+  if (keep) *keep = std::move(meshes);
+  return SU_ERROR_NONE;
+}
+
+// 모델의 모든 definition (컴포넌트 + group)
+static std::vector<SUComponentDefinitionRef> ModelDefinitions(SUModelRef model) {
+  std::vector<SUComponentDefinitionRef> defs;
+  size_t count = 0;
+  SUModelGetNumComponentDefinitions(model, &count);
+  if (count > 0) {
+    std::vector<SUComponentDefinitionRef> comps(count);
+    size_t got = 0;
+    SUModelGetComponentDefinitions(model, count, comps.data(), &got);
+    defs.insert(defs.end(), comps.begin(), comps.begin() + got);
+  }
+  count = 0;
+  SUModelGetNumGroupDefinitions(model, &count);
+  if (count > 0) {
+    std::vector<SUComponentDefinitionRef> groups(count);
+    size_t got = 0;
+    SUModelGetGroupDefinitions(model, count, groups.data(), &got);
+    defs.insert(defs.end(), groups.begin(), groups.begin() + got);
+  }
+  return defs;
+}
+
+// 인스턴스가 min_instances개 이상 쓰이는 definition(컴포넌트 + group)만 캐시 대상으로 고릅니다.
+static void SelectCachedDefinitions(SUModelRef model, size_t min_instances, TessellationCache* cache) {
+  for (SUComponentDefinitionRef def : ModelDefinitions(model)) {
+    size_t used = 0;
+    if (SUComponentDefinitionGetNumUsedInstances(def, &used) == SU_ERROR_NONE && used >= min_instances) {
+      cache->eligible.insert(def.ptr);
+    }
+  }
+}
+
+// ImageRep을 32bpp로 맞춘 뒤 행 padding을 빼고 그대로 읽습니다.
+// 채널 배치(BGRA/RGBA)와 행 순서(아래 행부터)는 플랫폼 그대로라 SaveImageRepPixels로만 되돌려 씁니다.
+static bool ReadImageRepPixels(SUImageRepRef image, RgbaImage* out) {
+  size_t width = 0;
+  size_t height = 0;
+  size_t data_size = 0;
+  size_t bits_per_pixel = 0;
+  size_t row_padding = 0;
+  bool ok = SUImageRepGetPixelDimensions(image, &width, &height) == SU_ERROR_NONE && width > 0 && height > 0 &&
+            SUImageRepConvertTo32BitsPerPixel(image) == SU_ERROR_NONE &&
+            SUImageRepGetDataSize(image, &data_size, &bits_per_pixel) == SU_ERROR_NONE && bits_per_pixel == 32 &&
+            SUImageRepGetRowPadding(image, &row_padding) == SU_ERROR_NONE &&
+            data_size >= (width * 4 + row_padding) * height;
+  if (!ok) return false;
+  std::vector<SUByte> data(data_size);
+  if (SUImageRepGetData(image, data_size, data.data()) != SU_ERROR_NONE) return false;
+  out->width = width;
+  out->height = height;
+  out->pixels.resize(width * height * 4);
+  for (size_t y = 0; y < height; y++) {
+    std::copy_n(&data[y * (width * 4 + row_padding)], width * 4, &out->pixels[y * width * 4]);
+  }
+  return true;
+}
+
+// ReadImageRepPixels 배치의 픽셀을 확장자 형식으로 기록합니다.
+static bool SaveImageRepPixels(const RgbaImage& pixels, const fs::path& path) {
+  SUImageRepRef image = SU_INVALID;
+  if (SUImageRepCreate(&image) != SU_ERROR_NONE) return false;
+  const bool ok =
+      SUImageRepSetData(image, pixels.width, pixels.height, 32, 0, pixels.pixels.data()) == SU_ERROR_NONE &&
+      SUImageRepSaveToFile(image, path.string().c_str()) == SU_ERROR_NONE;
+  SUImageRepRelease(&image);
+  return ok;
+}
+
+// --max-texture-size / --texel-density: 기록한 텍스처 파일을 필요한 해상도로 줄여 다시 씁니다.
+// 밀도 기준은 텍스처를 쓰는 face 중 가장 크게 늘어난 face(월드 면적 / uv 면적 최대)를 기준으로 하므로
+// 어느 face에서도 목표 밀도 아래로 떨어지지 않습니다. 줄인 크기는 atlas/KTX2 단계도 그대로 씁니다.
+// PNG는 pool이 있으면 픽셀 읽기만 이 스레드에서 하고 리샘플/인코딩/기록은 worker에서 합니다.
+static void ResizeTextures(
+    SUTextureWriterRef texture_writer, MeshSink& out, const ExportOptions& options, WorkerPool* pool) {
+  constexpr double kMetersPerInch = 0.0254;  // SketchUp 내부 단위는 inch
+  const double texels_per_inch = options.texel_density * kMetersPerInch;
+  struct Resized {
+    MeshSink::WrittenTexture* texture;
+    uintmax_t bytes_before;
+  };
+  std::vector<Resized> resized;
+  std::mutex failed_mutex;
+  std::vector<MeshSink::WrittenTexture*> failed;
+  for (MeshSink::WrittenTexture& t : out.written()) {
+    SUImageRepRef image = SU_INVALID;
+    if (SUImageRepCreate(&image) != SU_ERROR_NONE) continue;
+    size_t width = 0;
+    size_t height = 0;
+    bool ok = SUTextureWriterGetImageRep(texture_writer, t.id, &image) == SU_ERROR_NONE &&
+              SUImageRepGetPixelDimensions(image, &width, &height) == SU_ERROR_NONE && width > 0 && height > 0;
+    size_t target_width = width;
+    size_t target_height = height;
+    if (ok) {
+      TextureTargetSize(width, height, out.texture_area_ratio(t), texels_per_inch, options.max_texture_size,
+                        &target_width, &target_height);
+      ok = target_width < width || target_height < height;
+    }
+    const fs::path path = out.texture_path(t.rel_path);
+    const bool async = pool && PngAvailable() && path.extension() == ".png";
+    RgbaImage pixels;
+    if (ok) ok = async ? ImageRepRgba(image, &pixels) : ReadImageRepPixels(image, &pixels);
+    SUImageRepRelease(&image);
+    if (!ok) continue;
+
+    std::error_code ec;
+    const uintmax_t before = fs::file_size(path, ec);
+    if (async) {
+      MeshSink::WrittenTexture* texture = &t;
+      pool->submit([&failed_mutex, &failed, texture, path, target_width, target_height, image = std::move(pixels)]() {
+        std::string error;
+        if (WritePng(ResampleImage(image, target_width, target_height), path, &error)) return;
+        std::lock_guard<std::mutex> lock(failed_mutex);
+        failed.push_back(texture);
+      });
+    } else if (!SaveImageRepPixels(ResampleImage(pixels, target_width, target_height), path)) {
+      std::cerr << "Texture resize: " << t.rel_path << " failed\n";
+      continue;
+    }
+    t.width = target_width;
+    t.height = target_height;
+    resized.push_back(Resized{&t, ec ? 0 : before});
+  }
+  if (pool) pool->wait();
+
+  size_t count = 0;
+  uintmax_t bytes_before = 0;
+  uintmax_t bytes_after = 0;
+  for (const Resized& r : resized) {
+    if (std::find(failed.begin(), failed.end(), r.texture) != failed.end()) {
+      std::cerr << "Texture resize: " << r.texture->rel_path << " failed\n";
+      r.texture->width = 0;  // 원본 크기 파일이 그대로 남아 있음
+      r.texture->height = 0;
+      continue;
+    }
+    std::error_code ec;
+    const uintmax_t after = fs::file_size(out.texture_path(r.texture->rel_path), ec);
+    count++;
+    bytes_before += r.bytes_before;
+    bytes_after += ec ? 0 : after;
+  }
+  std::cerr << "Texture resize: " << count << "/" << out.written().size() << " textures, " << bytes_before
+            << " -> " << bytes_after << " bytes\n";
+}
+
+// --atlas: uv가 [0, 1] 안에 머무는 작은 텍스처를 atlas 페이지(model/atlas_<n>.png)로 묶습니다.
+// 묶인 텍스처를 쓰던 primitive는 uv를 페이지 좌표로 옮기고 페이지 material로 바꾼 뒤 mesh 안에서 합치며,
+// 더 이상 참조되지 않는 원래 이미지/material/파일은 지웁니다. 반복(REPEAT)하는 uv는 atlas로 표현할 수 없어 제외합니다.
+static void AtlasTextures(SUTextureWriterRef texture_writer, GlbWriter& out, const ExportOptions& options) {
+  constexpr float kUvEpsilon = 1e-3f;
+  const AtlasOptions atlas_options;
+
+  struct Candidate {
+    int image = -1;
+    std::vector<int> materials;
+    bool alpha = false;
+  };
+  std::vector<Candidate> candidates;
+  std::vector<RgbaImage> pixels;
+  for (const MeshSink::WrittenTexture& t : out.written()) {
+    auto image = out.image_for_path.find(t.rel_path);
+    if (image == out.image_for_path.end()) continue;
+    Candidate c;
+    c.image = image->second;
+    bool eligible = true;
+    for (const std::string& name : t.materials) {
+      const MeshSink::TextureUsage* usage = out.texture_usage(name);
+      auto material = out.material_index.find(name);
+      if (!usage || material == out.material_index.end()) {
+        eligible = false;
+        break;
+      }
+      for (int k = 0; k < 2; k++) {
+        if (usage->uv_min[k] < -kUvEpsilon || usage->uv_max[k] > 1.0f + kUvEpsilon) eligible = false;
+      }
+      c.materials.push_back(material->second);
+    }
+    if (!eligible) continue;
+
+    SUImageRepRef rep = SU_INVALID;
+    if (SUImageRepCreate(&rep) != SU_ERROR_NONE) continue;
+    size_t width = t.width;
+    size_t height = t.height;
+    RgbaImage image_pixels;
+    bool ok = SUTextureWriterGetImageRep(texture_writer, t.id, &rep) == SU_ERROR_NONE;
+    if (ok && width == 0) ok = SUImageRepGetPixelDimensions(rep, &width, &height) == SU_ERROR_NONE;
+    ok = ok && std::max(width, height) <= options.atlas_max_texture_size && ReadImageRepPixels(rep, &image_pixels);
+    SUImageRepRelease(&rep);
+    if (!ok) continue;
+    if (image_pixels.width != width || image_pixels.height != height) {
+      image_pixels = ResampleImage(image_pixels, width, height);  // ResizeTextures가 줄인 크기
+    }
+    for (const GlbWriter::Ktx2Texture& k : out.ktx2_textures) {
+      if (k.image == c.image) c.alpha = k.alpha;
+    }
+    candidates.push_back(std::move(c));
+    pixels.push_back(std::move(image_pixels));
+  }
+  if (candidates.size() < 2) {
+    std::cerr << "Atlas: " << candidates.size() << " eligible texture(s), nothing to pack\n";
+    return;
+  }
+
+  std::vector<std::pair<size_t, size_t>> sizes;
+  for (const RgbaImage& p : pixels) sizes.emplace_back(p.width, p.height);
+  const AtlasLayout layout = PackAtlas(sizes, atlas_options);
+
+  // 페이지마다 이미지 + material 하나
+  std::vector<int> page_material(layout.page_width.size(), -1);
+  std::vector<bool> page_alpha(layout.page_width.size(), false);
+  for (size_t i = 0; i < candidates.size(); i++) {
+    if (layout.rects[i].page >= 0 && candidates[i].alpha) page_alpha[layout.rects[i].page] = true;
+  }
+  for (size_t p = 0; p < layout.page_width.size(); p++) {
+    const std::string name = "atlas_" + std::to_string(p);
+    const std::string rel_path = "model/" + name + ".png";
+    if (!SaveImageRepPixels(ComposeAtlasPage(pixels, layout, static_cast<int>(p), atlas_options),
+                            out.texture_path(rel_path))) {
+      std::cerr << "Atlas: failed to write " << rel_path << "\n";
+      continue;
+    }
+    GltfImage img;
+    img.uri = rel_path;
+    img.mime_type = "image/png";
+    const int image = static_cast<int>(out.scene.images.size());
+    out.scene.images.push_back(img);
+    if (out.ktx2) out.ktx2_textures.push_back(GlbWriter::Ktx2Texture{0, image, page_alpha[p]});
+    GltfMaterial m;
+    m.name = name;
+    m.image = image;
+    page_material[p] = static_cast<int>(out.scene.materials.size());
+    out.scene.materials.push_back(m);
+  }
+
+  // 원래 material → (rect, 페이지 material)
+  std::vector<const AtlasRect*> rect_for_material(out.scene.materials.size(), nullptr);
+  std::vector<bool> drop_image(out.scene.images.size(), false);
+  size_t packed = 0;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    const AtlasRect& r = layout.rects[i];
+    if (r.page < 0 || page_material[r.page] < 0) continue;
+    for (int m : candidates[i].materials) rect_for_material[m] = &r;
+    drop_image[candidates[i].image] = true;
+    packed++;
+  }
+
+  std::vector<bool> merge(out.scene.materials.size(), false);
+  for (int m : page_material) {
+    if (m >= 0) merge[m] = true;
+  }
+  size_t primitives_before = 0;
+  for (GltfMesh& mesh : out.scene.meshes) {
+    primitives_before += mesh.primitives.size();
+    for (GltfPrimitive& prim : mesh.primitives) {
+      if (prim.material < 0 || !rect_for_material[prim.material]) continue;
+      const AtlasRect& r = *rect_for_material[prim.material];
+      RemapAtlasTexcoords(r, layout.page_width[r.page], layout.page_height[r.page], true, &prim.texcoords);
+      prim.material = page_material[r.page];
+    }
+  }
+  out.merge_primitives(merge);
+  size_t primitives_after = 0;
+  for (const GltfMesh& mesh : out.scene.meshes) primitives_after += mesh.primitives.size();
+
+  // 묶인 이미지 파일과 이제 아무도 쓰지 않는 material/image를 정리
+  for (size_t i = 0; i < drop_image.size(); i++) {
+    if (!drop_image[i]) continue;
+    std::error_code ec;
+    fs::remove(out.texture_path(out.scene.images[i].uri), ec);
+  }
+  std::vector<bool> drop_material(out.scene.materials.size(), false);
+  for (size_t m = 0; m < rect_for_material.size(); m++) drop_material[m] = rect_for_material[m] != nullptr;
+  out.remove_unused(drop_material, drop_image);
+
+  std::cerr << "Atlas: " << packed << "/" << candidates.size() << " textures -> " << layout.page_width.size()
+            << " page(s)";
+  for (size_t p = 0; p < layout.page_width.size(); p++) {
+    std::cerr << (p == 0 ? " (" : ", ") << layout.page_width[p] << "x" << layout.page_height[p];
+  }
+  std::cerr << "), primitives " << primitives_before << " -> " << primitives_after << "\n";
+}
+
+// KTX2로 인코딩할 픽셀. texture id가 있으면 texture writer에서(ResizeTextures가 줄인 크기로),
+// 없으면(atlas 페이지) 기록한 파일에서 읽습니다. KHR_texture_basisu 규칙에 맞게 4의 배수(최소 4)로 내립니다.
+static bool Ktx2SourceRgba(
+    SUTextureWriterRef texture_writer, const GlbWriter& out, const GlbWriter::Ktx2Texture& t, RgbaImage* image) {
+  if (t.texture_id != 0) {
+    const MeshSink::WrittenTexture* written = out.find_written(t.texture_id);
+    const size_t width = written ? written->width : 0;
+    const size_t height = written ? written->height : 0;
+    if (!TextureWriterRgba(texture_writer, t.texture_id, width, height, image)) return false;
+  } else {
+    SUImageRepRef rep = SU_INVALID;
+    if (SUImageRepCreate(&rep) != SU_ERROR_NONE) return false;
+    const std::string path = out.texture_path(out.scene.images[t.image].uri).string();
+    const bool ok = SUImageRepLoadFile(rep, path.c_str()) == SU_ERROR_NONE && ImageRepRgba(rep, image);
+    SUImageRepRelease(&rep);
+    if (!ok) return false;
+  }
+  const size_t width = std::max<size_t>(4, image->width & ~static_cast<size_t>(3));
+  const size_t height = std::max<size_t>(4, image->height & ~static_cast<size_t>(3));
+  if (width != image->width || height != image->height) *image = ResampleImage(*image, width, height);
+  return true;
+}
+
+// --ktx2: 기록한 텍스처를 KTX2로 인코딩해 image.basisu_uri를 채웁니다.
+// 픽셀 읽기(SDK)는 순서대로, 인코딩은 threads개씩 병렬로 합니다. 한 번에 threads장만 메모리에 둡니다.
+static void EncodeKtx2Textures(SUTextureWriterRef texture_writer, GlbWriter& out, unsigned threads) {
+  const Ktx2Options ktx2_options;
+  const size_t batch = std::max(1u, threads);
+  size_t encoded = 0;
+  size_t source_bytes = 0;
+  size_t ktx2_bytes = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (size_t begin = 0; begin < out.ktx2_textures.size(); begin += batch) {
+    const size_t end = std::min(out.ktx2_textures.size(), begin + batch);
+    std::vector<Ktx2Job> jobs;
+    std::vector<int> images;
+    for (size_t i = begin; i < end; i++) {
+      const GlbWriter::Ktx2Texture& t = out.ktx2_textures[i];
+      GltfImage& img = out.scene.images[t.image];
+      Ktx2Job job;
+      if (!Ktx2SourceRgba(texture_writer, out, t, &job.image)) {
+        std::cerr << "KTX2: " << img.uri << " skipped (image data unavailable)\n";
+        continue;
+      }
+      job.uastc = t.alpha;
+      job.path = out.texture_path(fs::path(img.uri).replace_extension(".ktx2").string());
+      jobs.push_back(std::move(job));
+      images.push_back(t.image);
+    }
+    EncodeKtx2Jobs(&jobs, ktx2_options, threads);
+    for (size_t k = 0; k < jobs.size(); k++) {
+      GltfImage& img = out.scene.images[images[k]];
+      const Ktx2Job& job = jobs[k];
+      if (!job.ok) {
+        std::cerr << "KTX2: " << img.uri << " failed: " << job.error << "\n";
+        continue;
+      }
+      std::error_code ec;
+      const uintmax_t original = fs::file_size(out.texture_path(img.uri), ec);
+      img.basisu_uri = fs::path(img.uri).replace_extension(".ktx2").generic_string();
+      encoded++;
+      source_bytes += ec ? 0 : static_cast<size_t>(original);
+      ktx2_bytes += job.bytes;
+      std::cerr << "KTX2: " << img.basisu_uri << " " << (job.uastc ? "UASTC" : "ETC1S") << " levels=" << job.levels
+                << " " << (ec ? 0 : original) << " -> " << job.bytes << " bytes, " << job.seconds * 1000.0 << " ms\n";
+    }
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  std::cerr << "KTX2: encoded " << encoded << "/" << out.ktx2_textures.size() << " textures, " << source_bytes
+            << " -> " << ktx2_bytes << " bytes, " << seconds * 1000.0 << " ms (threads=" << batch << ")\n";
+}
+
+// --tiles: octree root 영역(모델 bounding box)과 지리 참조 모델의 root 변환(ENU → ECEF).
+// C API에는 모델 원점의 고도가 없으므로 타원체 높이 0에 둡니다.
+static void TilesetModelFrame(SUModelRef model, SUEntitiesRef entities, TilesetOptions* tileset) {
+  SUBoundingBox3D box;
+  if (SUEntitiesGetBoundingBox(entities, &box) == SU_ERROR_NONE) {
+    const double lo[3] = {box.min_point.x, box.min_point.y, box.min_point.z};
+    const double hi[3] = {box.max_point.x, box.max_point.y, box.max_point.z};
+    std::copy(lo, lo + 3, tileset->bounds_min);
+    std::copy(hi, hi + 3, tileset->bounds_max);
+  }
+  bool geo_referenced = false;
+  SULocationRef location = SU_INVALID;
+  double latitude = 0.0;
+  double longitude = 0.0;
+  if (SUModelIsGeoReferenced(model, &geo_referenced) != SU_ERROR_NONE || !geo_referenced ||
+      SUModelGetLocation(model, &location) != SU_ERROR_NONE ||
+      SULocationGetLatLong(location, &latitude, &longitude) != SU_ERROR_NONE) {
+    return;
+  }
+  double north_correction = 0.0;
+  SUModelGetNorthCorrection(model, &north_correction);
+  tileset->has_root_transform = true;
+  GeoreferenceTransform(latitude, longitude, 0.0, north_correction, tileset->root_transform);
+}
+
+// --rtc: geometry가 origin만큼 옮겨져 있으므로 분할 영역도 옮기고, root transform 앞에 되돌리는 이동
+// (tileset 좌표 = 미터)을 둡니다. 3D Tiles transform은 double이라 큰 좌표도 정확히 복원됩니다.
+static void RebaseTileset(const double origin[3], TilesetOptions* tileset) {
+  if (tileset->bounds_min[0] <= tileset->bounds_max[0]) {
+    for (int k = 0; k < 3; k++) {
+      tileset->bounds_min[k] -= origin[k];
+      tileset->bounds_max[k] -= origin[k];
+    }
+  }
+  double t[3];
+  for (int k = 0; k < 3; k++) t[k] = origin[k] * tileset->units_to_meters;
+  double* m = tileset->root_transform;
+  for (int row = 0; row < 3; row++) {
+    m[12 + row] += m[row] * t[0] + m[4 + row] * t[1] + m[8 + row] * t[2];
+  }
+  tileset->has_root_transform = true;
+}
+
+static void usage() {
+  std::cerr
+      << "sketchup-csdk-converter --input <file.skp> --outputDir <dir> --format <obj|glb|dae>\n"
+      << "\n"
+      << "Output contract:\n"
+      << "  format=obj => <outputDir>/model.obj, <outputDir>/model.mtl, (optional) <outputDir>/model/* textures\n"
+      << "  format=glb => <outputDir>/model.glb with embedded textures\n"
+      << "                (--external-textures: <outputDir>/model/* textures referenced by image.uri)\n"
+      << "                (--tiles: <outputDir>/tileset.json + <outputDir>/tiles/*.glb instead of model.glb,\n"
+      << "                 textures always stay in <outputDir>/model/* and are shared by the tiles)\n"
+      << "  format=dae => <outputDir>/model.dae, (optional) <outputDir>/model/* textures\n"
+      << "\n"
+      << "Options:\n"
+      << "  --weld-epsilon <e>  merge vertices whose position/normal/uv differ by < e (default 1e-5, 0 = exact)\n"
+      << "  --no-weld           write one vertex per face corner (no cross-face sharing)\n"
+      << "  --precision <N>     significant digits for OBJ/MTL numbers (default 6)\n"
+      << "  --merge-coplanar    merge adjacent coplanar faces with the same front/back material and uv mapping\n"
+      << "                      into one polygon per region, retriangulate it, and report tessellated triangles\n"
+      << "                      before/after\n"
+      << "  --smooth-normals    average normals across soft/smooth edges (SketchUp smoothing groups) so curved\n"
+      << "                      surfaces shade smoothly and their vertices weld across faces\n"
+      << "  --rtc               subtract the model bounding-box center (kept in double) from every position before\n"
+      << "                      float/text output; the center is recorded as GLB extras.rtcCenter, an OBJ\n"
+      << "                      \"# rtc_center\" comment, or the tileset root transform\n"
+      << "  --glb-layout <flat|instanced|hierarchy>\n"
+      << "                      instanced: one mesh per component definition + EXT_mesh_gpu_instancing\n"
+      << "                      hierarchy: one node per group/instance + one shared mesh per definition\n"
+      << "  --glb-index-bits <16|32>\n"
+      << "                      16: split primitives at 65535 vertices so every index buffer is UNSIGNED_SHORT\n"
+      << "                      (default 32: 16-bit indices are still used for primitives that fit)\n"
+      << "  --no-optimize       keep SDK triangle order in GLB (skip vertex cache/overdraw/fetch optimization)\n"
+      << "  --meshopt           compress GLB buffers with EXT_meshopt_compression\n"
+      << "                      (uncompressed copy in <outputDir>/model.fallback.bin for clients without support)\n"
+      << "  --png-textures      re-encode every texture as PNG (default: keep original JPEG/PNG bytes when possible)\n"
+      << "  --ktx2              also encode GLB textures to KTX2 (ETC1S, UASTC for alpha) via KHR_texture_basisu\n"
+      << "  --external-textures keep GLB textures as <outputDir>/model/* files instead of embedding them\n"
+      << "  --atlas             pack small non-repeating GLB textures into shared atlas pages and merge their materials\n"
+      << "  --atlas-max-size <px>\n"
+      << "                      largest texture side eligible for --atlas (default 256)\n"
+      << "  --max-texture-size <px>\n"
+      << "                      downscale textures whose longer side exceeds <px> (default 0 = no limit)\n"
+      << "  --texel-density <px/m>\n"
+      << "                      downscale textures to the smallest power of two that keeps <px/m> on every face\n"
+      << "                      that uses them (default 0 = off)\n"
+      << "  --lod <2-4>         add quadric-simplified LODs per GLB mesh (each level halves triangles) as MSFT_lod\n"
+      << "                      alternatives with MSFT_screencoverage hints; <N> counts the full-detail level\n"
+      << "  --progressive       put a simplified world-space proxy of the whole model (triangle budget shared by\n"
+      << "                      world bounding-box area) first in the GLB buffer as a second \"proxy\" scene, and\n"
+      << "                      record byte offsets in extras.progressive for HTTP range requests\n"
+      << "  --proxy-triangles <N>\n"
+      << "                      --progressive proxy triangle budget (default 10000)\n"
+      << "  --flat-grid <N>     split flat GLB geometry into cubic cells (<N> along the longest model axis), one\n"
+      << "                      child node per non-empty cell, so every node's extras.bounds can be culled\n"
+      << "                      (default 0 = single mesh)\n"
+      << "  --tiles             write GLB as 3D Tiles 1.1: loose-octree tiles (tiles/*.glb) + tileset.json with\n"
+      << "                      bounding boxes, geometric error and ADD refinement; geo-referenced models get an\n"
+      << "                      ECEF root transform (flat layout only); tile GLBs never embed textures but\n"
+      << "                      reference the shared <outputDir>/model/* files, so each texture is stored once\n"
+      << "  --tile-triangles <N>\n"
+      << "                      split tiles holding more than <N> triangles (default 50000)\n"
+      << "  --quantize          store GLB positions/normals/uvs as int16/int8 (KHR_mesh_quantization)\n"
+      << "  --draco             compress GLB primitives with KHR_draco_mesh_compression\n"
+      << "  --draco-bits <position> <normal> <texcoord>\n"
+      << "                      Draco quantization bits (default 14 10 12)\n"
+      << "  --draco-level <0-10>  Draco compression level (default 7)\n"
+      << "  --threads <N>       texture encode/write and KTX2 worker threads\n"
+      << "                      (default 0 = available CPUs, honoring affinity and cgroup CPU quota)\n"
+      << "  --cache-min-instances <N>\n"
+      << "                      cache local tessellation of definitions used >= N times (default 2, 0 = off)\n";
+}
+
+int main(int argc, char** argv) {
+  std::string input;
+  std::string outputDir;
+  std::string format = "obj";
+  ExportOptions options;
+
+  // 지원 1) positional: <input> <outputDir> [format]
+  // - 서버 기본 args 규약(["{input}","{output}","{format}"])과 호환
+  int first_flag = 1;
+  if (argc >= 3 && argv[1][0] != '-' && argv[2][0] != '-') {
+    input = argv[1];
+    outputDir = argv[2];
+    first_flag = 3;
+    if (argc >= 4 && argv[3][0] != '-') {
+      format = argv[3];
+      first_flag = 4;
+    }
+  }
+  // 지원 2) flags: --input/--outputDir/--format (+ positional 뒤의 옵션 플래그)
+  for (int i = first_flag; i < argc; i++) {
+    std::string a = argv[i];
+    if ((a == "--input" || a == "-i") && i + 1 < argc) {
+      input = argv[++i];
+    } else if ((a == "--outputDir" || a == "-o") && i + 1 < argc) {
+      outputDir = argv[++i];
+    } else if ((a == "--format" || a == "-f") && i + 1 < argc) {
+      format = argv[++i];
+    } else if (a == "--weld-epsilon" && i + 1 < argc) {
+      options.weld_epsilon = std::atof(argv[++i]);
+    } else if (a == "--no-weld") {
+      options.weld = false;
+    } else if (a == "--precision" && i + 1 < argc) {
+      options.precision = std::atoi(argv[++i]);
+    } else if (a == "--merge-coplanar") {
+      options.merge_coplanar = true;
+    } else if (a == "--smooth-normals") {
+      options.smooth_normals = true;
+    } else if (a == "--rtc") {
+      options.rtc = true;
+    } else if (a == "--png-textures") {
+      options.keep_original_textures = false;
+    } else if (a == "--ktx2") {
+      options.ktx2 = true;
+    } else if (a == "--threads" && i + 1 < argc) {
+      options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (a == "--external-textures") {
+      options.embed_textures = false;
+    } else if (a == "--atlas") {
+      options.atlas = true;
+    } else if (a == "--atlas-max-size" && i + 1 < argc) {
+      options.atlas_max_texture_size = std::strtoull(argv[++i], nullptr, 10);
+    } else if (a == "--max-texture-size" && i + 1 < argc) {
+      options.max_texture_size = std::strtoull(argv[++i], nullptr, 10);
+    } else if (a == "--texel-density" && i + 1 < argc) {
+      options.texel_density = std::atof(argv[++i]);
+      if (!(options.texel_density >= 0.0)) {
+        std::cerr << "Invalid --texel-density: " << argv[i] << " (expected px/m >= 0)\n";
+        return 2;
+      }
+    } else if (a == "--lod" && i + 1 < argc) {
+      options.lod_levels = std::atoi(argv[++i]);
+    } else if (a == "--progressive") {
+      options.progressive = true;
+    } else if (a == "--proxy-triangles" && i + 1 < argc) {
+      options.proxy_triangles = std::strtoull(argv[++i], nullptr, 10);
+    } else if (a == "--flat-grid" && i + 1 < argc) {
+      options.flat_grid = std::strtoull(argv[++i], nullptr, 10);
+    } else if (a == "--tiles") {
+      options.tiles = true;
+    } else if (a == "--tile-triangles" && i + 1 < argc) {
+      options.tile_max_triangles = std::strtoull(argv[++i], nullptr, 10);
+    } else if (a == "--quantize") {
+      options.quantize = true;
+    } else if (a == "--draco") {
+      options.draco_compression = true;
+    } else if (a == "--draco-bits" && i + 3 < argc) {
+      options.draco.position_bits = std::atoi(argv[++i]);
+      options.draco.normal_bits = std::atoi(argv[++i]);
+      options.draco.texcoord_bits = std::atoi(argv[++i]);
+    } else if (a == "--draco-level" && i + 1 < argc) {
+      options.draco.compression_level = std::atoi(argv[++i]);
+    } else if (a == "--meshopt") {
+      options.meshopt_compression = true;
+    } else if (a == "--no-optimize") {
+      options.optimize_meshes = false;
+    } else if (a == "--cache-min-instances" && i + 1 < argc) {
+      options.cache_min_instances = std::strtoull(argv[++i], nullptr, 10);
+    } else if (a == "--glb-index-bits" && i + 1 < argc) {
+      const std::string bits = argv[++i];
+      if (bits == "16") {
+        options.glb_max_primitive_vertices = kMaxShortIndexVertices;
+      } else if (bits == "32") {
+        options.glb_max_primitive_vertices = kMaxIntIndexVertices;
+      } else {
+        std::cerr << "Invalid --glb-index-bits: " << bits << " (expected 16|32)\n";
+        return 2;
+      }
+    } else if (a == "--glb-layout" && i + 1 < argc) {
+      const std::string layout = argv[++i];
+      if (layout == "flat") {
+        options.glb_layout = ExportOptions::GlbLayout::kFlat;
+      } else if (layout == "instanced") {
+        options.glb_layout = ExportOptions::GlbLayout::kInstanced;
+      } else if (layout == "hierarchy") {
+        options.glb_layout = ExportOptions::GlbLayout::kHierarchy;
+      } else {
+        std::cerr << "Invalid --glb-layout: " << layout << " (expected flat|instanced|hierarchy)\n";
+        return 2;
+      }
+    } else if (a == "--help" || a == "-h") {
+      usage();
+      return 0;
+    } else {
+      std::cerr << "Unknown argument: " << a << "\n";
+      usage();
+      return 2;
+    }
+  }
+
+  if (input.empty() || outputDir.empty()) {
+    usage();
+    return 2;
+  }
+  if (!(format == "obj" || format == "glb" || format == "dae")) {
+    std::cerr << "Invalid --format: " << format << " (expected obj|glb|dae)\n";
+    return 2;
+  }
+
+  if (format == "dae") {
+    std::cerr << "DAE export is not implemented yet. Use --format obj|glb for now.\n";
+    return 2;
+  }
+  if (format != "glb" && options.glb_layout != ExportOptions::GlbLayout::kFlat) {
+    std::cerr << "--glb-layout requires --format glb\n";
+    return 2;
+  }
+  if (format != "glb" && options.meshopt_compression) {
+    std::cerr << "--meshopt requires --format glb\n";
+    return 2;
+  }
+  if (options.ktx2) {
+    if (format != "glb") {
+      std::cerr << "--ktx2 requires --format glb\n";
+      return 2;
+    }
+    if (!Ktx2Available()) {
+      // 서버가 환경 변수로 붙이는 옵션이므로 변환 자체는 실패시키지 않고 PNG/JPEG만 기록
+      std::cerr << "Warning: --ktx2 ignored; converter was built without libktx.\n";
+      options.ktx2 = false;
+    }
+  }
+  if (format != "glb" && options.atlas) {
+    std::cerr << "--atlas requires --format glb\n";
+    return 2;
+  }
+  if (format != "glb" && options.quantize) {
+    std::cerr << "--quantize requires --format glb\n";
+    return 2;
+  }
+  if (options.lod_levels != 0) {
+    if (format != "glb") {
+      std::cerr << "--lod requires --format glb\n";
+      return 2;
+    }
+    if (options.lod_levels < 2 || options.lod_levels > 4) {
+      std::cerr << "Invalid --lod: " << options.lod_levels << " (expected 2-4)\n";
+      return 2;
+    }
+  }
+  if (options.progressive) {
+    if (format != "glb") {
+      std::cerr << "--progressive requires --format glb\n";
+      return 2;
+    }
+    if (options.tiles) {
+      std::cerr << "--progressive and --tiles cannot be combined (tiles already stream by region)\n";
+      return 2;
+    }
+    if (options.proxy_triangles == 0) {
+      std::cerr << "Invalid --proxy-triangles: 0 (expected > 0)\n";
+      return 2;
+    }
+  }
+  if (options.flat_grid > 0) {
+    if (format != "glb") {
+      std::cerr << "--flat-grid requires --format glb\n";
+      return 2;
+    }
+    if (options.glb_layout != ExportOptions::GlbLayout::kFlat) {
+      std::cerr << "--flat-grid requires --glb-layout flat (other layouts already have a node per definition)\n";
+      return 2;
+    }
+  }
+  if (options.tiles) {
+    if (format != "glb") {
+      std::cerr << "--tiles requires --format glb\n";
+      return 2;
+    }
+    if (options.glb_layout != ExportOptions::GlbLayout::kFlat) {
+      std::cerr << "--tiles requires --glb-layout flat (tiles are cut from world-space geometry)\n";
+      return 2;
+    }
+    if (options.lod_levels != 0) {
+      std::cerr << "--tiles and --lod cannot be combined (tiles are cut from world-space triangles, not MSFT_lod nodes)\n";
+      return 2;
+    }
+    if (options.tile_max_triangles == 0) {
+      std::cerr << "Invalid --tile-triangles: 0 (expected > 0)\n";
+      return 2;
+    }
+  }
+  if (options.draco_compression) {
+    if (format != "glb") {
+      std::cerr << "--draco requires --format glb\n";
+      return 2;
+    }
+    if (options.meshopt_compression) {
+      std::cerr << "--draco and --meshopt cannot be combined\n";
+      return 2;
+    }
+    if (options.quantize) {
+      std::cerr << "--draco and --quantize cannot be combined (use --draco-bits)\n";
+      return 2;
+    }
+    if (!DracoAvailable()) {
+      // 서버가 환경 변수로 붙이는 옵션이므로 변환 자체는 실패시키지 않고 압축 없이 기록
+      std::cerr << "Warning: --draco ignored; converter was built without the Draco library.\n";
+      options.draco_compression = false;
+    }
+    const DracoOptions& d = options.draco;
+    if (d.position_bits < 1 || d.position_bits > 30 || d.normal_bits < 1 || d.normal_bits > 30 ||
+        d.texcoord_bits < 1 || d.texcoord_bits > 30 || d.compression_level < 0 || d.compression_level > 10) {
+      std::cerr << "Invalid Draco options (bits 1-30, level 0-10)\n";
+      return 2;
+    }
+  }
+
+  fs::path out_dir(outputDir);
+  fs::create_directories(out_dir);
+  // 텍스처 폴더 규약(선택): outputDir/model/*
+  fs::create_directories(out_dir / "model");
+
+  std::unique_ptr<ObjWriter> obj_writer;
+  std::unique_ptr<GlbWriter> glb_writer;
+  MeshSink* writer = nullptr;
+  if (format == "glb") {
+    glb_writer = std::make_unique<GlbWriter>(out_dir, options);
+    writer = glb_writer.get();
+  } else {
+    obj_writer = std::make_unique<ObjWriter>(out_dir, options);
+    if (!obj_writer->ok()) {
+      std::cerr << "Failed to open output files in: " << outputDir << "\n";
+      return 1;
+    }
+    writer = obj_writer.get();
+  }
+
+  // 텍스처 worker. 대기열을 스레드 수의 두 배로 묶어 읽어 둔 픽셀이 메모리에 쌓이지 않게 합니다.
+  const unsigned threads = options.threads > 0 ? options.threads : AvailableCpuCount();
+  std::unique_ptr<WorkerPool> texture_pool;
+  if (PngAvailable()) {
+    texture_pool = std::make_unique<WorkerPool>(threads, static_cast<size_t>(threads) * 2);
+    writer->texture_pool = texture_pool.get();
+  }
+
+  // SDK init (headless)
   SUInitialize();
 
   SUModelRef model = SU_INVALID;
@@ -378,15 +2363,70 @@ int main(int argc, char** argv) {
   if (status == SUModelLoadStatus_Success_MoreRecent) {
     std::cerr << "Warning: model created in newer SketchUp version; some data may not be read.\n";
   }
-
   SUTextureWriterRef texture_writer = SU_INVALID;
   SUTextureWriterCreate(&texture_writer);
 
   SUEntitiesRef entities = SU_INVALID;
   SUModelGetEntities(model, &entities);
-  const SUTransformation identity = IdentityTransform();
+  // 루트 변환: 기본은 identity, --rtc면 모델 박스 중심만큼 되돌리는 이동 (double로 합성되어 정점에 적용)
+  SUTransformation root_xf = IdentityTransform();
+  double origin[3] = {0.0, 0.0, 0.0};
+  SUBoundingBox3D model_box;
+  const bool has_model_box = SUEntitiesGetBoundingBox(entities, &model_box) == SU_ERROR_NONE;
+  if (options.rtc) {
+    if (has_model_box) {
+      origin[0] = 0.5 * (model_box.min_point.x + model_box.max_point.x);
+      origin[1] = 0.5 * (model_box.min_point.y + model_box.max_point.y);
+      origin[2] = 0.5 * (model_box.min_point.z + model_box.max_point.z);
+      for (int k = 0; k < 3; k++) root_xf.values[12 + k] = -origin[k];
+      writer->record_origin(origin);
+      std::cerr << "RTC origin: " << origin[0] << " " << origin[1] << " " << origin[2] << "\n";
+    } else {
+      std::cerr << "Warning: model bounding box unavailable; --rtc ignored.\n";
+    }
+  }
+  TilesetOptions tileset;
+  if (options.tiles) {
+    TilesetModelFrame(model, entities, &tileset);
+    if (options.rtc && has_model_box) RebaseTileset(origin, &tileset);
+  }
+  if (glb_writer && options.flat_grid > 0 && has_model_box) {
+    // 격자 범위만 정하므로 SDK 박스(모서리/가이드 포함)로 충분. node 범위는 실제 정점에서 구함
+    const SUPoint3D lo{model_box.min_point.x - origin[0], model_box.min_point.y - origin[1],
+                       model_box.min_point.z - origin[2]};
+    const SUPoint3D hi{model_box.max_point.x - origin[0], model_box.max_point.y - origin[1],
+                       model_box.max_point.z - origin[2]};
+    glb_writer->set_grid(lo, hi, options.flat_grid);
+  }
 
-  res = ExportEntitiesOBJ(entities, &identity, texture_writer, writer);
+  InstancingState instancing;
+  HierarchyState hierarchy;
+  TessellationCache cache;
+  if (glb_writer && options.glb_layout == ExportOptions::GlbLayout::kInstanced) {
+    res = ExportEntitiesInstanced(entities, 0, &root_xf, &root_xf, texture_writer, *glb_writer, instancing);
+  } else if (glb_writer && options.glb_layout == ExportOptions::GlbLayout::kHierarchy) {
+    const SUComponentDefinitionRef root_def = SU_INVALID;
+    res = ExportEntitiesHierarchy(entities, root_def, 0, &root_xf, texture_writer, *glb_writer, hierarchy);
+  } else {
+    TessellationCache* cache_ptr = nullptr;
+    if (options.cache_min_instances > 0) {
+      SelectCachedDefinitions(model, options.cache_min_instances, &cache);
+      cache_ptr = &cache;
+    }
+    const SUComponentDefinitionRef root_def = SU_INVALID;
+    res = ExportEntitiesOBJ(entities, &root_xf, root_def, texture_writer, *writer, cache_ptr);
+  }
+
+  writer->finish_textures(texture_writer);
+  if (res == SU_ERROR_NONE && (options.max_texture_size > 0 || options.texel_density > 0.0)) {
+    ResizeTextures(texture_writer, *writer, options, texture_pool.get());
+  }
+  if (res == SU_ERROR_NONE && glb_writer && options.atlas) {
+    AtlasTextures(texture_writer, *glb_writer, options);
+  }
+  if (res == SU_ERROR_NONE && glb_writer && options.ktx2) {
+    EncodeKtx2Textures(texture_writer, *glb_writer, threads);
+  }
 
   SUTextureWriterRelease(&texture_writer);
   SUModelRelease(&model);
@@ -397,26 +2437,212 @@ int main(int argc, char** argv) {
     return 1;
   }
 
+  const WeldStats& ws = writer->weld_stats();
+  std::cerr << "Weld: corners=" << ws.corners;
+  if (glb_writer) {
+    std::cerr << " vertices=" << ws.vertices << "\n";
+  } else {
+    std::cerr << " v=" << ws.positions << " vt=" << ws.texcoords << " vn=" << ws.normals << "\n";
+  }
+  if (options.smooth_normals) {
+    std::cerr << "Smoothing: groups=" << writer->smoothing.groups << " faces=" << writer->smoothing.faces
+              << " corners=" << writer->smoothing.corners << "\n";
+  }
+  if (options.merge_coplanar) {
+    // 삼각형은 추정이 아니라 SUMeshHelper가 만든 수와 출력한 수 (테셀레이션한 face마다, 캐시 재사용은 빼고)
+    std::cerr << "Coplanar merge: polygons=" << writer->coplanar.groups << " faces=" << writer->coplanar.faces
+              << " skipped=" << writer->coplanar.skipped << " triangles " << writer->coplanar_triangles_before
+              << " -> " << writer->coplanar_triangles_after << "\n";
+  }
+  if (writer->textures_original() + writer->textures_reencoded() > 0) {
+    std::cerr << "Textures: original=" << writer->textures_original()
+              << " reencoded=" << writer->textures_reencoded()
+              << " deduplicated=" << writer->textures_deduplicated() << " async=" << writer->textures_async()
+              << " (threads=" << threads << ")\n";
+  }
+
+  if (glb_writer && options.lod_levels > 1) {
+    const GlbWriter::LodStats lod = glb_writer->build_lods(options.lod_levels);
+    std::cerr << "LOD: meshes=" << lod.meshes << " triangles=";
+    for (size_t k = 0; k < lod.triangles.size(); k++) std::cerr << (k ? " -> " : "") << lod.triangles[k];
+    std::cerr << " max_error=" << lod.max_error << " (of mesh size) " << lod.seconds * 1000.0 << " ms";
+    if (lod.seconds > 0.0) std::cerr << " (" << lod.triangles[0] / lod.seconds / 1e6 << " Mtri/s)";
+    std::cerr << "\n";
+  }
+
+  ProxyStats proxy;
+  if (glb_writer && options.progressive) proxy = glb_writer->build_proxy(options.proxy_triangles);
+
+  if (glb_writer && options.optimize_meshes) {
+    VertexCacheStats before;
+    VertexCacheStats after;
+    for (GltfMesh& m : glb_writer->scene.meshes) {
+      for (GltfPrimitive& p : m.primitives) {
+        const VertexCacheStats b = AnalyzeVertexCache(p.indices, p.vertex_count());
+        OptimizePrimitive(&p);
+        const VertexCacheStats a = AnalyzeVertexCache(p.indices, p.vertex_count());
+        before.triangles += b.triangles;
+        before.vertices += b.vertices;
+        before.transformed += b.transformed;
+        after.transformed += a.transformed;
+      }
+    }
+    if (before.triangles > 0) {
+      const double tris = static_cast<double>(before.triangles);
+      const double verts = static_cast<double>(before.vertices > 0 ? before.vertices : 1);
+      std::cerr << "Mesh optimize: ACMR " << before.transformed / tris << " -> " << after.transformed / tris
+                << " ATVR " << before.transformed / verts << " -> " << after.transformed / verts << "\n";
+    }
+  }
+
+  if (glb_writer) {
+    size_t primitives = 0;
+    size_t short_indices = 0;
+    for (const GltfMesh& m : glb_writer->scene.meshes) {
+      for (const GltfPrimitive& p : m.primitives) {
+        if (p.indices.empty()) continue;
+        primitives++;
+        if (p.vertex_count() <= kMaxShortIndexVertices) short_indices++;
+      }
+    }
+    std::cerr << "Primitives: " << primitives << " (uint16 indices=" << short_indices
+              << " split=" << glb_writer->primitive_splits << ")\n";
+  } else {
+    std::cerr << "Material groups: usemtl=" << obj_writer->material_groups()
+              << " (face order would switch " << obj_writer->usemtl_runs << " times)\n";
+  }
+
+  if (!cache.eligible.empty()) {
+    std::cerr << "Tessellation cache: eligible=" << cache.eligible.size()
+              << " cached=" << cache.entries.size()
+              << " faces_tessellated=" << cache.faces_tessellated
+              << " faces_replayed=" << cache.faces_replayed << "\n";
+  }
+  if (options.glb_layout == ExportOptions::GlbLayout::kInstanced) {
+    std::cerr << "Instancing: definitions=" << instancing.definitions.size()
+              << " instances=" << instancing.instances << " baked=" << instancing.baked << "\n";
+  }
+  if (options.glb_layout == ExportOptions::GlbLayout::kHierarchy) {
+    std::cerr << "Hierarchy: nodes=" << hierarchy.nodes
+              << " meshes=" << hierarchy.mesh_for_definition.size() << "\n";
+  }
+
+  if (glb_writer) {
+    glb_writer->compute_bounds();
+    size_t bounded = 0;
+    for (const GltfNode& n : glb_writer->scene.nodes) bounded += n.bounds.valid ? 1 : 0;
+    std::cerr << "Bounds: nodes=" << bounded << "/" << glb_writer->scene.nodes.size()
+              << " grid cells=" << glb_writer->mesh_for_cell.size() << "\n";
+
+    GlbWriteOptions write_options;
+    write_options.meshopt_compression = options.meshopt_compression;
+    write_options.draco_compression = options.draco_compression;
+    write_options.draco = options.draco;
+    write_options.quantize = options.quantize;
+    write_options.embed_images = options.embed_textures;
+    GlbWriteStats write_stats;
+    std::string error;
+    TilesetStats tile_stats;
+    if (options.tiles) {
+      tileset.max_tile_triangles = options.tile_max_triangles;
+      tileset.max_primitive_vertices = options.glb_max_primitive_vertices;
+      tileset.threads = threads;
+      tileset.glb = write_options;
+      tileset.glb.embed_images = false;  // tile끼리 텍스처 파일을 공유 (WriteTileset도 강제)
+      if (!glb_writer->write_tiles(tileset, &tile_stats, &error)) {
+        std::cerr << "Tileset write failed: " << error << "\n";
+        return 1;
+      }
+      write_stats = tile_stats.glb;
+    } else if (!glb_writer->write(write_options, &write_stats, &error)) {
+      std::cerr << "GLB write failed: " << error << "\n";
+      return 1;
+    }
+    if ((options.meshopt_compression || options.draco_compression) && write_stats.geometry_bytes > 0) {
+      std::cerr << (options.draco_compression ? "Draco: " : "Meshopt: ") << write_stats.geometry_bytes << " -> "
+                << write_stats.compressed_bytes
+                << " bytes (ratio " << static_cast<double>(write_stats.compressed_bytes) / write_stats.geometry_bytes
+                << ", encode " << write_stats.encode_seconds * 1000.0 << " ms)";
+      if (!write_stats.fallback_path.empty()) std::cerr << ", fallback " << write_stats.fallback_path;
+      std::cerr << "\n";
+    }
+    if (options.quantize && write_stats.float_vertex_bytes > 0) {
+      std::cerr << "Quantize: vertex " << write_stats.float_vertex_bytes << " -> " << write_stats.quantized_vertex_bytes
+                << " bytes, max error position " << write_stats.position_error << ", normal "
+                << write_stats.normal_error_degrees << " deg, uv " << write_stats.texcoord_error << "\n";
+    }
+    if (write_stats.embedded_images > 0) {
+      // GLB에 들어간 파일은 더 필요 없으므로 지우고, 비면 model/ 폴더도 지움
+      for (const GltfImage& img : glb_writer->scene.images) {
+        std::error_code ec;
+        fs::remove(out_dir / img.uri, ec);
+        if (!img.basisu_uri.empty()) fs::remove(out_dir / img.basisu_uri, ec);
+      }
+      std::error_code ec;
+      if (fs::is_empty(out_dir / "model", ec)) fs::remove(out_dir / "model", ec);
+      std::cerr << "Embedded textures: " << write_stats.embedded_images << " images, "
+                << write_stats.embedded_image_bytes << " bytes after geometry\n";
+    }
+    if (options.progressive) {
+      std::cerr << "Progressive: proxy triangles=" << proxy.triangles << " of " << proxy.triangles_before
+                << " (instances " << proxy.instances_kept << "/" << proxy.instances << ", "
+                << proxy.seconds * 1000.0 << " ms), first " << write_stats.proxy_end << " of "
+                << write_stats.file_bytes << " bytes render the proxy\n";
+    }
+    if (options.tiles) {
+      std::cerr << "Tiles: " << tile_stats.tiles << " (content=" << tile_stats.content_tiles
+                << " depth=" << tile_stats.depth << ") triangles=" << tile_stats.triangles
+                << " max/tile=" << tile_stats.max_tile_triangles << " bytes=" << tile_stats.glb_bytes
+                << " georeferenced=" << (tileset.has_root_transform ? "yes" : "no") << "\n";
+      std::cerr << "Export OK: " << (out_dir / "tileset.json") << "\n";
+      return 0;
+    }
+    std::cerr << "Export OK: " << (out_dir / "model.glb") << "\n";
+    return 0;
+  }
+
+  if (!obj_writer->finish()) {
+    std::cerr << "Failed to write output files in: " << outputDir << "\n";
+    return 1;
+  }
   std::cerr << "Export OK: " << (out_dir / "model.obj") << "\n";
   return 0;
 }
 
+// owner_def: entities를 소유한 definition (루트면 SU_INVALID). 캐시 키로 사용합니다.
 static SUResult ExportEntitiesOBJ(
     SUEntitiesRef entities,
     const SUTransformation* parent_xf,
+    SUComponentDefinitionRef owner_def,
     SUTextureWriterRef texture_writer,
-    ObjWriter& out) {
+    MeshSink& out,
+    TessellationCache* cache) {
   // Faces
-  size_t face_count = 0;
-  SUEntitiesGetNumFaces(entities, &face_count);
-  if (face_count > 0) {
-    std::vector<SUFaceRef> faces(face_count);
-    size_t got = 0;
-    SUEntitiesGetFaces(entities, face_count, faces.data(), &got);
-    for (size_t i = 0; i < got; i++) {
-      const SUResult r = ExportFaceOBJ(faces[i], parent_xf, texture_writer, out);
+  const bool cacheable = cache && !SUIsInvalid(owner_def) && cache->eligible.count(owner_def.ptr);
+  const std::vector<FaceMesh>* cached = nullptr;
+  if (cacheable) {
+    auto it = cache->entries.find(owner_def.ptr);
+    if (it != cache->entries.end()) cached = &it->second;
+  }
+  if (cached) {
+    for (const FaceMesh& fm : *cached) EmitFaceMesh(fm, parent_xf, out);
+    cache->faces_replayed += cached->size();
+  } else {
+    size_t face_count = 0;
+    SUEntitiesGetNumFaces(entities, &face_count);
+    std::vector<FaceMesh> local_faces;
+    if (face_count > 0) {
+      std::vector<SUFaceRef> faces(face_count);
+      size_t got = 0;
+      SUEntitiesGetFaces(entities, face_count, faces.data(), &got);
+      faces.resize(got);
+      const SUResult r = ExportFaces(faces, parent_xf, texture_writer, out, cacheable ? &local_faces : nullptr);
       if (r != SU_ERROR_NONE) return r;
     }
+    if (cacheable) {
+      cache->faces_tessellated += local_faces.size();
+      cache->entries.emplace(owner_def.ptr, std::move(local_faces));
+    }
   }
 
   // Groups
@@ -434,7 +2660,9 @@ static SUResult ExportEntitiesOBJ(
 
       SUEntitiesRef child = SU_INVALID;
       SUGroupGetEntities(groups[i], &child);
-      const SUResult r = ExportEntitiesOBJ(child, &combined, texture_writer, out);
+      SUComponentDefinitionRef group_def = SU_INVALID;
+      SUGroupGetDefinition(groups[i], &group_def);
+      const SUResult r = ExportEntitiesOBJ(child, &combined, group_def, texture_writer, out, cache);
       if (r != SU_ERROR_NONE) return r;
     }
   }
@@ -457,7 +2685,7 @@ static SUResult ExportEntitiesOBJ(
       SUEntitiesRef child = SU_INVALID;
       SUComponentDefinitionGetEntities(def, &child);
 
-      const SUResult r = ExportEntitiesOBJ(child, &combined, texture_writer, out);
+      const SUResult r = ExportEntitiesOBJ(child, &combined, def, texture_writer, out, cache);
       if (r != SU_ERROR_NONE) return r;
     }
   }
@@ -465,3 +2693,239 @@ static SUResult ExportEntitiesOBJ(
   return SU_ERROR_NONE;
 }
 
+
+static std::string ComponentDefinitionName(SUComponentDefinitionRef def) {
+  SUStringRef su_name = SU_INVALID;
+  SUStringCreate(&su_name);
+  std::string name;
+  if (SUComponentDefinitionGetName(def, &su_name) == SU_ERROR_NONE) name = SUStringToUTF8(su_name);
+  SUStringRelease(&su_name);
+  return name;
+}
+
+// --glb-layout instanced 전용 순회.
+// - owner_mesh: face를 출력할 mesh (-1이면 face는 건너뛰고 중첩 인스턴스만 수집)
+// - xf_in_owner: 현재 entities → owner mesh 좌표계
+// - world_xf: 현재 entities → 월드 좌표계 (인스턴스 TRS 계산용)
+// definition의 지오메트리는 처음 만난 인스턴스에서 로컬 좌표로 한 번만 출력하고,
+// 이후 인스턴스는 TRS만 추가합니다. group은 owner mesh에 구워 넣습니다.
+static SUResult ExportEntitiesInstanced(
+    SUEntitiesRef entities,
+    int owner_mesh,
+    const SUTransformation* xf_in_owner,
+    const SUTransformation* world_xf,
+    SUTextureWriterRef texture_writer,
+    GlbWriter& out,
+    InstancingState& state) {
+  // Faces
+  if (owner_mesh >= 0) {
+    size_t face_count = 0;
+    SUEntitiesGetNumFaces(entities, &face_count);
+    if (face_count > 0) {
+      std::vector<SUFaceRef> faces(face_count);
+      size_t got = 0;
+      SUEntitiesGetFaces(entities, face_count, faces.data(), &got);
+      faces.resize(got);
+      out.set_active_mesh(owner_mesh);
+      const SUResult r = ExportFaces(faces, xf_in_owner, texture_writer, out);
+      if (r != SU_ERROR_NONE) return r;
+    }
+  }
+
+  // Groups
+  size_t group_count = 0;
+  SUEntitiesGetNumGroups(entities, &group_count);
+  if (group_count > 0) {
+    std::vector<SUGroupRef> groups(group_count);
+    size_t got = 0;
+    SUEntitiesGetGroups(entities, group_count, groups.data(), &got);
+    for (size_t i = 0; i < got; i++) {
+      SUTransformation gx = IdentityTransform();
+      SUGroupGetTransform(groups[i], &gx);
+      SUTransformation in_owner = IdentityTransform();
+      SUTransformationMultiply(xf_in_owner, &gx, &in_owner);
+      SUTransformation world = IdentityTransform();
+      SUTransformationMultiply(world_xf, &gx, &world);
+
+      SUEntitiesRef child = SU_INVALID;
+      SUGroupGetEntities(groups[i], &child);
+      const SUResult r =
+          ExportEntitiesInstanced(child, owner_mesh, &in_owner, &world, texture_writer, out, state);
+      if (r != SU_ERROR_NONE) return r;
+    }
+  }
+
+  // Component instances
+  size_t inst_count = 0;
+  SUEntitiesGetNumInstances(entities, &inst_count);
+  if (inst_count > 0) {
+    std::vector<SUComponentInstanceRef> insts(inst_count);
+    size_t got = 0;
+    SUEntitiesGetInstances(entities, inst_count, insts.data(), &got);
+    for (size_t i = 0; i < got; i++) {
+      SUTransformation ix = IdentityTransform();
+      SUComponentInstanceGetTransform(insts[i], &ix);
+      SUTransformation world = IdentityTransform();
+      SUTransformationMultiply(world_xf, &ix, &world);
+
+      SUComponentDefinitionRef def = SU_INVALID;
+      SUComponentInstanceGetDefinition(insts[i], &def);
+      SUEntitiesRef child = SU_INVALID;
+      SUComponentDefinitionGetEntities(def, &child);
+
+      TRS trs;
+      if (!DecomposeTRS(world.values, &trs)) {
+        // shear 등은 인스턴스 TRS로 표현할 수 없으므로 루트 mesh에 월드 좌표로 굽습니다.
+        state.baked++;
+        const SUResult r = ExportEntitiesInstanced(child, 0, &world, &world, texture_writer, out, state);
+        if (r != SU_ERROR_NONE) return r;
+        continue;
+      }
+
+      const SUTransformation identity = IdentityTransform();
+      auto it = state.definitions.find(def.ptr);
+      const bool first = (it == state.definitions.end());
+      if (first) {
+        InstancingState::Definition d;
+        const std::string name = ComponentDefinitionName(def);
+        d.mesh = out.add_mesh(name);
+        d.node = out.add_node(name, d.mesh);
+        out.scene.roots.push_back(d.node);
+        it = state.definitions.emplace(def.ptr, d).first;
+      }
+
+      GltfInstance inst;
+      for (int k = 0; k < 3; k++) {
+        inst.translation[k] = static_cast<float>(trs.translation[k]);
+        inst.scale[k] = static_cast<float>(trs.scale[k]);
+      }
+      for (int k = 0; k < 4; k++) inst.rotation[k] = static_cast<float>(trs.rotation[k]);
+      out.scene.nodes[it->second.node].instances.push_back(inst);
+      state.instances++;
+
+      // 첫 인스턴스에서만 definition 지오메트리를 로컬 좌표로 출력, 이후엔 중첩 인스턴스만 수집
+      const int child_owner = first ? it->second.mesh : -1;
+      const SUResult r =
+          ExportEntitiesInstanced(child, child_owner, &identity, &world, texture_writer, out, state);
+      if (r != SU_ERROR_NONE) return r;
+    }
+  }
+
+  return SU_ERROR_NONE;
+}
+
+static std::string GroupName(SUGroupRef group) {
+  SUStringRef su_name = SU_INVALID;
+  SUStringCreate(&su_name);
+  std::string name;
+  if (SUGroupGetName(group, &su_name) == SU_ERROR_NONE) name = SUStringToUTF8(su_name);
+  SUStringRelease(&su_name);
+  return name;
+}
+
+static std::string ComponentInstanceName(SUComponentInstanceRef inst, SUComponentDefinitionRef def) {
+  SUStringRef su_name = SU_INVALID;
+  SUStringCreate(&su_name);
+  std::string name;
+  if (SUComponentInstanceGetName(inst, &su_name) == SU_ERROR_NONE) name = SUStringToUTF8(su_name);
+  SUStringRelease(&su_name);
+  return name.empty() ? ComponentDefinitionName(def) : name;
+}
+
+// --glb-layout hierarchy 전용 순회.
+// - node: entities를 담는 glTF node (루트는 0)
+// - owner_def: entities를 소유한 definition (루트는 invalid)
+// - xf: 이 entities의 face와 자식 node matrix 앞에 곱할 변환 (루트에서 --rtc 이동, 그 아래는 identity)
+// definition의 face는 처음 만났을 때 로컬 좌표로 mesh 하나에 한 번만 출력하고, 이후 배치는 그 mesh를
+// 공유합니다. glTF node는 부모가 하나뿐이므로 node는 group/인스턴스 배치마다 새로 만들고
+// SUTransformation(로컬)을 node.matrix로 둡니다.
+static SUResult ExportEntitiesHierarchy(
+    SUEntitiesRef entities,
+    SUComponentDefinitionRef owner_def,
+    int node,
+    const SUTransformation* xf,
+    SUTextureWriterRef texture_writer,
+    GlbWriter& out,
+    HierarchyState& state) {
+  state.nodes++;
+
+  // Faces → definition 공유 mesh
+  void* key = SUIsInvalid(owner_def) ? nullptr : owner_def.ptr;
+  auto it = state.mesh_for_definition.find(key);
+  if (it == state.mesh_for_definition.end()) {
+    const int mesh = key ? out.add_mesh(ComponentDefinitionName(owner_def)) : 0;
+    it = state.mesh_for_definition.emplace(key, mesh).first;
+
+    size_t face_count = 0;
+    SUEntitiesGetNumFaces(entities, &face_count);
+    if (face_count > 0) {
+      std::vector<SUFaceRef> faces(face_count);
+      size_t got = 0;
+      SUEntitiesGetFaces(entities, face_count, faces.data(), &got);
+      faces.resize(got);
+      out.set_active_mesh(mesh);
+      const SUResult r = ExportFaces(faces, xf, texture_writer, out);
+      if (r != SU_ERROR_NONE) return r;
+    }
+  }
+  out.scene.nodes[node].mesh = it->second;
+  const SUTransformation identity = IdentityTransform();
+
+  // Groups
+  size_t group_count = 0;
+  SUEntitiesGetNumGroups(entities, &group_count);
+  if (group_count > 0) {
+    std::vector<SUGroupRef> groups(group_count);
+    size_t got = 0;
+    SUEntitiesGetGroups(entities, group_count, groups.data(), &got);
+    for (size_t i = 0; i < got; i++) {
+      SUTransformation local = IdentityTransform();
+      SUGroupGetTransform(groups[i], &local);
+      SUTransformation gx = IdentityTransform();
+      SUTransformationMultiply(xf, &local, &gx);
+      SUComponentDefinitionRef group_def = SU_INVALID;
+      SUGroupGetDefinition(groups[i], &group_def);
+      SUEntitiesRef child = SU_INVALID;
+      SUGroupGetEntities(groups[i], &child);
+
+      const std::string name = GroupName(groups[i]);
+      const int child_node = out.add_node(name.empty() ? "group" : name, -1);
+      out.scene.nodes[child_node].has_matrix = true;
+      NormalizeHomogeneous(gx.values, out.scene.nodes[child_node].matrix);
+      out.scene.nodes[node].children.push_back(child_node);
+
+      const SUResult r =
+          ExportEntitiesHierarchy(child, group_def, child_node, &identity, texture_writer, out, state);
+      if (r != SU_ERROR_NONE) return r;
+    }
+  }
+
+  // Component instances
+  size_t inst_count = 0;
+  SUEntitiesGetNumInstances(entities, &inst_count);
+  if (inst_count > 0) {
+    std::vector<SUComponentInstanceRef> insts(inst_count);
+    size_t got = 0;
+    SUEntitiesGetInstances(entities, inst_count, insts.data(), &got);
+    for (size_t i = 0; i < got; i++) {
+      SUTransformation local = IdentityTransform();
+      SUComponentInstanceGetTransform(insts[i], &local);
+      SUTransformation ix = IdentityTransform();
+      SUTransformationMultiply(xf, &local, &ix);
+      SUComponentDefinitionRef def = SU_INVALID;
+      SUComponentInstanceGetDefinition(insts[i], &def);
+      SUEntitiesRef child = SU_INVALID;
+      SUComponentDefinitionGetEntities(def, &child);
+
+      const int child_node = out.add_node(ComponentInstanceName(insts[i], def), -1);
+      out.scene.nodes[child_node].has_matrix = true;
+      NormalizeHomogeneous(ix.values, out.scene.nodes[child_node].matrix);
+      out.scene.nodes[node].children.push_back(child_node);
+
+      const SUResult r = ExportEntitiesHierarchy(child, def, child_node, &identity, texture_writer, out, state);
+      if (r != SU_ERROR_NONE) return r;
+    }
+  }
+
+  return SU_ERROR_NONE;
+}
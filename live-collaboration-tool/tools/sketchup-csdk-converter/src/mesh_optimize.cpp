@@ -0,0 +1,285 @@
+#include "mesh_optimize.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// timestamp 기반 FIFO 캐시 시뮬레이터. 정점 v는 마지막으로 들어온 뒤 cache_size번 미만의
+// miss가 있었으면 캐시에 남아 있는 것으로 봅니다.
+class FifoCache {
+ public:
+  FifoCache(size_t vertex_count, unsigned cache_size)
+      : stamp_(vertex_count, 0), size_(cache_size), time_(cache_size + 1) {}
+
+  // miss면 true (정점을 캐시에 넣음)
+  bool access(uint32_t v) {
+    if (time_ - stamp_[v] <= size_) return false;
+    stamp_[v] = time_++;
+    return true;
+  }
+
+  unsigned triangle_misses(const uint32_t* tri) {
+    return static_cast<unsigned>(access(tri[0])) + access(tri[1]) + access(tri[2]);
+  }
+
+  // 모든 정점을 캐시에서 비웁니다.
+  void reset() { time_ += size_ + 1; }
+
+ private:
+  std::vector<uint32_t> stamp_;
+  uint32_t size_;
+  uint32_t time_;
+};
+
+// 정점 → 그 정점을 쓰는 삼각형 목록 (CSR)
+struct Adjacency {
+  std::vector<uint32_t> offsets;    // vertex_count + 1
+  std::vector<uint32_t> triangles;  // index_count
+  std::vector<uint32_t> counts;     // 정점별 삼각형 수
+
+  Adjacency(const std::vector<uint32_t>& indices, size_t vertex_count)
+      : offsets(vertex_count + 1, 0), triangles(indices.size()), counts(vertex_count, 0) {
+    for (uint32_t v : indices) counts[v]++;
+    for (size_t v = 0; v < vertex_count; v++) offsets[v + 1] = offsets[v] + counts[v];
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++) triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+  }
+};
+
+void Sub3(const float* a, const float* b, double* out) {
+  for (int k = 0; k < 3; k++) out[k] = static_cast<double>(a[k]) - b[k];
+}
+
+}  // namespace
+
+VertexCacheStats AnalyzeVertexCache(
+    const std::vector<uint32_t>& indices, size_t vertex_count, unsigned cache_size) {
+  VertexCacheStats s;
+  s.triangles = indices.size() / 3;
+  if (s.triangles == 0) return s;
+
+  FifoCache cache(vertex_count, cache_size);
+  std::vector<char> seen(vertex_count, 0);
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    s.transformed += cache.triangle_misses(&indices[i]);
+    for (int k = 0; k < 3; k++) {
+      if (!seen[indices[i + k]]) {
+        seen[indices[i + k]] = 1;
+        s.vertices++;
+      }
+    }
+  }
+  s.acmr = static_cast<double>(s.transformed) / s.triangles;
+  s.atvr = s.vertices ? static_cast<double>(s.transformed) / s.vertices : 0.0;
+  return s;
+}
+
+void OptimizeVertexCache(std::vector<uint32_t>* indices, size_t vertex_count, unsigned cache_size) {
+  const size_t triangle_count = indices->size() / 3;
+  if (triangle_count == 0 || vertex_count == 0) return;
+  const std::vector<uint32_t>& in = *indices;
+
+  Adjacency adj(in, vertex_count);
+  std::vector<uint32_t> live = adj.counts;  // 아직 출력하지 않은 인접 삼각형 수
+  std::vector<uint32_t> stamp(vertex_count, 0);
+  uint32_t time = cache_size + 1;
+  std::vector<char> emitted(triangle_count, 0);
+  std::vector<uint32_t> dead_end;  // 최근 출력한 정점 스택 (막혔을 때 되돌아갈 후보)
+  std::vector<uint32_t> candidates;
+  size_t cursor = 0;
+
+  std::vector<uint32_t> out;
+  out.reserve(in.size());
+
+  int64_t fan = in[0];
+  while (fan >= 0) {
+    // fan 정점에 붙은 삼각형을 모두 출력
+    candidates.clear();
+    for (uint32_t a = adj.offsets[fan]; a < adj.offsets[fan + 1]; a++) {
+      const uint32_t t = adj.triangles[a];
+      if (emitted[t]) continue;
+      emitted[t] = 1;
+      for (int k = 0; k < 3; k++) {
+        const uint32_t v = in[t * 3 + k];
+        out.push_back(v);
+        dead_end.push_back(v);
+        candidates.push_back(v);
+        live[v]--;
+        if (time - stamp[v] > cache_size) stamp[v] = time++;
+      }
+    }
+
+    // 다음 fan: 남은 삼각형을 다 출력해도 캐시에 남아 있을 정점 중 가장 오래된 것
+    fan = -1;
+    int64_t best_priority = -1;
+    for (uint32_t v : candidates) {
+      if (live[v] == 0) continue;
+      int64_t priority = 0;
+      if (time - stamp[v] + 2 * live[v] <= cache_size) priority = time - stamp[v];
+      if (priority > best_priority) {
+        best_priority = priority;
+        fan = v;
+      }
+    }
+    if (fan >= 0) continue;
+
+    // 막힘: 최근 정점 스택 → 그래도 없으면 입력 순서로 다음 정점
+    while (!dead_end.empty()) {
+      const uint32_t d = dead_end.back();
+      dead_end.pop_back();
+      if (live[d] > 0) {
+        fan = d;
+        break;
+      }
+    }
+    if (fan >= 0) continue;
+    while (cursor < vertex_count) {
+      if (live[cursor] > 0) {
+        fan = static_cast<int64_t>(cursor);
+        break;
+      }
+      cursor++;
+    }
+  }
+
+  indices->swap(out);
+}
+
+void OptimizeOverdraw(
+    std::vector<uint32_t>* indices, const std::vector<float>& positions, float threshold, unsigned cache_size) {
+  const size_t triangle_count = indices->size() / 3;
+  const size_t vertex_count = positions.size() / 3;
+  if (triangle_count < 2 || vertex_count == 0) return;
+  const std::vector<uint32_t>& in = *indices;
+
+  // 1) hard 경계: 세 정점이 모두 miss인 삼각형 (캐시가 새로 시작되는 지점)
+  std::vector<size_t> hard;
+  {
+    FifoCache cache(vertex_count, cache_size);
+    for (size_t t = 0; t < triangle_count; t++) {
+      if (cache.triangle_misses(&in[t * 3]) == 3) hard.push_back(t);
+    }
+    if (hard.empty() || hard[0] != 0) hard.insert(hard.begin(), 0);
+  }
+
+  // 2) soft 경계: 클러스터 앞부분의 ACMR이 클러스터 전체의 threshold배 이하가 되면 끊습니다.
+  std::vector<size_t> starts;
+  {
+    FifoCache cache(vertex_count, cache_size);
+    for (size_t c = 0; c < hard.size(); c++) {
+      const size_t begin = hard[c];
+      const size_t end = c + 1 < hard.size() ? hard[c + 1] : triangle_count;
+
+      cache.reset();
+      size_t cluster_misses = 0;
+      for (size_t t = begin; t < end; t++) cluster_misses += cache.triangle_misses(&in[t * 3]);
+      const double limit = threshold * static_cast<double>(cluster_misses) / (end - begin);
+
+      cache.reset();
+      starts.push_back(begin);
+      size_t misses = 0;
+      size_t run_start = begin;
+      for (size_t t = begin; t < end; t++) {
+        misses += cache.triangle_misses(&in[t * 3]);
+        const size_t run = t + 1 - run_start;
+        if (t + 1 < end && static_cast<double>(misses) <= limit * run) {
+          starts.push_back(t + 1);
+          run_start = t + 1;
+          misses = 0;
+          cache.reset();
+        }
+      }
+    }
+  }
+
+  // 3) 클러스터 정렬 키: dot(클러스터 중심 - 메시 중심, 클러스터 법선). 바깥을 향하는 클러스터가 먼저.
+  double mesh_center[3] = {0, 0, 0};
+  for (uint32_t v : in) {
+    for (int k = 0; k < 3; k++) mesh_center[k] += positions[v * 3 + k];
+  }
+  for (int k = 0; k < 3; k++) mesh_center[k] /= static_cast<double>(in.size());
+
+  struct Cluster {
+    size_t begin;
+    size_t end;
+    double key;
+  };
+  std::vector<Cluster> clusters;
+  clusters.reserve(starts.size());
+  for (size_t c = 0; c < starts.size(); c++) {
+    Cluster cl{starts[c], c + 1 < starts.size() ? starts[c + 1] : triangle_count, 0.0};
+    double normal[3] = {0, 0, 0};
+    double center[3] = {0, 0, 0};
+    double area_sum = 0.0;
+    for (size_t t = cl.begin; t < cl.end; t++) {
+      const float* p0 = &positions[in[t * 3 + 0] * 3];
+      const float* p1 = &positions[in[t * 3 + 1] * 3];
+      const float* p2 = &positions[in[t * 3 + 2] * 3];
+      double e1[3], e2[3];
+      Sub3(p1, p0, e1);
+      Sub3(p2, p0, e2);
+      const double n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2],
+                           e1[0] * e2[1] - e1[1] * e2[0]};
+      const double area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      for (int k = 0; k < 3; k++) {
+        normal[k] += n[k];
+        center[k] += area * (static_cast<double>(p0[k]) + p1[k] + p2[k]) / 3.0;
+      }
+      area_sum += area;
+    }
+    const double nlen = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    if (area_sum > 0.0 && nlen > 0.0) {
+      for (int k = 0; k < 3; k++) {
+        cl.key += (center[k] / area_sum - mesh_center[k]) * (normal[k] / nlen);
+      }
+    }
+    clusters.push_back(cl);
+  }
+  std::stable_sort(clusters.begin(), clusters.end(),
+                   [](const Cluster& a, const Cluster& b) { return a.key > b.key; });
+
+  std::vector<uint32_t> out;
+  out.reserve(in.size());
+  for (const Cluster& cl : clusters) {
+    out.insert(out.end(), in.begin() + cl.begin * 3, in.begin() + cl.end * 3);
+  }
+  indices->swap(out);
+}
+
+std::vector<uint32_t> OptimizeVertexFetch(
+    std::vector<uint32_t>* indices, size_t vertex_count, size_t* new_vertex_count) {
+  std::vector<uint32_t> remap(vertex_count, kUnusedVertex);
+  uint32_t next = 0;
+  for (uint32_t& v : *indices) {
+    if (remap[v] == kUnusedVertex) remap[v] = next++;
+    v = remap[v];
+  }
+  if (new_vertex_count) *new_vertex_count = next;
+  return remap;
+}
+
+void RemapVertexAttribute(
+    std::vector<float>* values, int components, const std::vector<uint32_t>& remap, size_t new_vertex_count) {
+  std::vector<float> out(new_vertex_count * components);
+  for (size_t v = 0; v < remap.size(); v++) {
+    if (remap[v] == kUnusedVertex) continue;
+    std::copy(values->begin() + v * components, values->begin() + (v + 1) * components,
+              out.begin() + static_cast<size_t>(remap[v]) * components);
+  }
+  values->swap(out);
+}
+
+void OptimizePrimitive(GltfPrimitive* prim) {
+  if (prim->indices.empty()) return;
+  const size_t vertex_count = prim->vertex_count();
+
+  OptimizeVertexCache(&prim->indices, vertex_count);
+  OptimizeOverdraw(&prim->indices, prim->positions);
+
+  size_t new_count = 0;
+  const std::vector<uint32_t> remap = OptimizeVertexFetch(&prim->indices, vertex_count, &new_count);
+  RemapVertexAttribute(&prim->positions, 3, remap, new_count);
+  if (prim->normals.size() == vertex_count * 3) RemapVertexAttribute(&prim->normals, 3, remap, new_count);
+  if (prim->texcoords.size() == vertex_count * 2) RemapVertexAttribute(&prim->texcoords, 2, remap, new_count);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// 용접된 인덱스 버퍼 후처리: 정점 캐시 / overdraw / 정점 fetch 순서 최적화.
+// - 정점 캐시: Tipsify (Sander et al. 2007, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw")
+// - overdraw: 캐시 경계로 나눈 삼각형 클러스터를 바깥을 향하는 순서로 정렬 (같은 논문)
+// - fetch: 인덱스 버퍼에서 처음 쓰이는 순서대로 정점을 재배치
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gltf_scene.h"
+
+// 대부분의 GPU post-transform 캐시를 FIFO 16 정도로 보고 최적화/측정합니다.
+constexpr unsigned kDefaultVertexCacheSize = 16;
+
+struct VertexCacheStats {
+  size_t triangles = 0;
+  size_t vertices = 0;     // 인덱스 버퍼가 참조하는 서로 다른 정점 수
+  size_t transformed = 0;  // FIFO 캐시 miss (정점 셰이더 실행 수)
+  double acmr = 0.0;       // transformed / triangles (최소 ~0.5, 최악 3)
+  double atvr = 0.0;       // transformed / vertices (최소 1)
+};
+
+// FIFO 캐시를 시뮬레이션해 ACMR/ATVR을 계산합니다.
+VertexCacheStats AnalyzeVertexCache(
+    const std::vector<uint32_t>& indices, size_t vertex_count, unsigned cache_size = kDefaultVertexCacheSize);
+
+// 삼각형 순서를 바꿔 정점 캐시 재사용을 높입니다. (Tipsify)
+void OptimizeVertexCache(
+    std::vector<uint32_t>* indices, size_t vertex_count, unsigned cache_size = kDefaultVertexCacheSize);
+
+// OptimizeVertexCache 이후에 호출합니다. ACMR을 threshold배까지만 희생하며 클러스터 단위로
+// 바깥쪽을 향하는 면이 먼저 그려지도록 정렬해 overdraw를 줄입니다. positions는 xyz.
+void OptimizeOverdraw(
+    std::vector<uint32_t>* indices,
+    const std::vector<float>& positions,
+    float threshold = 1.05f,
+    unsigned cache_size = kDefaultVertexCacheSize);
+
+// 인덱스 버퍼에서 처음 참조되는 순서대로 정점 번호를 다시 매기고 indices를 갱신합니다.
+// 반환값은 old → new 매핑 (참조되지 않는 정점은 kUnusedVertex), *new_vertex_count에 새 정점 수.
+constexpr uint32_t kUnusedVertex = 0xFFFFFFFFu;
+std::vector<uint32_t> OptimizeVertexFetch(
+    std::vector<uint32_t>* indices, size_t vertex_count, size_t* new_vertex_count);
+
+// OptimizeVertexFetch의 매핑으로 정점 속성 배열(components개씩)을 재배치합니다.
+void RemapVertexAttribute(
+    std::vector<float>* values, int components, const std::vector<uint32_t>& remap, size_t new_vertex_count);
+
+// primitive 하나에 정점 캐시 → overdraw → fetch 순서로 모두 적용합니다.
+void OptimizePrimitive(GltfPrimitive* prim);
@@ -0,0 +1,135 @@
+#include "mesh_quantize.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+constexpr double kShortMax = 32767.0;
+constexpr double kByteMax = 127.0;
+constexpr double kRadToDeg = 57.29577951308232;
+
+int QuantizeSnorm(double v, double max) {
+  v = std::max(-1.0, std::min(1.0, v));
+  return static_cast<int>(v * max + (v >= 0.0 ? 0.5 : -0.5));
+}
+
+// 두 방향 사이 각도 (도). 길이가 0이면 0
+double AngleDegrees(const double a[3], const double b[3]) {
+  const double la = std::sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+  const double lb = std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
+  if (la == 0.0 || lb == 0.0) return 0.0;
+  const double c = (a[0] * b[0] + a[1] * b[1] + a[2] * b[2]) / (la * lb);
+  return std::acos(std::max(-1.0, std::min(1.0, c))) * kRadToDeg;
+}
+
+// EXT_meshopt_compression OCTAHEDRAL 필터 디코더 (명세의 참조 구현과 같은 계산)
+void DecodeOctahedral(const int8_t in[4], double out[3]) {
+  float x = in[0];
+  float y = in[1];
+  const float z = static_cast<float>(in[2]) - std::fabs(x) - std::fabs(y);
+  const float t = z >= 0.0f ? 0.0f : z;
+  x += x >= 0.0f ? t : -t;
+  y += y >= 0.0f ? t : -t;
+  const float l = std::sqrt(x * x + y * y + z * z);
+  const float s = l > 0.0f ? static_cast<float>(kByteMax) / l : 0.0f;
+  out[0] = static_cast<int>(x * s + (x >= 0.0f ? 0.5f : -0.5f)) / kByteMax;
+  out[1] = static_cast<int>(y * s + (y >= 0.0f ? 0.5f : -0.5f)) / kByteMax;
+  out[2] = static_cast<int>(z * s + (z >= 0.0f ? 0.5f : -0.5f)) / kByteMax;
+}
+
+}  // namespace
+
+PositionQuantization ComputePositionQuantization(const GltfMesh& mesh) {
+  double lo[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+  double hi[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+  for (const GltfPrimitive& prim : mesh.primitives) {
+    for (size_t i = 0; i + 2 < prim.positions.size(); i += 3) {
+      for (int c = 0; c < 3; c++) {
+        lo[c] = std::min(lo[c], static_cast<double>(prim.positions[i + c]));
+        hi[c] = std::max(hi[c], static_cast<double>(prim.positions[i + c]));
+      }
+    }
+  }
+  PositionQuantization q;
+  if (lo[0] > hi[0]) return q;
+  // 축마다 다른 스케일을 쓰면 node 변환이 비균일 스케일이 되어 normal이 틀어지므로 가장 긴 축 기준
+  double half = 0.0;
+  for (int c = 0; c < 3; c++) {
+    q.offset[c] = (lo[c] + hi[c]) * 0.5;
+    half = std::max(half, (hi[c] - lo[c]) * 0.5);
+  }
+  q.scale = half > 0.0 ? half / kShortMax : 1.0;
+  return q;
+}
+
+double QuantizePositions(
+    const std::vector<float>& positions, const PositionQuantization& q, std::vector<int16_t>* out) {
+  const size_t count = positions.size() / 3;
+  out->assign(count * 4, 0);
+  double max_error = 0.0;
+  for (size_t i = 0; i < count; i++) {
+    for (int c = 0; c < 3; c++) {
+      const double p = positions[i * 3 + c];
+      const double v = std::round((p - q.offset[c]) / q.scale);
+      const double clamped = std::max(-kShortMax, std::min(kShortMax, v));
+      (*out)[i * 4 + c] = static_cast<int16_t>(clamped);
+      max_error = std::max(max_error, std::fabs(clamped * q.scale + q.offset[c] - p));
+    }
+  }
+  return max_error;
+}
+
+double QuantizeNormals(const std::vector<float>& normals, std::vector<int8_t>* out) {
+  const size_t count = normals.size() / 3;
+  out->assign(count * 4, 0);
+  double max_error = 0.0;
+  for (size_t i = 0; i < count; i++) {
+    const double n[3] = {normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]};
+    double d[3];
+    for (int c = 0; c < 3; c++) {
+      const int v = QuantizeSnorm(n[c], kByteMax);
+      (*out)[i * 4 + c] = static_cast<int8_t>(v);
+      d[c] = v / kByteMax;
+    }
+    max_error = std::max(max_error, AngleDegrees(n, d));
+  }
+  return max_error;
+}
+
+double EncodeOctahedralNormals(const std::vector<float>& normals, std::vector<int8_t>* out) {
+  const size_t count = normals.size() / 3;
+  out->assign(count * 4, 0);
+  double max_error = 0.0;
+  for (size_t i = 0; i < count; i++) {
+    const double n[3] = {normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]};
+    // 팔면체 투영 후 z < 0인 반구를 접어 넣습니다.
+    const double l1 = std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]);
+    const double inv = l1 == 0.0 ? 0.0 : 1.0 / l1;
+    const double nx = n[0] * inv;
+    const double ny = n[1] * inv;
+    const double u = n[2] >= 0.0 ? nx : (1.0 - std::fabs(ny)) * (nx >= 0.0 ? 1.0 : -1.0);
+    const double v = n[2] >= 0.0 ? ny : (1.0 - std::fabs(nx)) * (ny >= 0.0 ? 1.0 : -1.0);
+    int8_t* e = &(*out)[i * 4];
+    e[0] = static_cast<int8_t>(QuantizeSnorm(u, kByteMax));
+    e[1] = static_cast<int8_t>(QuantizeSnorm(v, kByteMax));
+    e[2] = static_cast<int8_t>(kByteMax);  // u/v의 스케일 (1.0)
+    double d[3];
+    DecodeOctahedral(e, d);
+    max_error = std::max(max_error, AngleDegrees(n, d));
+  }
+  return max_error;
+}
+
+double QuantizeTexcoords(const std::vector<float>& texcoords, double range, std::vector<int16_t>* out) {
+  out->assign(texcoords.size(), 0);
+  if (range <= 0.0) range = 1.0;
+  double max_error = 0.0;
+  for (size_t i = 0; i < texcoords.size(); i++) {
+    const int v = QuantizeSnorm(texcoords[i] / range, kShortMax);
+    (*out)[i] = static_cast<int16_t>(v);
+    max_error = std::max(max_error, std::fabs(v / kShortMax * range - texcoords[i]));
+  }
+  return max_error;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// KHR_mesh_quantization용 정점 속성 양자화.
+// - position: mesh 바운딩 박스 중심 기준 int16 (균일 스케일, node/인스턴스 변환으로 복원)
+// - normal: int8 정규화 xyz, 또는 EXT_meshopt_compression OCTAHEDRAL 필터용 8비트 octahedral
+// - texcoord: 범위 [-range, range]를 int16 정규화 (KHR_texture_transform scale로 복원)
+// 모든 출력은 요소당 4바이트 배수(패딩 포함)라 bufferView byteStride 규칙을 만족합니다.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gltf_scene.h"
+
+// 원래 position = q * scale + offset
+struct PositionQuantization {
+  double offset[3] = {0.0, 0.0, 0.0};
+  double scale = 1.0;
+};
+
+// mesh의 모든 primitive position을 덮는 양자화 기준을 계산합니다.
+PositionQuantization ComputePositionQuantization(const GltfMesh& mesh);
+
+// xyz + 패딩 (정점당 int16 4개). 반환값은 최대 오차 (모델 단위)
+double QuantizePositions(
+    const std::vector<float>& positions, const PositionQuantization& q, std::vector<int16_t>* out);
+
+// xyz + 패딩 (정점당 int8 4개, 정규화). 반환값은 최대 각도 오차 (도)
+double QuantizeNormals(const std::vector<float>& normals, std::vector<int8_t>* out);
+
+// meshopt OCTAHEDRAL 필터 입력 (정점당 int8 4개: u, v, 1, 0).
+// 디코더가 필터를 적용하면 QuantizeNormals와 같은 형식이 됩니다. 반환값은 최대 각도 오차 (도)
+double EncodeOctahedralNormals(const std::vector<float>& normals, std::vector<int8_t>* out);
+
+// uv를 [-range, range] → int16 정규화로 기록 (정점당 2개). 반환값은 최대 오차 (텍스처 반복 단위)
+double QuantizeTexcoords(const std::vector<float>& texcoords, double range, std::vector<int16_t>* out);
@@ -0,0 +1,425 @@
+#include "mesh_simplify.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+constexpr uint32_t kNone = 0xFFFFFFFFu;
+// seam/경계 edge의 수직 평면 quadric 가중치 (면 quadric은 면적, edge는 길이^2 * 이 값)
+constexpr double kEdgeWeight = 10.0;
+
+enum VertexKind : uint8_t { kManifold, kBorder, kSeam, kLocked };
+
+struct Quadric {
+  double a00 = 0.0, a11 = 0.0, a22 = 0.0, a10 = 0.0, a20 = 0.0, a21 = 0.0;
+  double b0 = 0.0, b1 = 0.0, b2 = 0.0, c = 0.0;
+  double weight = 0.0;
+
+  // 평면 n·p + d = 0 (n은 단위 벡터)
+  void add_plane(const double n[3], double d, double w) {
+    a00 += w * n[0] * n[0];
+    a11 += w * n[1] * n[1];
+    a22 += w * n[2] * n[2];
+    a10 += w * n[1] * n[0];
+    a20 += w * n[2] * n[0];
+    a21 += w * n[2] * n[1];
+    b0 += w * n[0] * d;
+    b1 += w * n[1] * d;
+    b2 += w * n[2] * d;
+    c += w * d * d;
+    weight += w;
+  }
+
+  void add(const Quadric& q) {
+    a00 += q.a00;
+    a11 += q.a11;
+    a22 += q.a22;
+    a10 += q.a10;
+    a20 += q.a20;
+    a21 += q.a21;
+    b0 += q.b0;
+    b1 += q.b1;
+    b2 += q.b2;
+    c += q.c;
+    weight += q.weight;
+  }
+
+  // p까지의 가중 평균 제곱 거리
+  double error(const double* p) const {
+    const double x = p[0], y = p[1], z = p[2];
+    const double r = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a10 * x * y + a20 * x * z + a21 * y * z) +
+                     2.0 * (b0 * x + b1 * y + b2 * z) + c;
+    return weight > 0.0 ? std::fabs(r) / weight : 0.0;
+  }
+};
+
+struct PositionKey {
+  uint32_t bits[3];
+  bool operator==(const PositionKey& o) const {
+    return bits[0] == o.bits[0] && bits[1] == o.bits[1] && bits[2] == o.bits[2];
+  }
+};
+
+struct PositionKeyHash {
+  size_t operator()(const PositionKey& k) const {
+    uint64_t h = k.bits[0] * 0x9E3779B97F4A7C15ull;
+    h ^= (h >> 29) + k.bits[1] * 0xBF58476D1CE4E5B9ull;
+    h ^= (h >> 31) + k.bits[2] * 0x94D049BB133111EBull;
+    return static_cast<size_t>(h ^ (h >> 32));
+  }
+};
+
+// 정점 → 그 정점을 쓰는 삼각형 (CSR)
+struct Adjacency {
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> triangles;
+
+  void build(const std::vector<uint32_t>& indices, size_t vertex_count) {
+    offsets.assign(vertex_count + 1, 0);
+    for (uint32_t v : indices) offsets[v + 1]++;
+    for (size_t i = 0; i < vertex_count; i++) offsets[i + 1] += offsets[i];
+    triangles.resize(indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++) triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+  }
+};
+
+// a → b half-edge가 있는지
+bool HasEdge(const Adjacency& adj, const std::vector<uint32_t>& indices, uint32_t a, uint32_t b) {
+  for (uint32_t k = adj.offsets[a]; k < adj.offsets[a + 1]; k++) {
+    const uint32_t* t = &indices[adj.triangles[k] * 3];
+    if ((t[0] == a && t[1] == b) || (t[1] == a && t[2] == b) || (t[2] == a && t[0] == b)) return true;
+  }
+  return false;
+}
+
+// 정점 공간에서 반대 방향이 없는 half-edge (경계, seam).
+// open_out[v]: v → x가 하나면 x, 없으면 kNone, 여럿이면 v. open_in도 같은 규칙
+void ComputeOpenEdges(const Adjacency& adj, const std::vector<uint32_t>& indices, std::vector<uint32_t>* open_out,
+                      std::vector<uint32_t>* open_in) {
+  std::fill(open_out->begin(), open_out->end(), kNone);
+  std::fill(open_in->begin(), open_in->end(), kNone);
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    for (int k = 0; k < 3; k++) {
+      const uint32_t a = indices[i + k];
+      const uint32_t b = indices[i + (k + 1) % 3];
+      if (HasEdge(adj, indices, b, a)) continue;
+      (*open_out)[a] = (*open_out)[a] == kNone ? b : a;
+      (*open_in)[b] = (*open_in)[b] == kNone ? a : b;
+    }
+  }
+}
+
+void Cross(const double* a, const double* b, const double* c, double n[3]) {
+  const double u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+  const double v[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+  n[0] = u[1] * v[2] - u[2] * v[1];
+  n[1] = u[2] * v[0] - u[0] * v[2];
+  n[2] = u[0] * v[1] - u[1] * v[0];
+}
+
+struct Collapse {
+  uint32_t from = kNone;
+  uint32_t to = kNone;
+  // seam collapse: 같은 위치의 짝 정점도 함께 옮김
+  uint32_t sibling_from = kNone;
+  uint32_t sibling_to = kNone;
+  double error = std::numeric_limits<double>::max();
+};
+
+}  // namespace
+
+std::vector<uint32_t> SimplifyIndices(const std::vector<float>& positions,
+                                      const std::vector<uint32_t>& indices,
+                                      size_t target_index_count,
+                                      double max_error,
+                                      double* result_error) {
+  if (result_error) *result_error = 0.0;
+  const size_t n = positions.size() / 3;
+  if (n == 0 || indices.size() <= target_index_count) return indices;
+
+  // 바운딩 박스 긴 변을 1로 정규화 (오차가 크기와 무관해짐)
+  double lo[3] = {positions[0], positions[1], positions[2]};
+  double hi[3] = {lo[0], lo[1], lo[2]};
+  for (size_t i = 0; i < n; i++) {
+    for (int k = 0; k < 3; k++) {
+      lo[k] = std::min(lo[k], static_cast<double>(positions[i * 3 + k]));
+      hi[k] = std::max(hi[k], static_cast<double>(positions[i * 3 + k]));
+    }
+  }
+  const double extent = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+  const double scale = extent > 0.0 ? 1.0 / extent : 1.0;
+  std::vector<double> pos(n * 3);
+  for (size_t i = 0; i < n * 3; i++) pos[i] = (positions[i] - lo[i % 3]) * scale;
+
+  // remap: 위치가 같은 정점 중 첫 번째. wedge: 위치가 같은 정점끼리의 순환 목록
+  std::vector<uint32_t> remap(n);
+  std::vector<uint32_t> wedge(n);
+  {
+    std::unordered_map<PositionKey, uint32_t, PositionKeyHash> first;
+    first.reserve(n);
+    for (uint32_t i = 0; i < n; i++) {
+      PositionKey key;
+      for (int k = 0; k < 3; k++) {
+        const float v = positions[i * 3 + k] + 0.0f;  // -0 → +0
+        std::memcpy(&key.bits[k], &v, sizeof(v));
+      }
+      const uint32_t r = first.emplace(key, i).first->second;
+      remap[i] = r;
+      if (r == i) {
+        wedge[i] = i;
+      } else {
+        wedge[i] = wedge[r];
+        wedge[r] = i;
+      }
+    }
+  }
+
+  // 같은 위치를 두 번 쓰는 (면적 0) 삼각형은 버립니다.
+  std::vector<uint32_t> result;
+  result.reserve(indices.size());
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+    if (remap[a] == remap[b] || remap[b] == remap[c] || remap[c] == remap[a]) continue;
+    result.insert(result.end(), {a, b, c});
+  }
+
+  Adjacency adj;
+  adj.build(result, n);
+  std::vector<uint32_t> open_out(n);
+  std::vector<uint32_t> open_in(n);
+  ComputeOpenEdges(adj, result, &open_out, &open_in);
+
+  // 정점 종류는 처음 한 번만 정합니다. (collapse는 경계/seam 모양을 바꾸지 않음)
+  std::vector<uint8_t> kind(n, kLocked);
+  for (uint32_t i = 0; i < n; i++) {
+    const uint32_t oi = open_in[i], oo = open_out[i];
+    if (wedge[i] == i) {
+      if (oi == kNone && oo == kNone) {
+        kind[i] = kManifold;
+      } else if (oi != kNone && oi != i && oo != kNone && oo != i) {
+        kind[i] = kBorder;
+      }
+    } else if (wedge[wedge[i]] == i) {
+      // seam: 두 정점 모두 열린 half-edge가 한 방향씩 있고, 위치 기준으로 서로 맞물려야 함
+      const uint32_t w = wedge[i];
+      const uint32_t wi = open_in[w], wo = open_out[w];
+      if (oi != kNone && oi != i && oo != kNone && oo != i && wi != kNone && wi != w && wo != kNone && wo != w &&
+          remap[oi] == remap[wo] && remap[oo] == remap[wi] && remap[oi] != remap[oo]) {
+        kind[i] = kSeam;
+      }
+    }
+  }
+
+  // 위치별 quadric: 면 평면(면적 가중) + 경계/seam edge의 수직 평면
+  std::vector<Quadric> quadrics(n);
+  for (size_t i = 0; i < result.size(); i += 3) {
+    const uint32_t v[3] = {result[i], result[i + 1], result[i + 2]};
+    double normal[3];
+    Cross(&pos[v[0] * 3], &pos[v[1] * 3], &pos[v[2] * 3], normal);
+    const double len = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    if (len == 0.0) continue;
+    for (double& c : normal) c /= len;
+    const double* p0 = &pos[v[0] * 3];
+    const double d = -(normal[0] * p0[0] + normal[1] * p0[1] + normal[2] * p0[2]);
+    for (uint32_t k : v) quadrics[remap[k]].add_plane(normal, d, len * 0.5);
+
+    for (int k = 0; k < 3; k++) {
+      const uint32_t a = v[k];
+      const uint32_t b = v[(k + 1) % 3];
+      if (HasEdge(adj, result, b, a)) continue;
+      const double* pa = &pos[a * 3];
+      const double* pb = &pos[b * 3];
+      const double e[3] = {pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2]};
+      double en[3] = {e[1] * normal[2] - e[2] * normal[1], e[2] * normal[0] - e[0] * normal[2],
+                      e[0] * normal[1] - e[1] * normal[0]};
+      const double elen = std::sqrt(en[0] * en[0] + en[1] * en[1] + en[2] * en[2]);
+      if (elen == 0.0) continue;
+      for (double& c : en) c /= elen;
+      const double ed = -(en[0] * pa[0] + en[1] * pa[1] + en[2] * pa[2]);
+      const double w = (e[0] * e[0] + e[1] * e[1] + e[2] * e[2]) * kEdgeWeight;
+      quadrics[remap[a]].add_plane(en, ed, w);
+      quadrics[remap[b]].add_plane(en, ed, w);
+    }
+  }
+
+  std::vector<uint32_t> collapse_remap(n);
+  std::vector<uint8_t> locked(n);
+  std::vector<Collapse> candidates;
+  const double max_error_sq = max_error * max_error;
+  double worst = 0.0;
+
+  // from → to가 허용되면 best보다 오차가 작을 때 best를 바꿉니다.
+  auto consider = [&](uint32_t from, uint32_t to, Collapse* best) {
+    const uint8_t kf = kind[from];
+    const uint8_t kt = kind[to];
+    uint32_t sf = kNone;
+    uint32_t st = kNone;
+    if (kf == kLocked) return;
+    if (kf == kBorder) {
+      // 경계는 경계 edge를 따라서만
+      if (kt != kBorder && kt != kLocked) return;
+      if (open_out[from] != to && open_in[from] != to) return;
+    } else if (kf == kSeam) {
+      // seam은 seam edge를 따라, 짝 정점도 반대쪽의 같은 위치로
+      if (kt != kSeam && kt != kLocked) return;
+      sf = wedge[from];
+      if (open_out[from] == to) {
+        st = open_in[sf];
+      } else if (open_in[from] == to) {
+        st = open_out[sf];
+      } else {
+        return;
+      }
+      if (st == kNone || st == sf || remap[st] != remap[to]) return;
+    }
+    const double error = quadrics[remap[from]].error(&pos[to * 3]);
+    if (error < best->error) *best = Collapse{from, to, sf, st, error};
+  };
+
+  // from을 to 위치로 옮기면 뒤집히는 삼각형이 있는지 (이번 pass에서 이미 한 collapse 반영)
+  auto flips = [&](const Collapse& c) {
+    const double* pt = &pos[c.to * 3];
+    uint32_t v = c.from;
+    do {
+      for (uint32_t k = adj.offsets[v]; k < adj.offsets[v + 1]; k++) {
+        const uint32_t* t = &result[adj.triangles[k] * 3];
+        const uint32_t tv[3] = {collapse_remap[t[0]], collapse_remap[t[1]], collapse_remap[t[2]]};
+        int corner = -1;
+        bool has_to = false;
+        for (int j = 0; j < 3; j++) {
+          if (remap[tv[j]] == remap[c.to]) has_to = true;
+          if (remap[tv[j]] == remap[c.from]) corner = j;
+        }
+        if (has_to || corner < 0) continue;  // 없어지는 삼각형
+        const double* pf = &pos[tv[corner] * 3];
+        const double* p1 = &pos[tv[(corner + 1) % 3] * 3];
+        const double* p2 = &pos[tv[(corner + 2) % 3] * 3];
+        double before[3];
+        double after[3];
+        Cross(pf, p1, p2, before);
+        Cross(pt, p1, p2, after);
+        if (before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0) return true;
+      }
+      v = wedge[v];
+    } while (v != c.from);
+    return false;
+  };
+
+  // pass마다: 후보 collapse를 오차 순으로 정렬하고, 서로 겹치지 않는 것만 적용
+  while (result.size() > target_index_count) {
+    candidates.clear();
+    for (size_t i = 0; i < result.size(); i += 3) {
+      for (int k = 0; k < 3; k++) {
+        const uint32_t a = result[i + k];
+        const uint32_t b = result[i + (k + 1) % 3];
+        // 닫힌 edge는 양쪽 삼각형에서 두 번 나오므로 한 번만
+        if (remap[a] > remap[b] && HasEdge(adj, result, b, a)) continue;
+        Collapse best;
+        consider(a, b, &best);
+        consider(b, a, &best);
+        if (best.from != kNone && best.error <= max_error_sq) candidates.push_back(best);
+      }
+    }
+    if (candidates.empty()) break;
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+    for (uint32_t i = 0; i < n; i++) collapse_remap[i] = i;
+    std::fill(locked.begin(), locked.end(), 0);
+    const size_t goal = (result.size() - target_index_count) / 3;
+    size_t removed = 0;
+    size_t performed = 0;
+    for (const Collapse& c : candidates) {
+      if (removed >= goal) break;
+      if (locked[remap[c.from]] || locked[remap[c.to]]) continue;
+      if (flips(c)) continue;
+      collapse_remap[c.from] = c.to;
+      if (c.sibling_from != kNone) collapse_remap[c.sibling_from] = c.sibling_to;
+      quadrics[remap[c.to]].add(quadrics[remap[c.from]]);
+      locked[remap[c.from]] = 1;
+      locked[remap[c.to]] = 1;
+      removed += kind[c.from] == kBorder ? 1 : 2;
+      worst = std::max(worst, c.error);
+      performed++;
+    }
+    if (performed == 0) break;
+
+    size_t write = 0;
+    for (size_t i = 0; i < result.size(); i += 3) {
+      const uint32_t a = collapse_remap[result[i]];
+      const uint32_t b = collapse_remap[result[i + 1]];
+      const uint32_t c = collapse_remap[result[i + 2]];
+      if (remap[a] == remap[b] || remap[b] == remap[c] || remap[c] == remap[a]) continue;
+      result[write++] = a;
+      result[write++] = b;
+      result[write++] = c;
+    }
+    result.resize(write);
+    adj.build(result, n);
+    ComputeOpenEdges(adj, result, &open_out, &open_in);
+  }
+
+  if (result_error) *result_error = std::sqrt(worst);
+  return result;
+}
+
+GltfMesh SimplifyMesh(const GltfMesh& mesh, double target_ratio, double max_error, SimplifyStats* stats) {
+  // 모든 primitive를 이어 붙인 정점 공간. base[p]가 primitive p의 첫 정점
+  std::vector<float> positions;
+  std::vector<uint32_t> indices;
+  std::vector<uint32_t> base;
+  for (const GltfPrimitive& prim : mesh.primitives) {
+    base.push_back(static_cast<uint32_t>(positions.size() / 3));
+    positions.insert(positions.end(), prim.positions.begin(), prim.positions.end());
+    for (uint32_t index : prim.indices) indices.push_back(base.back() + index);
+  }
+  base.push_back(static_cast<uint32_t>(positions.size() / 3));
+
+  const size_t triangles = indices.size() / 3;
+  const size_t target = static_cast<size_t>(static_cast<double>(triangles) * target_ratio) * 3;
+  double error = 0.0;
+  const std::vector<uint32_t> simplified = SimplifyIndices(positions, indices, target, max_error, &error);
+
+  // 삼각형은 항상 한 primitive 안의 정점만 참조합니다 (collapse는 같은 삼각형의 정점끼리만).
+  std::vector<std::vector<uint32_t>> prim_indices(mesh.primitives.size());
+  for (size_t i = 0; i < simplified.size(); i += 3) {
+    const size_t p = std::upper_bound(base.begin(), base.end(), simplified[i]) - base.begin() - 1;
+    for (int k = 0; k < 3; k++) prim_indices[p].push_back(simplified[i + k] - base[p]);
+  }
+
+  GltfMesh out;
+  out.name = mesh.name;
+  for (size_t p = 0; p < mesh.primitives.size(); p++) {
+    if (prim_indices[p].empty()) continue;
+    const GltfPrimitive& src = mesh.primitives[p];
+    const bool has_normals = src.normals.size() == src.positions.size();
+    const bool has_texcoords = src.texcoords.size() / 2 == src.vertex_count();
+    GltfPrimitive dst;
+    dst.material = src.material;
+    std::vector<uint32_t> compact(src.vertex_count(), kNone);
+    for (uint32_t index : prim_indices[p]) {
+      if (compact[index] == kNone) {
+        compact[index] = static_cast<uint32_t>(dst.vertex_count());
+        dst.positions.insert(dst.positions.end(), &src.positions[index * 3], &src.positions[index * 3] + 3);
+        if (has_normals) dst.normals.insert(dst.normals.end(), &src.normals[index * 3], &src.normals[index * 3] + 3);
+        if (has_texcoords) {
+          dst.texcoords.insert(dst.texcoords.end(), &src.texcoords[index * 2], &src.texcoords[index * 2] + 2);
+        }
+      }
+      dst.indices.push_back(compact[index]);
+    }
+    out.primitives.push_back(std::move(dst));
+  }
+
+  if (stats) {
+    stats->triangles_before = triangles;
+    stats->triangles_after = simplified.size() / 3;
+    stats->error = error;
+  }
+  return out;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// LOD 생성용 quadric error metric 메시 단순화 (Garland & Heckbert 1997, "Surface Simplification Using
+// Quadric Error Metrics").
+// - half-edge collapse: 정점을 이웃 정점 위치로 합치기만 하므로 새 정점을 만들지 않고,
+//   남은 정점의 normal/uv는 원본 그대로입니다.
+// - 위치가 같은 정점이 두 개(uv/normal seam, material 경계)면 seam 정점으로 보고 seam을 따라서만
+//   두 정점을 함께 옮깁니다. 셋 이상이거나 seam 모양이 맞지 않으면 고정합니다.
+//   열린 경계의 정점은 경계를 따라서만 옮깁니다.
+// - seam/경계 edge에는 수직 평면 quadric을 더해 선 모양이 무너지지 않게 합니다.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gltf_scene.h"
+
+struct SimplifyStats {
+  size_t triangles_before = 0;
+  size_t triangles_after = 0;
+  double error = 0.0;  // 가장 큰 collapse 오차 (바운딩 박스 긴 변 대비 거리)
+};
+
+// positions는 xyz. 삼각형 목록 indices를 target_index_count 이하로 줄이되, 오차가 max_error
+// (바운딩 박스 긴 변 대비 거리)를 넘는 collapse는 하지 않습니다. 같은 정점 배열을 참조하는 새 인덱스를 반환합니다.
+std::vector<uint32_t> SimplifyIndices(const std::vector<float>& positions,
+                                      const std::vector<uint32_t>& indices,
+                                      size_t target_index_count,
+                                      double max_error,
+                                      double* result_error);
+
+// mesh의 모든 primitive를 한 정점 공간에서 함께 단순화해 삼각형을 target_ratio배로 줄입니다.
+// material 경계는 seam으로 취급되어 틈 없이 유지됩니다. 결과 primitive는 쓰이는 정점만 남기고,
+// 삼각형이 남지 않은 primitive는 뺍니다. stats는 nullptr 가능.
+GltfMesh SimplifyMesh(const GltfMesh& mesh, double target_ratio, double max_error, SimplifyStats* stats);
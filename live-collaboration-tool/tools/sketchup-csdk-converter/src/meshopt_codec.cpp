@@ -0,0 +1,156 @@
+#include "meshopt_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t kVertexHeader = 0xa0;    // ATTRIBUTES, version 0
+constexpr uint8_t kSequenceHeader = 0xd1;  // INDICES, version 1
+constexpr size_t kByteGroupSize = 16;
+constexpr size_t kVertexBlockSizeBytes = 8192;
+constexpr size_t kVertexBlockMaxSize = 256;
+constexpr size_t kTailMinSize = 32;
+
+// 블록 하나에 들어가는 요소 수 (16의 배수, 최대 256)
+size_t VertexBlockSize(size_t stride) {
+  const size_t n = (kVertexBlockSizeBytes / stride) & ~(kByteGroupSize - 1);
+  return std::min(n, kVertexBlockMaxSize);
+}
+
+uint8_t ZigZag8(uint8_t v) { return static_cast<uint8_t>((v << 1) ^ static_cast<uint8_t>(static_cast<int8_t>(v) >> 7)); }
+
+// 그룹(16바이트)을 bits 모드로 기록했을 때 크기. bits: 0 / 2 / 4 / 8
+size_t GroupSize(const uint8_t* g, int bits) {
+  if (bits == 0) {
+    for (size_t i = 0; i < kByteGroupSize; i++) {
+      if (g[i] != 0) return SIZE_MAX;
+    }
+    return 0;
+  }
+  if (bits == 8) return kByteGroupSize;
+  const uint8_t sentinel = static_cast<uint8_t>((1 << bits) - 1);
+  size_t size = kByteGroupSize * bits / 8;
+  for (size_t i = 0; i < kByteGroupSize; i++) size += g[i] >= sentinel;
+  return size;
+}
+
+// 값은 MSB부터 채우고, sentinel 이상인 값은 그룹 뒤에 원래 바이트로 덧붙입니다.
+void WriteGroup(std::vector<uint8_t>* out, const uint8_t* g, int bits) {
+  if (bits == 0) return;
+  if (bits == 8) {
+    out->insert(out->end(), g, g + kByteGroupSize);
+    return;
+  }
+  const uint8_t sentinel = static_cast<uint8_t>((1 << bits) - 1);
+  const size_t per_byte = 8 / bits;
+  for (size_t i = 0; i < kByteGroupSize; i += per_byte) {
+    uint8_t byte = 0;
+    for (size_t k = 0; k < per_byte; k++) {
+      const uint8_t v = g[i + k] >= sentinel ? sentinel : g[i + k];
+      byte = static_cast<uint8_t>((byte << bits) | v);
+    }
+    out->push_back(byte);
+  }
+  for (size_t i = 0; i < kByteGroupSize; i++) {
+    if (g[i] >= sentinel) out->push_back(g[i]);
+  }
+}
+
+// 바이트 열 하나(16의 배수 길이): 그룹마다 2비트 헤더 + 가장 작은 모드의 그룹 데이터
+void EncodeBytes(std::vector<uint8_t>* out, const uint8_t* buffer, size_t size) {
+  const size_t groups = size / kByteGroupSize;
+  const size_t header_at = out->size();
+  out->resize(out->size() + (groups + 3) / 4, 0);
+
+  static const int kBits[4] = {0, 2, 4, 8};
+  for (size_t g = 0; g < groups; g++) {
+    const uint8_t* group = buffer + g * kByteGroupSize;
+    int best = 3;
+    size_t best_size = kByteGroupSize;
+    for (int mode = 0; mode < 3; mode++) {
+      const size_t s = GroupSize(group, kBits[mode]);
+      if (s < best_size) {
+        best = mode;
+        best_size = s;
+      }
+    }
+    (*out)[header_at + g / 4] |= static_cast<uint8_t>(best << ((g % 4) * 2));
+    WriteGroup(out, group, kBits[best]);
+  }
+}
+
+void WriteVByte(std::vector<uint8_t>* out, uint32_t v) {
+  do {
+    out->push_back(static_cast<uint8_t>((v & 127) | (v > 127 ? 128 : 0)));
+    v >>= 7;
+  } while (v);
+}
+
+uint32_t ReadIndex(const uint8_t* p, size_t stride) {
+  if (stride == 2) return static_cast<uint32_t>(p[0] | (p[1] << 8));
+  uint32_t v = 0;
+  std::memcpy(&v, p, sizeof(v));  // little-endian 호스트 (glb_writer.cpp와 같은 전제)
+  return v;
+}
+
+}  // namespace
+
+std::vector<uint8_t> EncodeMeshoptAttributes(const uint8_t* data, size_t count, size_t stride) {
+  std::vector<uint8_t> out;
+  out.reserve(count * stride / 2 + kTailMinSize + 1);
+  out.push_back(kVertexHeader);
+  if (count == 0 || stride == 0) {
+    out.resize(out.size() + std::max(stride, kTailMinSize), 0);
+    return out;
+  }
+
+  // 첫 요소가 기준값(baseline): 첫 블록의 첫 delta는 0
+  std::vector<uint8_t> last(data, data + stride);
+  const size_t block = VertexBlockSize(stride);
+  std::vector<uint8_t> buffer(block);
+
+  for (size_t begin = 0; begin < count; begin += block) {
+    const size_t n = std::min(block, count - begin);
+    const size_t aligned = (n + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+    for (size_t k = 0; k < stride; k++) {
+      std::fill(buffer.begin(), buffer.begin() + aligned, 0);
+      uint8_t prev = last[k];
+      for (size_t i = 0; i < n; i++) {
+        const uint8_t cur = data[(begin + i) * stride + k];
+        buffer[i] = ZigZag8(static_cast<uint8_t>(cur - prev));
+        prev = cur;
+      }
+      EncodeBytes(&out, buffer.data(), aligned);
+    }
+    std::memcpy(last.data(), data + (begin + n - 1) * stride, stride);
+  }
+
+  // tail: 최소 32바이트가 되도록 앞을 0으로 채운 뒤 기준값
+  if (stride < kTailMinSize) out.resize(out.size() + (kTailMinSize - stride), 0);
+  out.insert(out.end(), data, data + stride);
+  return out;
+}
+
+std::vector<uint8_t> EncodeMeshoptIndices(const uint8_t* data, size_t count, size_t stride) {
+  std::vector<uint8_t> out;
+  out.reserve(1 + count * 2 + 4);
+  out.push_back(kSequenceHeader);
+
+  uint32_t last[2] = {0, 0};
+  uint32_t current = 0;
+  for (size_t i = 0; i < count; i++) {
+    const uint32_t index = ReadIndex(data + i * stride, stride);
+    // delta가 한 바이트(부호/기준값 비트 제외 5비트)를 넘으면 다른 기준값으로 전환
+    const int32_t cd = static_cast<int32_t>(index - last[current]);
+    current ^= static_cast<uint32_t>((cd < 0 ? -static_cast<int64_t>(cd) : cd) >= 30);
+
+    const uint32_t d = index - last[current];
+    const uint32_t v = (d << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(d) >> 31);
+    WriteVByte(&out, (v << 1) | current);
+    last[current] = index;
+  }
+
+  out.insert(out.end(), 4, 0);  // tail
+  return out;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// EXT_meshopt_compression 비트스트림 인코더.
+// - ATTRIBUTES: 정점 코덱 v0 (헤더 0xa0, 바이트 열별 delta + 2/4/8비트 그룹)
+// - INDICES: 인덱스 시퀀스 코덱 v1 (헤더 0xd1, 기준값 2개 + zigzag varint)
+// 확장 명세의 디코더(three.js MeshoptDecoder 등)와 호환되는 출력을 만듭니다.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// count개 요소(각 stride 바이트, stride는 4의 배수이고 256 이하)를 mode ATTRIBUTES로 인코딩합니다.
+std::vector<uint8_t> EncodeMeshoptAttributes(const uint8_t* data, size_t count, size_t stride);
+
+// count개 인덱스(stride 2 = uint16, 4 = uint32, little-endian)를 mode INDICES로 인코딩합니다.
+std::vector<uint8_t> EncodeMeshoptIndices(const uint8_t* data, size_t count, size_t stride);
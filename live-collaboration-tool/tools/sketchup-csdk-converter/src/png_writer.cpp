@@ -0,0 +1,134 @@
+#include "png_writer.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#ifdef SKETCHUP_CONVERTER_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef SKETCHUP_CONVERTER_HAS_ZLIB
+
+namespace {
+
+void PutU32(std::vector<uint8_t>* out, uint32_t v) {
+  out->push_back(static_cast<uint8_t>(v >> 24));
+  out->push_back(static_cast<uint8_t>(v >> 16));
+  out->push_back(static_cast<uint8_t>(v >> 8));
+  out->push_back(static_cast<uint8_t>(v));
+}
+
+void PutChunk(std::vector<uint8_t>* out, const char type[4], const uint8_t* data, size_t size) {
+  PutU32(out, static_cast<uint32_t>(size));
+  const size_t start = out->size();
+  out->insert(out->end(), type, type + 4);
+  if (size > 0) out->insert(out->end(), data, data + size);
+  const uLong crc = crc32(0L, out->data() + start, static_cast<uInt>(size + 4));
+  PutU32(out, static_cast<uint32_t>(crc));
+}
+
+uint8_t Paeth(int a, int b, int c) {
+  const int p = a + b - c;
+  const int pa = std::abs(p - a);
+  const int pb = std::abs(p - b);
+  const int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+  return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+// 행 하나를 5가지 필터로 만들어 보고 (부호 있는 바이트로 본) 절댓값 합이 가장 작은 것을 filtered에 씁니다.
+void FilterRow(const uint8_t* row, const uint8_t* prev, size_t bytes, std::vector<uint8_t>* filtered) {
+  constexpr size_t kBpp = 4;
+  std::vector<uint8_t> candidate(bytes + 1);
+  uint64_t best_cost = UINT64_MAX;
+  for (uint8_t type = 0; type <= 4; type++) {
+    candidate[0] = type;
+    uint64_t cost = 0;
+    for (size_t i = 0; i < bytes; i++) {
+      const int a = i >= kBpp ? row[i - kBpp] : 0;
+      const int b = prev ? prev[i] : 0;
+      const int c = prev && i >= kBpp ? prev[i - kBpp] : 0;
+      int predicted = 0;
+      switch (type) {
+        case 1: predicted = a; break;
+        case 2: predicted = b; break;
+        case 3: predicted = (a + b) / 2; break;
+        case 4: predicted = Paeth(a, b, c); break;
+        default: break;
+      }
+      const uint8_t v = static_cast<uint8_t>(row[i] - predicted);
+      candidate[i + 1] = v;
+      cost += static_cast<uint64_t>(std::abs(static_cast<int8_t>(v)));
+    }
+    if (cost < best_cost) {
+      best_cost = cost;
+      filtered->assign(candidate.begin(), candidate.end());
+    }
+  }
+}
+
+}  // namespace
+
+bool PngAvailable() { return true; }
+
+bool WritePng(const RgbaImage& image, const std::filesystem::path& path, std::string* error) {
+  if (image.width == 0 || image.height == 0 || image.pixels.size() != image.width * image.height * 4) {
+    if (error) *error = "invalid image";
+    return false;
+  }
+  const size_t stride = image.width * 4;
+  z_stream zs = {};
+  if (deflateInit(&zs, 6) != Z_OK) {
+    if (error) *error = "deflateInit failed";
+    return false;
+  }
+  std::vector<uint8_t> idat(deflateBound(&zs, static_cast<uLong>((stride + 1) * image.height)));
+  zs.next_out = idat.data();
+  zs.avail_out = static_cast<uInt>(idat.size());
+  std::vector<uint8_t> filtered;
+  int rc = Z_OK;
+  for (size_t y = 0; y < image.height && rc == Z_OK; y++) {
+    const uint8_t* row = &image.pixels[y * stride];
+    FilterRow(row, y > 0 ? row - stride : nullptr, stride, &filtered);
+    zs.next_in = filtered.data();
+    zs.avail_in = static_cast<uInt>(filtered.size());
+    rc = deflate(&zs, y + 1 == image.height ? Z_FINISH : Z_NO_FLUSH);
+    if (rc == Z_STREAM_END) rc = Z_OK;
+  }
+  const size_t idat_size = zs.total_out;
+  deflateEnd(&zs);
+  if (rc != Z_OK) {
+    if (error) *error = "deflate failed";
+    return false;
+  }
+
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  std::vector<uint8_t> ihdr;
+  PutU32(&ihdr, static_cast<uint32_t>(image.width));
+  PutU32(&ihdr, static_cast<uint32_t>(image.height));
+  ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0});  // 8비트, RGBA, deflate, 적응형 필터, 비인터레이스
+  PutChunk(&png, "IHDR", ihdr.data(), ihdr.size());
+  PutChunk(&png, "IDAT", idat.data(), idat_size);
+  PutChunk(&png, "IEND", nullptr, 0);
+
+  std::ofstream f(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  f.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+  if (!f.good()) {
+    if (error) *error = "failed to write " + path.string();
+    return false;
+  }
+  return true;
+}
+
+#else
+
+bool PngAvailable() { return false; }
+
+bool WritePng(const RgbaImage&, const std::filesystem::path&, std::string* error) {
+  if (error) *error = "built without zlib";
+  return false;
+}
+
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+// RGBA8 PNG 인코더. 텍스처 재인코딩을 SketchUp SDK 밖(worker 스레드)에서 하기 위해 씁니다.
+// 행마다 None/Sub/Up/Average/Paeth 중 절댓값 합이 가장 작은 필터를 고르고 zlib으로 압축합니다.
+// zlib과 함께 빌드된 경우(SKETCHUP_CONVERTER_HAS_ZLIB)에만 동작하며, 없으면 PngAvailable()이 false입니다.
+
+#include <filesystem>
+#include <string>
+
+#include "image_resample.h"  // RgbaImage (위→아래 행 순서의 RGBA)
+
+bool PngAvailable();
+
+// 성공 시 true. 실패하면 error에 원인을 채웁니다.
+bool WritePng(const RgbaImage& image, const std::filesystem::path& path, std::string* error);
@@ -0,0 +1,174 @@
+#include "scene_bounds.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "transform_math.h"
+
+namespace {
+
+double Distance(const double a[3], const double b[3]) {
+  const double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// AABB 외접구가 더 작으면 그것으로 바꿈
+void TightenSphere(GltfBounds* b) {
+  double center[3];
+  for (int k = 0; k < 3; k++) center[k] = 0.5 * (b->min[k] + b->max[k]);
+  const double radius = 0.5 * Distance(b->min, b->max);
+  if (radius < b->sphere[3]) {
+    std::copy(center, center + 3, b->sphere);
+    b->sphere[3] = radius;
+  }
+}
+
+// 박스는 8개 꼭짓점을, 구는 중심을 옮기고 반지름을 가장 긴 축 배율만큼 키움
+GltfBounds Transform(const GltfBounds& b, const Matrix4& m) {
+  GltfBounds out;
+  if (!b.valid) return out;
+  out.valid = true;
+  std::fill(out.min, out.min + 3, DBL_MAX);
+  std::fill(out.max, out.max + 3, -DBL_MAX);
+  for (int corner = 0; corner < 8; corner++) {
+    const double p[3] = {corner & 1 ? b.max[0] : b.min[0], corner & 2 ? b.max[1] : b.min[1],
+                         corner & 4 ? b.max[2] : b.min[2]};
+    for (int row = 0; row < 3; row++) {
+      const double v = m[row] * p[0] + m[4 + row] * p[1] + m[8 + row] * p[2] + m[12 + row];
+      out.min[row] = std::min(out.min[row], v);
+      out.max[row] = std::max(out.max[row], v);
+    }
+  }
+  double scale = 0.0;
+  for (int col = 0; col < 3; col++) {
+    scale = std::max(scale, std::sqrt(m[col * 4] * m[col * 4] + m[col * 4 + 1] * m[col * 4 + 1] +
+                                      m[col * 4 + 2] * m[col * 4 + 2]));
+  }
+  const double* c = b.sphere;
+  for (int row = 0; row < 3; row++) {
+    out.sphere[row] = m[row] * c[0] + m[4 + row] * c[1] + m[8 + row] * c[2] + m[12 + row];
+  }
+  out.sphere[3] = b.sphere[3] * scale;
+  TightenSphere(&out);
+  return out;
+}
+
+void Merge(GltfBounds* into, const GltfBounds& b) {
+  if (!b.valid) return;
+  if (!into->valid) {
+    *into = b;
+    return;
+  }
+  for (int k = 0; k < 3; k++) {
+    into->min[k] = std::min(into->min[k], b.min[k]);
+    into->max[k] = std::max(into->max[k], b.max[k]);
+  }
+  // 두 구를 감싸는 최소 구
+  double* s = into->sphere;
+  const double d = Distance(s, b.sphere);
+  if (d + b.sphere[3] > s[3]) {
+    if (d + s[3] <= b.sphere[3]) {
+      std::copy(b.sphere, b.sphere + 4, s);
+    } else {
+      const double radius = 0.5 * (d + s[3] + b.sphere[3]);
+      const double t = d > 0.0 ? (radius - s[3]) / d : 0.0;
+      for (int k = 0; k < 3; k++) s[k] += (b.sphere[k] - s[k]) * t;
+      s[3] = radius;
+    }
+  }
+  TightenSphere(into);
+}
+
+void NodeBounds(GltfScene* scene, int index, const std::vector<GltfBounds>& mesh_bounds,
+                std::vector<char>* done) {
+  if ((*done)[index]) return;
+  (*done)[index] = 1;
+  GltfBounds local;
+  {
+    const GltfNode& node = scene->nodes[index];
+    if (node.mesh >= 0 && node.mesh < static_cast<int>(mesh_bounds.size())) {
+      const GltfBounds& mb = mesh_bounds[node.mesh];
+      if (node.instances.empty()) {
+        Merge(&local, mb);
+      } else {
+        for (const GltfInstance& inst : node.instances) Merge(&local, Transform(mb, InstanceMatrix(inst)));
+      }
+    }
+  }
+  // 자식 bounds는 이 node의 로컬 좌표 기준 (재귀 중 nodes가 바뀌지 않으므로 인덱스로 다시 찾음)
+  for (size_t c = 0; c < scene->nodes[index].children.size(); c++) {
+    const int child = scene->nodes[index].children[c];
+    if (child < 0 || child >= static_cast<int>(scene->nodes.size())) continue;
+    NodeBounds(scene, child, mesh_bounds, done);
+    Merge(&local, scene->nodes[child].bounds);
+  }
+  GltfNode& node = scene->nodes[index];
+  if (node.has_matrix) {
+    Matrix4 m;
+    std::copy(node.matrix, node.matrix + 16, m.begin());
+    node.bounds = Transform(local, m);
+  } else {
+    node.bounds = local;
+  }
+}
+
+}  // namespace
+
+void BoundsAccumulator::add(double x, double y, double z) {
+  const double p[3] = {x, y, z};
+  if (empty_) {
+    empty_ = false;
+    std::copy(p, p + 3, min_);
+    std::copy(p, p + 3, max_);
+    std::copy(p, p + 3, center_);
+    radius_ = 0.0;
+    return;
+  }
+  for (int k = 0; k < 3; k++) {
+    min_[k] = std::min(min_[k], p[k]);
+    max_[k] = std::max(max_[k], p[k]);
+  }
+  // Ritter: 구 밖의 점이면 그 점과 반대편 끝을 지름으로 하는 구로 넓힘
+  const double d = Distance(center_, p);
+  if (d > radius_) {
+    const double radius = 0.5 * (radius_ + d);
+    const double t = (radius - radius_) / d;
+    for (int k = 0; k < 3; k++) center_[k] += (p[k] - center_[k]) * t;
+    radius_ = radius;
+  }
+}
+
+GltfBounds BoundsAccumulator::bounds() const {
+  GltfBounds b;
+  if (empty_) return b;
+  b.valid = true;
+  std::copy(min_, min_ + 3, b.min);
+  std::copy(max_, max_ + 3, b.max);
+  std::copy(center_, center_ + 3, b.sphere);
+  b.sphere[3] = radius_;
+  TightenSphere(&b);
+  return b;
+}
+
+GltfBounds ComputeMeshBounds(const GltfMesh& mesh) {
+  BoundsAccumulator acc;
+  for (const GltfPrimitive& prim : mesh.primitives) {
+    std::vector<char> used(prim.vertex_count(), 0);
+    for (uint32_t i : prim.indices) {
+      if (i >= used.size() || used[i]) continue;
+      used[i] = 1;
+      acc.add(prim.positions[i * 3], prim.positions[i * 3 + 1], prim.positions[i * 3 + 2]);
+    }
+  }
+  return acc.bounds();
+}
+
+void ComputeNodeBounds(GltfScene* scene, const std::vector<GltfBounds>& streamed) {
+  std::vector<GltfBounds> mesh_bounds(scene->meshes.size());
+  for (size_t m = 0; m < scene->meshes.size(); m++) {
+    mesh_bounds[m] = m < streamed.size() && streamed[m].valid ? streamed[m] : ComputeMeshBounds(scene->meshes[m]);
+  }
+  std::vector<char> done(scene->nodes.size(), 0);
+  for (size_t i = 0; i < scene->nodes.size(); i++) NodeBounds(scene, static_cast<int>(i), mesh_bounds, &done);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// 클라이언트 frustum culling용 바운딩 볼륨 (AABB + 바운딩 구).
+// - BoundsAccumulator는 정점을 하나씩 받아 AABB와 Ritter 방식으로 키워 가는 구를 함께 유지하므로
+//   순회 중에 정점을 따로 모아 두지 않고 mesh 범위를 구할 수 있습니다.
+// - ComputeNodeBounds는 mesh 범위를 node 트리(matrix, 인스턴스, 자식)를 따라 합쳐 node마다 채웁니다.
+
+#include <vector>
+
+#include "gltf_scene.h"
+
+class BoundsAccumulator {
+ public:
+  void add(double x, double y, double z);
+  // AABB 외접구와 점진 확장 구 중 작은 쪽을 구로 씁니다. 정점이 없으면 valid=false
+  GltfBounds bounds() const;
+
+ private:
+  bool empty_ = true;
+  double min_[3] = {0.0, 0.0, 0.0};
+  double max_[3] = {0.0, 0.0, 0.0};
+  double center_[3] = {0.0, 0.0, 0.0};
+  double radius_ = 0.0;
+};
+
+// mesh 정점 범위 (mesh 로컬 좌표). 인덱스가 참조하는 정점만 봅니다.
+GltfBounds ComputeMeshBounds(const GltfMesh& mesh);
+
+// 모든 node의 bounds를 (부모 좌표 기준) 채웁니다. streamed[m].valid인 mesh는 그 값을 쓰고
+// 나머지(순회 뒤에 만든 LOD/proxy mesh 등)는 정점에서 구합니다.
+void ComputeNodeBounds(GltfScene* scene, const std::vector<GltfBounds>& streamed);
@@ -0,0 +1,211 @@
+#include "scene_proxy.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "mesh_simplify.h"
+#include "transform_math.h"
+
+namespace {
+
+// 예산 몫이 이보다 적은 인스턴스는 proxy에서 뺌
+constexpr double kMinInstanceTriangles = 8.0;
+// proxy는 윤곽만 보이면 되므로 오차 한도 없이 예산까지 줄임 (바운딩 박스 긴 변 대비)
+constexpr double kProxyMaxError = 1.0;
+
+struct Draw {
+  int mesh;
+  Matrix4 matrix;
+  double weight = 0.0;  // 세계 바운딩 박스 대각선²
+  double share = 0.0;   // 받은 삼각형 예산
+};
+
+void CollectDraws(const GltfScene& scene, int index, const Matrix4& parent, std::vector<Draw>* draws) {
+  const GltfNode& node = scene.nodes[index];
+  Matrix4 local = IdentityMatrix();
+  if (node.has_matrix) std::copy(node.matrix, node.matrix + 16, local.begin());
+  const Matrix4 world = Multiply(parent, local);
+  if (node.mesh >= 0) {
+    if (node.instances.empty()) {
+      draws->push_back(Draw{node.mesh, world});
+    } else {
+      for (const GltfInstance& inst : node.instances) {
+        draws->push_back(Draw{node.mesh, Multiply(world, InstanceMatrix(inst))});
+      }
+    }
+  }
+  for (int child : node.children) CollectDraws(scene, child, world, draws);
+}
+
+struct Bounds {
+  double min[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+  double max[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+  bool empty() const { return min[0] > max[0]; }
+};
+
+Bounds MeshBounds(const GltfMesh& mesh) {
+  Bounds b;
+  for (const GltfPrimitive& prim : mesh.primitives) {
+    if (prim.indices.empty()) continue;
+    for (size_t i = 0; i < prim.positions.size(); i += 3) {
+      for (int k = 0; k < 3; k++) {
+        b.min[k] = std::min(b.min[k], static_cast<double>(prim.positions[i + k]));
+        b.max[k] = std::max(b.max[k], static_cast<double>(prim.positions[i + k]));
+      }
+    }
+  }
+  return b;
+}
+
+// 로컬 박스의 8개 꼭짓점을 옮긴 세계 박스의 대각선²
+double WorldDiagonalSquared(const Bounds& b, const Matrix4& m) {
+  Bounds w;
+  for (int corner = 0; corner < 8; corner++) {
+    const double p[3] = {corner & 1 ? b.max[0] : b.min[0], corner & 2 ? b.max[1] : b.min[1],
+                         corner & 4 ? b.max[2] : b.min[2]};
+    for (int row = 0; row < 3; row++) {
+      const double v = m[row] * p[0] + m[4 + row] * p[1] + m[8 + row] * p[2] + m[12 + row];
+      w.min[row] = std::min(w.min[row], v);
+      w.max[row] = std::max(w.max[row], v);
+    }
+  }
+  double d = 0.0;
+  for (int k = 0; k < 3; k++) d += (w.max[k] - w.min[k]) * (w.max[k] - w.min[k]);
+  return d;
+}
+
+size_t TriangleCount(const GltfMesh& mesh) {
+  size_t triangles = 0;
+  for (const GltfPrimitive& p : mesh.primitives) triangles += p.indices.size() / 3;
+  return triangles;
+}
+
+}  // namespace
+
+GltfMesh BuildSceneProxy(const GltfScene& scene, size_t target_triangles, size_t max_primitive_vertices,
+                         ProxyStats* stats) {
+  const auto t0 = std::chrono::steady_clock::now();
+  ProxyStats local;
+  GltfMesh proxy;
+  proxy.name = "proxy";
+
+  std::vector<Draw> draws;
+  for (int root : scene.roots) CollectDraws(scene, root, IdentityMatrix(), &draws);
+  std::vector<Bounds> bounds(scene.meshes.size());
+  std::vector<size_t> triangles(scene.meshes.size(), 0);
+  for (size_t m = 0; m < scene.meshes.size(); m++) {
+    bounds[m] = MeshBounds(scene.meshes[m]);
+    triangles[m] = TriangleCount(scene.meshes[m]);
+  }
+  draws.erase(std::remove_if(draws.begin(), draws.end(), [&](const Draw& d) { return triangles[d.mesh] == 0; }),
+              draws.end());
+  double total_weight = 0.0;
+  for (Draw& d : draws) {
+    d.weight = WorldDiagonalSquared(bounds[d.mesh], d.matrix);
+    total_weight += d.weight;
+    local.triangles_before += triangles[d.mesh];
+  }
+  local.instances = draws.size();
+
+  // 예산을 면적 비율로 나누되 원래 삼각형 수를 넘는 몫은 나머지에게 다시 나눔.
+  // (삼각형 수 / 면적)이 작은 인스턴스부터 보면 상한에 걸리는 것이 먼저 정해집니다.
+  std::vector<size_t> order(draws.size());
+  for (size_t i = 0; i < order.size(); i++) order[i] = i;
+  auto density = [&](size_t i) {
+    return draws[i].weight > 0.0 ? static_cast<double>(triangles[draws[i].mesh]) / draws[i].weight : DBL_MAX;
+  };
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return density(a) < density(b); });
+  double budget = static_cast<double>(target_triangles);
+  double weight = total_weight;
+  for (size_t i : order) {
+    Draw& d = draws[i];
+    const double share = weight > 0.0 ? budget * d.weight / weight : 0.0;
+    d.share = std::min(share, static_cast<double>(triangles[d.mesh]));
+    budget = std::max(0.0, budget - d.share);
+    weight -= d.weight;
+  }
+
+  // definition mesh마다 남는 인스턴스 몫의 평균으로 한 번만 단순화
+  std::vector<double> share_sum(scene.meshes.size(), 0.0);
+  std::vector<size_t> share_count(scene.meshes.size(), 0);
+  for (const Draw& d : draws) {
+    if (d.share < kMinInstanceTriangles) continue;
+    share_sum[d.mesh] += d.share;
+    share_count[d.mesh]++;
+  }
+  std::vector<GltfMesh> simplified(scene.meshes.size());
+  for (size_t m = 0; m < scene.meshes.size(); m++) {
+    if (share_count[m] == 0) continue;
+    const double ratio = share_sum[m] / share_count[m] / static_cast<double>(triangles[m]);
+    simplified[m] = ratio >= 1.0 ? scene.meshes[m] : SimplifyMesh(scene.meshes[m], ratio, kProxyMaxError, nullptr);
+  }
+
+  // 세계 좌표로 구워 material별 primitive에 모음
+  std::unordered_map<int, size_t> primitive_for_material;
+  for (const Draw& d : draws) {
+    if (d.share < kMinInstanceTriangles || simplified[d.mesh].primitives.empty()) continue;
+    local.instances_kept++;
+    const Matrix4& m = d.matrix;
+    // normal은 (역행렬)ᵀ 방향 = 여인수 행렬. 미러(det < 0)면 방향과 삼각형 감기 순서를 뒤집음
+    const double c[9] = {m[5] * m[10] - m[9] * m[6], m[9] * m[2] - m[1] * m[10], m[1] * m[6] - m[5] * m[2],
+                         m[8] * m[6] - m[4] * m[10], m[0] * m[10] - m[8] * m[2], m[4] * m[2] - m[0] * m[6],
+                         m[4] * m[9] - m[8] * m[5], m[8] * m[1] - m[0] * m[9], m[0] * m[5] - m[4] * m[1]};  // 행 우선
+    const double det = m[0] * c[0] + m[4] * c[1] + m[8] * c[2];
+    const double sign = det < 0.0 ? -1.0 : 1.0;
+    for (const GltfPrimitive& prim : simplified[d.mesh].primitives) {
+      if (prim.indices.empty()) continue;
+      auto it = primitive_for_material.find(prim.material);
+      if (it == primitive_for_material.end() ||
+          proxy.primitives[it->second].vertex_count() + prim.vertex_count() > max_primitive_vertices) {
+        proxy.primitives.emplace_back();
+        proxy.primitives.back().material = prim.material;
+        it = primitive_for_material.insert_or_assign(prim.material, proxy.primitives.size() - 1).first;
+      }
+      GltfPrimitive& out = proxy.primitives[it->second];
+      const uint32_t base = static_cast<uint32_t>(out.vertex_count());
+      const bool has_normals = prim.normals.size() == prim.positions.size();
+      const bool has_texcoords = prim.texcoords.size() / 2 == prim.vertex_count();
+      for (size_t v = 0; v < prim.vertex_count(); v++) {
+        const double p[3] = {prim.positions[v * 3], prim.positions[v * 3 + 1], prim.positions[v * 3 + 2]};
+        for (int row = 0; row < 3; row++) {
+          out.positions.push_back(
+              static_cast<float>(m[row] * p[0] + m[4 + row] * p[1] + m[8 + row] * p[2] + m[12 + row]));
+        }
+        double n[3] = {0.0, 0.0, 1.0};
+        if (has_normals) {
+          const double s[3] = {prim.normals[v * 3], prim.normals[v * 3 + 1], prim.normals[v * 3 + 2]};
+          double len = 0.0;
+          for (int row = 0; row < 3; row++) {
+            n[row] = sign * (c[row * 3] * s[0] + c[row * 3 + 1] * s[1] + c[row * 3 + 2] * s[2]);
+            len += n[row] * n[row];
+          }
+          len = std::sqrt(len);
+          if (len > 0.0) {
+            for (double& x : n) x /= len;
+          }
+        }
+        out.normals.insert(out.normals.end(),
+                           {static_cast<float>(n[0]), static_cast<float>(n[1]), static_cast<float>(n[2])});
+        if (has_texcoords) {
+          out.texcoords.insert(out.texcoords.end(), {prim.texcoords[v * 2], prim.texcoords[v * 2 + 1]});
+        } else {
+          out.texcoords.insert(out.texcoords.end(), {0.0f, 0.0f});
+        }
+      }
+      for (size_t i = 0; i + 2 < prim.indices.size(); i += 3) {
+        out.indices.push_back(base + prim.indices[i]);
+        out.indices.push_back(base + prim.indices[det < 0.0 ? i + 2 : i + 1]);
+        out.indices.push_back(base + prim.indices[det < 0.0 ? i + 1 : i + 2]);
+      }
+      local.triangles += prim.indices.size() / 3;
+    }
+  }
+
+  local.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  if (stats) *stats = local;
+  return proxy;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// coarse-first GLB용 장면 proxy: 모델 전체를 삼각형 예산 안의 세계 좌표 mesh 하나로 줄입니다.
+// - node 트리(matrix, EXT_mesh_gpu_instancing 인스턴스)를 따라 그려지는 mesh마다 세계 바운딩 박스를 구하고,
+//   예산을 박스 면적(대각선²) 비율로 나눕니다. 몫이 원래 삼각형 수보다 크면 남는 만큼 다른 mesh에 돌립니다.
+// - 몫이 너무 작은 (화면에서 작은) 인스턴스는 proxy에서 뺍니다.
+// - definition mesh는 인스턴스 몫의 평균으로 한 번만 단순화(mesh_simplify)해 인스턴스마다 구워 넣습니다.
+
+#include <cstddef>
+
+#include "gltf_scene.h"
+
+struct ProxyStats {
+  size_t triangles_before = 0;  // 인스턴스까지 센 원래 삼각형 수
+  size_t triangles = 0;         // proxy 삼각형 수
+  size_t instances = 0;         // 그려지는 mesh 인스턴스 수
+  size_t instances_kept = 0;    // proxy에 들어간 인스턴스 수
+  double seconds = 0.0;
+};
+
+// scene.roots 아래 node들이 그리는 geometry를 target_triangles 근처로 줄인 세계 좌표 mesh.
+// material별 primitive로 모으고 max_primitive_vertices를 넘으면 나눕니다. stats는 nullptr 가능.
+GltfMesh BuildSceneProxy(const GltfScene& scene, size_t target_triangles, size_t max_primitive_vertices,
+                         ProxyStats* stats);
@@ -0,0 +1,93 @@
+#include "smoothing_groups.h"
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+#include "union_find.h"
+
+namespace {
+
+// 합친 normal이 이보다 짧으면 (거의 반대 방향 face) 평균을 쓰지 않음
+constexpr double kMinNormalLength = 1e-6;
+
+uint64_t CornerKey(int face, int vertex) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(face)) << 32) | static_cast<uint32_t>(vertex);
+}
+
+}  // namespace
+
+std::vector<std::vector<SmoothCorner>> BuildSmoothingGroups(const std::vector<SmoothingFace>& faces,
+                                                            const std::vector<SmoothingEdge>& edges,
+                                                            SmoothingStats* stats) {
+  std::vector<std::vector<SmoothCorner>> result(faces.size());
+  std::vector<int> first_corner(faces.size() + 1, 0);
+  for (size_t f = 0; f < faces.size(); f++) {
+    first_corner[f + 1] = first_corner[f] + static_cast<int>(faces[f].vertices.size());
+  }
+  std::unordered_map<uint64_t, int> corner_of;
+  corner_of.reserve(first_corner.back());
+  for (size_t f = 0; f < faces.size(); f++) {
+    for (size_t c = 0; c < faces[f].vertices.size(); c++) {
+      corner_of.emplace(CornerKey(static_cast<int>(f), faces[f].vertices[c]), first_corner[f] + static_cast<int>(c));
+    }
+  }
+
+  UnionFind corners(first_corner.back());
+  UnionFind groups(faces.size());
+  auto join = [&](int fa, int fb, int vertex) {
+    auto a = corner_of.find(CornerKey(fa, vertex));
+    auto b = corner_of.find(CornerKey(fb, vertex));
+    if (a != corner_of.end() && b != corner_of.end()) corners.unite(a->second, b->second);
+  };
+  for (const SmoothingEdge& e : edges) {
+    for (size_t i = 0; i < e.faces.size(); i++) {
+      for (size_t k = i + 1; k < e.faces.size(); k++) {
+        // 방향이 맞는 두 face는 공유 edge를 서로 반대 방향으로 씀
+        if (e.reversed[i] == e.reversed[k]) continue;
+        join(e.faces[i], e.faces[k], e.v0);
+        join(e.faces[i], e.faces[k], e.v1);
+        groups.unite(e.faces[i], e.faces[k]);
+      }
+    }
+  }
+
+  // 묶음마다 face normal 합
+  std::vector<double> sum(static_cast<size_t>(first_corner.back()) * 3, 0.0);
+  std::vector<int> count(first_corner.back(), 0);
+  for (size_t f = 0; f < faces.size(); f++) {
+    for (size_t c = 0; c < faces[f].vertices.size(); c++) {
+      const int root = corners.find(first_corner[f] + static_cast<int>(c));
+      for (int k = 0; k < 3; k++) sum[root * 3 + k] += faces[f].normal[k];
+      count[root]++;
+    }
+  }
+  SmoothingStats local;
+  for (size_t f = 0; f < faces.size(); f++) {
+    for (size_t c = 0; c < faces[f].vertices.size(); c++) {
+      const int root = corners.find(first_corner[f] + static_cast<int>(c));
+      if (count[root] < 2) continue;
+      const double* s = &sum[root * 3];
+      const double length = std::sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+      if (length < kMinNormalLength * count[root]) continue;
+      SmoothCorner corner;
+      corner.corner = static_cast<int>(c);
+      for (int k = 0; k < 3; k++) corner.normal[k] = s[k] / length;
+      result[f].push_back(corner);
+      local.corners++;
+    }
+  }
+  std::vector<int> group_size(faces.size(), 0);
+  for (size_t f = 0; f < faces.size(); f++) group_size[groups.find(static_cast<int>(f))]++;
+  for (int size : group_size) {
+    if (size < 2) continue;
+    local.groups++;
+    local.faces += static_cast<size_t>(size);
+  }
+  if (stats) {
+    stats->groups += local.groups;
+    stats->faces += local.faces;
+    stats->corners += local.corners;
+  }
+  return result;
+}
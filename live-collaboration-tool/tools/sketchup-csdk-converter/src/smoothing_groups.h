@@ -0,0 +1,41 @@
+#pragma once
+
+// soft/smooth edge로 이어진 face들의 꼭짓점 normal 평균 (smoothing group).
+// face는 각자 테셀레이션되어 꼭짓점마다 face normal을 가지므로, 곡면(원기둥 등)을 이루는 face 사이에서
+// 정점이 공유되지 않고 각진 음영이 됩니다. 여기서는 edge 하나를 공유하는 두 face가 같은 끝 정점에서 갖는
+// 꼭짓점을 한 묶음으로 잇고(union-find), 묶음마다 face normal을 평균합니다.
+// - 정점을 도는 face들이 hard edge로 끊기면 묶음도 끊기므로 원기둥 뚜껑 모서리처럼 각은 그대로 남습니다.
+// - 서로 뒤집힌(방향이 맞지 않는) face는 edge 방향이 같으므로(reversed가 같음) 잇지 않습니다.
+
+#include <cstddef>
+#include <vector>
+
+struct SmoothingFace {
+  double normal[3] = {0.0, 0.0, 1.0};  // 단위 face normal
+  std::vector<int> vertices;           // 꼭짓점 정점 id (모든 loop)
+};
+
+// 부드럽게 이어 줄 edge (soft 또는 smooth)
+struct SmoothingEdge {
+  int v0 = -1;
+  int v1 = -1;
+  std::vector<int> faces;      // 이 edge를 쓰는 face (SmoothingFace 인덱스)
+  std::vector<bool> reversed;  // faces와 같은 순서. face loop에서 edge가 거꾸로 쓰이는지
+};
+
+struct SmoothingStats {
+  size_t groups = 0;   // soft edge로 이어진 face 묶음 (face 2개 이상)
+  size_t faces = 0;    // 그 묶음에 든 face
+  size_t corners = 0;  // 평균 normal을 받은 꼭짓점
+};
+
+struct SmoothCorner {
+  int corner = 0;  // SmoothingFace::vertices 인덱스
+  double normal[3] = {0.0, 0.0, 1.0};
+};
+
+// face마다 다른 face와 이어진 꼭짓점과 그 평균 normal. 이어지지 않은 꼭짓점은 빠집니다 (face normal 유지).
+// stats는 누적되며 nullptr 가능.
+std::vector<std::vector<SmoothCorner>> BuildSmoothingGroups(const std::vector<SmoothingFace>& faces,
+                                                            const std::vector<SmoothingEdge>& edges,
+                                                            SmoothingStats* stats);
@@ -0,0 +1,89 @@
+#include "text_writer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// double 하나의 최대 길이 ("-1.2345678901234567e-308" + 여유)
+constexpr size_t kMaxNumberChars = 32;
+
+}  // namespace
+
+TextWriter::TextWriter(size_t buffer_size) : buffer_(std::max<size_t>(buffer_size, 4096)) {}
+
+TextWriter::~TextWriter() { close(); }
+
+bool TextWriter::open(const std::filesystem::path& path) {
+  close();
+  failed_ = false;
+  pos_ = 0;
+  flushed_ = 0;
+  file_ = std::fopen(path.string().c_str(), "wb");
+  if (!file_) return false;
+  // 자체 버퍼를 쓰므로 stdio 버퍼는 끕니다.
+  std::setvbuf(file_, nullptr, _IONBF, 0);
+  return true;
+}
+
+bool TextWriter::close() {
+  if (!file_) return !failed_;
+  flush_buffer();
+  if (std::fclose(file_) != 0) failed_ = true;
+  file_ = nullptr;
+  return !failed_;
+}
+
+void TextWriter::set_precision(int digits) { precision_ = std::clamp(digits, 1, 17); }
+
+void TextWriter::flush_buffer() {
+  if (pos_ == 0) return;
+  if (file_ && !failed_) {
+    if (std::fwrite(buffer_.data(), 1, pos_, file_) != pos_) failed_ = true;
+  }
+  flushed_ += pos_;
+  pos_ = 0;
+}
+
+TextWriter& TextWriter::operator<<(std::string_view s) {
+  if (s.size() > buffer_.size()) {
+    // 버퍼보다 큰 문자열은 바로 기록
+    flush_buffer();
+    if (file_ && !failed_ && std::fwrite(s.data(), 1, s.size(), file_) != s.size()) failed_ = true;
+    flushed_ += s.size();
+    return *this;
+  }
+  reserve(s.size());
+  std::memcpy(buffer_.data() + pos_, s.data(), s.size());
+  pos_ += s.size();
+  return *this;
+}
+
+TextWriter& TextWriter::operator<<(char c) {
+  reserve(1);
+  buffer_[pos_++] = c;
+  return *this;
+}
+
+TextWriter& TextWriter::operator<<(double v) {
+  reserve(kMaxNumberChars);
+  char* first = buffer_.data() + pos_;
+  const auto r = std::to_chars(first, first + kMaxNumberChars, v, std::chars_format::general, precision_);
+  pos_ += static_cast<size_t>(r.ptr - first);
+  return *this;
+}
+
+void TextWriter::write_int(int64_t v) {
+  reserve(kMaxNumberChars);
+  char* first = buffer_.data() + pos_;
+  const auto r = std::to_chars(first, first + kMaxNumberChars, v);
+  pos_ += static_cast<size_t>(r.ptr - first);
+}
+
+void TextWriter::write_uint(uint64_t v) {
+  reserve(kMaxNumberChars);
+  char* first = buffer_.data() + pos_;
+  const auto r = std::to_chars(first, first + kMaxNumberChars, v);
+  pos_ += static_cast<size_t>(r.ptr - first);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+// OBJ/MTL 같은 대용량 텍스트 출력용 버퍼링 writer.
+// - 숫자는 std::to_chars로 변환 (locale 비의존, iostream 포맷팅 비용 없음)
+// - 큰 청크 단위로 fwrite
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+class TextWriter {
+ public:
+  static constexpr size_t kDefaultBufferSize = 1 << 20;  // 1 MiB
+  static constexpr int kDefaultPrecision = 6;             // std::ostream 기본값과 동일
+
+  explicit TextWriter(size_t buffer_size = kDefaultBufferSize);
+  ~TextWriter();
+
+  TextWriter(const TextWriter&) = delete;
+  TextWriter& operator=(const TextWriter&) = delete;
+
+  bool open(const std::filesystem::path& path);
+  // 남은 버퍼를 기록하고 파일을 닫습니다. 기록 중 오류가 있었으면 false.
+  bool close();
+  bool good() const { return file_ != nullptr && !failed_; }
+
+  // 실수 출력 유효 숫자 수 (printf "%.*g"와 동일한 규칙)
+  void set_precision(int digits);
+  int precision() const { return precision_; }
+
+  // 지금까지 출력한 바이트 수 (버퍼에 남은 것 포함)
+  size_t bytes_written() const { return flushed_ + pos_; }
+
+  TextWriter& operator<<(std::string_view s);
+  TextWriter& operator<<(const char* s) { return *this << std::string_view(s); }
+  TextWriter& operator<<(const std::string& s) { return *this << std::string_view(s); }
+  TextWriter& operator<<(char c);
+  TextWriter& operator<<(double v);
+  TextWriter& operator<<(float v) { return *this << static_cast<double>(v); }
+
+  template <typename T,
+            std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> &&
+                                 !std::is_same_v<T, bool>,
+                             int> = 0>
+  TextWriter& operator<<(T v) {
+    if (std::is_signed_v<T>) {
+      write_int(static_cast<int64_t>(v));
+    } else {
+      write_uint(static_cast<uint64_t>(v));
+    }
+    return *this;
+  }
+
+ private:
+  void write_int(int64_t v);
+  void write_uint(uint64_t v);
+  // 버퍼에 n바이트 여유가 없으면 비웁니다.
+  void reserve(size_t n) {
+    if (pos_ + n > buffer_.size()) flush_buffer();
+  }
+  void flush_buffer();
+
+  std::FILE* file_ = nullptr;
+  std::vector<char> buffer_;
+  size_t pos_ = 0;
+  size_t flushed_ = 0;
+  int precision_ = kDefaultPrecision;
+  bool failed_ = false;
+};
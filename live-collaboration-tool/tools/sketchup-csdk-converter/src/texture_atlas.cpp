@@ -0,0 +1,135 @@
+#include "texture_atlas.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+size_t AlignUp(size_t v, size_t align) { return align > 1 ? (v + align - 1) / align * align : v; }
+
+size_t Pow2AtLeast(size_t v) {
+  size_t p = 1;
+  while (p < v) p <<= 1;
+  return p;
+}
+
+struct Shelf {
+  size_t y = 0;
+  size_t height = 0;
+  size_t x = 0;  // 다음 칸의 시작 x
+};
+
+struct Page {
+  std::vector<Shelf> shelves;
+  size_t top = 0;  // 다음 shelf의 시작 y
+  size_t used_width = 0;
+};
+
+}  // namespace
+
+AtlasLayout PackAtlas(const std::vector<std::pair<size_t, size_t>>& sizes, const AtlasOptions& options) {
+  AtlasLayout layout;
+  layout.rects.resize(sizes.size());
+
+  std::vector<size_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (sizes[a].second != sizes[b].second) return sizes[a].second > sizes[b].second;
+    return sizes[a].first > sizes[b].first;
+  });
+
+  std::vector<Page> pages;
+  for (size_t i : order) {
+    const size_t cw = AlignUp(sizes[i].first + options.gutter * 2, options.align);
+    const size_t ch = AlignUp(sizes[i].second + options.gutter * 2, options.align);
+    if (sizes[i].first == 0 || sizes[i].second == 0 || cw > options.page_size || ch > options.page_size) continue;
+
+    // 들어가는 첫 shelf → 없으면 남은 높이에 새 shelf → 없으면 새 페이지
+    int page = -1;
+    Shelf* shelf = nullptr;
+    for (size_t p = 0; p < pages.size() && !shelf; p++) {
+      for (Shelf& s : pages[p].shelves) {
+        if (ch <= s.height && s.x + cw <= options.page_size) {
+          page = static_cast<int>(p);
+          shelf = &s;
+          break;
+        }
+      }
+      if (!shelf && pages[p].top + ch <= options.page_size) {
+        pages[p].shelves.push_back(Shelf{pages[p].top, ch, 0});
+        pages[p].top += ch;
+        page = static_cast<int>(p);
+        shelf = &pages[p].shelves.back();
+      }
+    }
+    if (!shelf) {
+      pages.emplace_back();
+      pages.back().shelves.push_back(Shelf{0, ch, 0});
+      pages.back().top = ch;
+      page = static_cast<int>(pages.size() - 1);
+      shelf = &pages.back().shelves.back();
+    }
+
+    AtlasRect& r = layout.rects[i];
+    r.page = page;
+    r.x = shelf->x + options.gutter;
+    r.y = shelf->y + options.gutter;
+    r.width = sizes[i].first;
+    r.height = sizes[i].second;
+    shelf->x += cw;
+    pages[page].used_width = std::max(pages[page].used_width, shelf->x);
+  }
+
+  for (const Page& p : pages) {
+    layout.page_width.push_back(std::min(options.page_size, Pow2AtLeast(p.used_width)));
+    layout.page_height.push_back(std::min(options.page_size, Pow2AtLeast(p.top)));
+  }
+  return layout;
+}
+
+RgbaImage ComposeAtlasPage(
+    const std::vector<RgbaImage>& images, const AtlasLayout& layout, int page, const AtlasOptions& options) {
+  RgbaImage out;
+  out.width = layout.page_width[page];
+  out.height = layout.page_height[page];
+  out.pixels.assign(out.width * out.height * 4, 0);
+  const size_t g = options.gutter;
+  for (size_t i = 0; i < images.size(); i++) {
+    const AtlasRect& r = layout.rects[i];
+    const RgbaImage& img = images[i];
+    if (r.page != page || img.width != r.width || img.height != r.height) continue;
+    // gutter까지 덮는 칸을 채우고, 이미지 밖 좌표는 가장 가까운 가장자리 픽셀로 (clamp)
+    const size_t x0 = r.x - g;
+    const size_t y0 = r.y - g;
+    const size_t x1 = std::min(out.width, AlignUp(r.x + r.width + g - x0, options.align) + x0);
+    const size_t y1 = std::min(out.height, AlignUp(r.y + r.height + g - y0, options.align) + y0);
+    for (size_t y = y0; y < y1; y++) {
+      const size_t sy = std::min(img.height - 1, y < r.y ? 0 : y - r.y);
+      const uint8_t* src_row = &img.pixels[sy * img.width * 4];
+      uint8_t* dst_row = &out.pixels[y * out.width * 4];
+      for (size_t x = x0; x < x1; x++) {
+        const size_t sx = std::min(img.width - 1, x < r.x ? 0 : x - r.x);
+        std::copy_n(src_row + sx * 4, 4, dst_row + x * 4);
+      }
+    }
+  }
+  return out;
+}
+
+void RemapAtlasTexcoords(
+    const AtlasRect& rect, size_t page_width, size_t page_height, bool top_left_origin, std::vector<float>* texcoords) {
+  const double su = static_cast<double>(rect.width) / page_width;
+  const double sv = static_cast<double>(rect.height) / page_height;
+  const double ou = static_cast<double>(rect.x) / page_width;
+  const double ov = static_cast<double>(rect.y) / page_height;
+  for (size_t i = 0; i + 1 < texcoords->size(); i += 2) {
+    float& u = (*texcoords)[i];
+    float& v = (*texcoords)[i + 1];
+    u = static_cast<float>(ou + u * su);
+    if (top_left_origin) {
+      v = static_cast<float>(1.0 - (ov + (1.0 - v) * sv));
+    } else {
+      v = static_cast<float>(ov + v * sv);
+    }
+  }
+}
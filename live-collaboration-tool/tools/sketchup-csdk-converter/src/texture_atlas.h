@@ -0,0 +1,46 @@
+#pragma once
+
+// 작은 텍스처를 공유 atlas 페이지로 묶는 packer.
+// - 각 이미지 둘레에 gutter(가장자리 픽셀 복제)를 두고, 칸 시작점/크기를 align의 배수로 맞춥니다.
+//   align=4면 mip 2단계(4x4 → 1x1)까지 이웃 이미지가 섞이지 않고, 4x4 블록 압축(ETC/BC/ASTC 4x4)도
+//   한 블록에 두 이미지가 들어가지 않습니다.
+// - 좌표와 페이지 픽셀은 아래 행부터입니다 (SketchUp ImageRep / uv의 v축 방향).
+
+#include <cstddef>
+#include <vector>
+
+#include "image_resample.h"
+
+struct AtlasOptions {
+  size_t page_size = 2048;  // 페이지 최대 크기 (정사각)
+  size_t gutter = 4;        // 이미지 한 변당 복제 픽셀 수
+  size_t align = 4;         // 칸 시작점/크기 정렬 (2의 거듭제곱)
+};
+
+// 페이지 안에서 이미지 내용이 놓인 자리 (gutter 제외). page가 -1이면 어느 페이지에도 못 들어감
+struct AtlasRect {
+  int page = -1;
+  size_t x = 0;
+  size_t y = 0;
+  size_t width = 0;
+  size_t height = 0;
+};
+
+struct AtlasLayout {
+  std::vector<AtlasRect> rects;  // 입력 순서
+  // 페이지 크기. 쓰인 영역을 덮는 2의 거듭제곱으로 줄입니다 (page_size 이하)
+  std::vector<size_t> page_width;
+  std::vector<size_t> page_height;
+};
+
+// 높이 → 너비 내림차순 shelf packing. sizes는 (width, height)
+AtlasLayout PackAtlas(const std::vector<std::pair<size_t, size_t>>& sizes, const AtlasOptions& options);
+
+// page 하나를 조립합니다. images는 layout.rects와 같은 순서 (4채널, 채널 배치는 그대로 복사)
+RgbaImage ComposeAtlasPage(
+    const std::vector<RgbaImage>& images, const AtlasLayout& layout, int page, const AtlasOptions& options);
+
+// rect 이미지의 uv를 페이지 uv로 바꿉니다. texcoords는 uv 쌍 배열.
+// top_left_origin=true면 glTF처럼 v가 위에서부터 (t = 1 - v)인 좌표로 취급합니다.
+void RemapAtlasTexcoords(
+    const AtlasRect& rect, size_t page_width, size_t page_height, bool top_left_origin, std::vector<float>* texcoords);
@@ -0,0 +1,460 @@
+#include "tileset_writer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "json_writer.h"
+#include "worker_pool.h"
+
+namespace {
+
+// WGS84 타원체
+constexpr double kWgs84A = 6378137.0;
+constexpr double kWgs84E2 = 6.69437999014e-3;
+constexpr double kPi = 3.14159265358979323846;
+// 두께가 0인 tile(평면 하나)도 box로 쓸 수 있게 하는 최소 반 크기 (m)
+constexpr double kMinHalfExtent = 1e-3;
+
+struct TriangleRef {
+  uint32_t primitive;  // Source::primitives 인덱스
+  uint32_t first;      // primitive indices 안의 첫 인덱스 위치
+  float min[3];
+  float max[3];
+};
+
+struct Source {
+  std::vector<const GltfPrimitive*> primitives;
+  std::vector<TriangleRef> triangles;
+};
+
+struct Tile {
+  std::string address;  // 자식 octant 번호를 이어 붙인 경로 ("" = root)
+  int depth = 0;
+  double center[3] = {0.0, 0.0, 0.0};  // octree 칸 (모델 단위)
+  double half = 0.0;
+  std::vector<uint32_t> triangles;     // 이 tile GLB에 들어가는 삼각형 (TriangleRef 인덱스)
+  std::vector<size_t> children;
+  // 내용 / 하위 tile 전체의 실제 바운딩 박스 (모델 단위)
+  double content_min[3] = {0.0, 0.0, 0.0};
+  double content_max[3] = {0.0, 0.0, 0.0};
+  double min[3] = {0.0, 0.0, 0.0};
+  double max[3] = {0.0, 0.0, 0.0};
+  bool empty = true;  // 하위까지 삼각형이 없음
+};
+
+std::string TileName(const Tile& tile) { return "r" + tile.address; }
+
+void Expand(const float* lo, const float* hi, double* min, double* max) {
+  for (int k = 0; k < 3; k++) {
+    min[k] = std::min(min[k], static_cast<double>(lo[k]));
+    max[k] = std::max(max[k], static_cast<double>(hi[k]));
+  }
+}
+
+double Diagonal(const double* min, const double* max) {
+  const double dx = max[0] - min[0];
+  const double dy = max[1] - min[1];
+  const double dz = max[2] - min[2];
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+Source CollectTriangles(const GltfScene& scene) {
+  Source src;
+  for (const GltfMesh& mesh : scene.meshes) {
+    for (const GltfPrimitive& prim : mesh.primitives) {
+      if (prim.indices.size() < 3) continue;
+      const uint32_t p = static_cast<uint32_t>(src.primitives.size());
+      src.primitives.push_back(&prim);
+      for (size_t i = 0; i + 2 < prim.indices.size(); i += 3) {
+        TriangleRef t{p, static_cast<uint32_t>(i), {0, 0, 0}, {0, 0, 0}};
+        for (int k = 0; k < 3; k++) {
+          const float a = prim.positions[prim.indices[i] * 3 + k];
+          const float b = prim.positions[prim.indices[i + 1] * 3 + k];
+          const float c = prim.positions[prim.indices[i + 2] * 3 + k];
+          t.min[k] = std::min(a, std::min(b, c));
+          t.max[k] = std::max(a, std::max(b, c));
+        }
+        src.triangles.push_back(t);
+      }
+    }
+  }
+  return src;
+}
+
+// tiles[t]의 list를 내용과 자식으로 나누고 바운딩 박스를 채웁니다.
+// (tiles가 자라며 참조가 무효가 되므로 인덱스로만 접근)
+void BuildTile(std::vector<Tile>* tiles, size_t t, std::vector<uint32_t> list, const Source& src,
+               const TilesetOptions& options) {
+  const double half = (*tiles)[t].half;
+  double center[3];
+  std::copy((*tiles)[t].center, (*tiles)[t].center + 3, center);
+
+  std::vector<uint32_t> kept;
+  std::vector<uint32_t> child_lists[8];
+  if (list.size() > options.max_tile_triangles && (*tiles)[t].depth < options.max_depth) {
+    for (uint32_t i : list) {
+      const TriangleRef& tri = src.triangles[i];
+      int octant = 0;
+      bool fits = true;
+      for (int k = 0; k < 3; k++) {
+        const double mid = 0.5 * (static_cast<double>(tri.min[k]) + tri.max[k]);
+        const bool upper = mid >= center[k];
+        if (upper) octant |= 1 << k;
+        // 자식 칸(반 크기 half/2)을 두 배로 넓힌 loose 영역: 중심 ± half
+        const double child_center = center[k] + (upper ? 0.5 : -0.5) * half;
+        if (tri.min[k] < child_center - half || tri.max[k] > child_center + half) fits = false;
+      }
+      if (fits) {
+        child_lists[octant].push_back(i);
+      } else {
+        kept.push_back(i);
+      }
+    }
+    if (kept.size() == list.size()) {
+      // 모두 칸 경계에 걸침: 더 나눠도 줄지 않음
+      for (std::vector<uint32_t>& c : child_lists) c.clear();
+    } else {
+      list.clear();
+      list.shrink_to_fit();
+      list.swap(kept);
+    }
+  }
+
+  {
+    Tile& tile = (*tiles)[t];
+    tile.triangles = std::move(list);
+    for (int k = 0; k < 3; k++) {
+      tile.content_min[k] = tile.min[k] = std::numeric_limits<double>::max();
+      tile.content_max[k] = tile.max[k] = std::numeric_limits<double>::lowest();
+    }
+    for (uint32_t i : tile.triangles) {
+      Expand(src.triangles[i].min, src.triangles[i].max, tile.content_min, tile.content_max);
+    }
+    tile.empty = tile.triangles.empty();
+    if (!tile.empty) {
+      std::copy(tile.content_min, tile.content_min + 3, tile.min);
+      std::copy(tile.content_max, tile.content_max + 3, tile.max);
+    }
+  }
+
+  for (int octant = 0; octant < 8; octant++) {
+    if (child_lists[octant].empty()) continue;
+    Tile child;
+    child.address = (*tiles)[t].address + static_cast<char>('0' + octant);
+    child.depth = (*tiles)[t].depth + 1;
+    child.half = 0.5 * half;
+    for (int k = 0; k < 3; k++) child.center[k] = center[k] + ((octant >> k) & 1 ? 0.5 : -0.5) * half;
+    const size_t c = tiles->size();
+    tiles->push_back(std::move(child));
+    (*tiles)[t].children.push_back(c);
+    BuildTile(tiles, c, std::move(child_lists[octant]), src, options);
+    if ((*tiles)[c].empty) continue;
+    Tile& tile = (*tiles)[t];
+    for (int k = 0; k < 3; k++) {
+      tile.min[k] = std::min(tile.min[k], (*tiles)[c].min[k]);
+      tile.max[k] = std::max(tile.max[k], (*tiles)[c].max[k]);
+    }
+    tile.empty = false;
+  }
+}
+
+// 이 tile만 그리고 자식을 그리지 않을 때 빠지는 geometry 크기 (m). 자식이 없으면 0
+double GeometricError(const std::vector<Tile>& tiles, const Tile& tile, double scale) {
+  double error = 0.0;
+  for (size_t c : tile.children) {
+    if (!tiles[c].empty) error = std::max(error, Diagonal(tiles[c].min, tiles[c].max) * scale);
+  }
+  return error;
+}
+
+// 모델 좌표(Z-up, 모델 단위)에서 center를 뺀 정점을 glTF(Y-up, 미터)로 돌리는 root node 행렬.
+// 3D Tiles 런타임이 glTF Y-up을 Z-up으로 되돌리므로 tileset 좌표는 모델 축 그대로인 미터가 됩니다.
+void TileNodeMatrix(const double center[3], double scale, double m[16]) {
+  std::fill(m, m + 16, 0.0);
+  m[0] = scale;    // x → x
+  m[6] = -scale;   // y → -z
+  m[9] = scale;    // z → y
+  m[12] = scale * center[0];
+  m[13] = scale * center[2];
+  m[14] = -scale * center[1];
+  m[15] = 1.0;
+}
+
+// tile 삼각형만 담은 GltfScene. material/image는 쓰이는 것만 남기고 image uri는 tiles/ 기준으로 바꿉니다.
+GltfScene TileScene(const GltfScene& scene, const Source& src, const Tile& tile, const TilesetOptions& options) {
+  GltfScene out;
+  double center[3];
+  for (int k = 0; k < 3; k++) center[k] = 0.5 * (tile.content_min[k] + tile.content_max[k]);
+
+  std::map<int, std::vector<uint32_t>> by_material;  // 원래 순서(최적화된 순서)를 material별로 유지
+  for (uint32_t i : tile.triangles) by_material[src.primitives[src.triangles[i].primitive]->material].push_back(i);
+
+  std::vector<int> material_remap(scene.materials.size(), -1);
+  std::vector<int> image_remap(scene.images.size(), -1);
+  GltfMesh mesh;
+  mesh.name = "tile_" + TileName(tile);
+  for (const auto& group : by_material) {
+    int material = group.first;
+    if (material >= 0) {
+      if (material_remap[material] < 0) {
+        GltfMaterial m = scene.materials[material];
+        if (m.image >= 0) {
+          if (image_remap[m.image] < 0) {
+            GltfImage img = scene.images[m.image];
+            img.uri = "../" + img.uri;
+            if (!img.basisu_uri.empty()) img.basisu_uri = "../" + img.basisu_uri;
+            image_remap[m.image] = static_cast<int>(out.images.size());
+            out.images.push_back(std::move(img));
+          }
+          m.image = image_remap[m.image];
+        }
+        material_remap[material] = static_cast<int>(out.materials.size());
+        out.materials.push_back(std::move(m));
+      }
+      material = material_remap[material];
+    }
+
+    std::unordered_map<uint64_t, uint32_t> remap;  // (원본 primitive, 정점) → 새 정점
+    GltfPrimitive* prim = nullptr;
+    for (uint32_t i : group.second) {
+      const TriangleRef& tri = src.triangles[i];
+      const GltfPrimitive& from = *src.primitives[tri.primitive];
+      if (!prim || prim->vertex_count() + 3 > options.max_primitive_vertices) {
+        mesh.primitives.emplace_back();
+        prim = &mesh.primitives.back();
+        prim->material = material;
+        remap.clear();
+      }
+      const bool has_normals = from.normals.size() == from.positions.size();
+      const bool has_texcoords = from.texcoords.size() / 2 == from.vertex_count();
+      for (int corner = 0; corner < 3; corner++) {
+        const uint32_t v = from.indices[tri.first + corner];
+        const uint64_t key = (static_cast<uint64_t>(tri.primitive) << 32) | v;
+        auto it = remap.find(key);
+        if (it == remap.end()) {
+          it = remap.emplace(key, static_cast<uint32_t>(prim->vertex_count())).first;
+          for (int k = 0; k < 3; k++) {
+            prim->positions.push_back(static_cast<float>(from.positions[v * 3 + k] - center[k]));
+          }
+          if (has_normals) prim->normals.insert(prim->normals.end(), &from.normals[v * 3], &from.normals[v * 3] + 3);
+          if (has_texcoords) {
+            prim->texcoords.insert(prim->texcoords.end(), &from.texcoords[v * 2], &from.texcoords[v * 2] + 2);
+          }
+        }
+        prim->indices.push_back(it->second);
+      }
+    }
+  }
+  out.meshes.push_back(std::move(mesh));
+
+  GltfNode node;
+  node.name = "tile_" + TileName(tile);
+  node.mesh = 0;
+  node.has_matrix = true;
+  TileNodeMatrix(center, options.units_to_meters, node.matrix);
+  out.nodes.push_back(std::move(node));
+  out.roots.push_back(0);
+  return out;
+}
+
+void MergeStats(const GlbWriteStats& from, GlbWriteStats* to) {
+  to->geometry_bytes += from.geometry_bytes;
+  to->compressed_bytes += from.compressed_bytes;
+  to->encode_seconds += from.encode_seconds;
+  to->float_vertex_bytes += from.float_vertex_bytes;
+  to->quantized_vertex_bytes += from.quantized_vertex_bytes;
+  to->position_error = std::max(to->position_error, from.position_error);
+  to->normal_error_degrees = std::max(to->normal_error_degrees, from.normal_error_degrees);
+  to->texcoord_error = std::max(to->texcoord_error, from.texcoord_error);
+  to->embedded_images += from.embedded_images;
+  to->embedded_image_bytes += from.embedded_image_bytes;
+}
+
+void WriteTileJson(const std::vector<Tile>& tiles, size_t t, const TilesetOptions& options, JsonWriter& j) {
+  const Tile& tile = tiles[t];
+  const double s = options.units_to_meters;
+  j.begin_object();
+  if (t == 0 && options.has_root_transform) {
+    j.key("transform");
+    j.begin_array();
+    for (double v : options.root_transform) j.precise_value(v);
+    j.end_array();
+  }
+  j.key("boundingVolume");
+  j.begin_object();
+  j.key("box");
+  j.begin_array();
+  double half[3];
+  for (int k = 0; k < 3; k++) {
+    j.value(tile.empty ? 0.0 : 0.5 * (tile.min[k] + tile.max[k]) * s);
+    half[k] = std::max(kMinHalfExtent, tile.empty ? 0.0 : 0.5 * (tile.max[k] - tile.min[k]) * s);
+  }
+  for (int axis = 0; axis < 3; axis++) {
+    for (int k = 0; k < 3; k++) j.value(k == axis ? half[axis] : 0.0);
+  }
+  j.end_array();
+  j.end_object();
+  j.field("geometricError", GeometricError(tiles, tile, s));
+  if (t == 0) j.field("refine", "ADD");
+  if (!tile.triangles.empty()) {
+    j.key("content");
+    j.begin_object();
+    j.field("uri", "tiles/" + TileName(tile) + ".glb");
+    j.end_object();
+  }
+  bool has_children = false;
+  for (size_t c : tile.children) {
+    if (tiles[c].empty) continue;
+    if (!has_children) {
+      j.key("children");
+      j.begin_array();
+      has_children = true;
+    }
+    WriteTileJson(tiles, c, options, j);
+  }
+  if (has_children) j.end_array();
+  j.end_object();
+}
+
+}  // namespace
+
+void GeoreferenceTransform(double latitude, double longitude, double height, double north_correction,
+                           double out[16]) {
+  const double phi = latitude * kPi / 180.0;
+  const double lambda = longitude * kPi / 180.0;
+  const double theta = north_correction * kPi / 180.0;
+  const double sp = std::sin(phi), cp = std::cos(phi);
+  const double sl = std::sin(lambda), cl = std::cos(lambda);
+  const double east[3] = {-sl, cl, 0.0};
+  const double north[3] = {-sp * cl, -sp * sl, cp};
+  const double up[3] = {cp * cl, cp * sl, sp};
+  const double n = kWgs84A / std::sqrt(1.0 - kWgs84E2 * sp * sp);
+  const double origin[3] = {(n + height) * cp * cl, (n + height) * cp * sl, (n * (1.0 - kWgs84E2) + height) * sp};
+  // 모델 x/y축은 ENU의 동/북을 theta만큼 돌린 방향
+  const double ct = std::cos(theta), st = std::sin(theta);
+  for (int k = 0; k < 3; k++) {
+    out[k] = ct * east[k] + st * north[k];
+    out[4 + k] = -st * east[k] + ct * north[k];
+    out[8 + k] = up[k];
+    out[12 + k] = origin[k];
+  }
+  out[3] = out[7] = out[11] = 0.0;
+  out[15] = 1.0;
+}
+
+bool WriteTileset(const GltfScene& scene,
+                  const std::filesystem::path& out_dir,
+                  const TilesetOptions& options,
+                  TilesetStats* stats,
+                  std::string* error) {
+  const Source src = CollectTriangles(scene);
+  if (src.triangles.size() > UINT32_MAX) {
+    if (error) *error = "too many triangles for tiling";
+    return false;
+  }
+
+  // root 칸: 주어진 영역과 geometry를 모두 덮는 정육면체
+  double min[3];
+  double max[3];
+  std::copy(options.bounds_min, options.bounds_min + 3, min);
+  std::copy(options.bounds_max, options.bounds_max + 3, max);
+  for (const TriangleRef& t : src.triangles) Expand(t.min, t.max, min, max);
+  std::vector<Tile> tiles(1);
+  if (!src.triangles.empty()) {
+    double extent = 0.0;
+    for (int k = 0; k < 3; k++) {
+      tiles[0].center[k] = 0.5 * (min[k] + max[k]);
+      extent = std::max(extent, max[k] - min[k]);
+    }
+    tiles[0].half = 0.5 * extent;
+    std::vector<uint32_t> all(src.triangles.size());
+    for (size_t i = 0; i < all.size(); i++) all[i] = static_cast<uint32_t>(i);
+    BuildTile(&tiles, 0, std::move(all), src, options);
+  }
+
+  // 이전 변환의 tile이 섞이지 않게 tiles/를 새로 만듭니다.
+  std::error_code ec;
+  std::filesystem::remove_all(out_dir / "tiles", ec);
+  std::filesystem::create_directories(out_dir / "tiles", ec);
+  if (ec) {
+    if (error) *error = "failed to create " + (out_dir / "tiles").string();
+    return false;
+  }
+
+  // 텍스처는 여러 tile이 같이 쓰므로 tile GLB에 넣지 않고 ../model/* 파일을 공유합니다.
+  // (넣으면 tile마다 사본이 생겨 tileset이 단일 GLB보다 커짐)
+  GlbWriteOptions glb_options = options.glb;
+  glb_options.embed_images = false;
+
+  TilesetStats local;
+  local.triangles = src.triangles.size();
+  std::mutex mutex;
+  std::string first_error;
+  auto write_tile = [&](size_t t) {
+    const GltfScene tile_scene = TileScene(scene, src, tiles[t], options);
+    const std::filesystem::path path = out_dir / "tiles" / (TileName(tiles[t]) + ".glb");
+    GlbWriteStats tile_stats;
+    std::string tile_error;
+    const bool ok = WriteGlb(tile_scene, path, glb_options, &tile_stats, &tile_error);
+    std::error_code size_ec;
+    const uintmax_t bytes = ok ? std::filesystem::file_size(path, size_ec) : 0;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ok) {
+      if (first_error.empty()) first_error = path.filename().string() + ": " + tile_error;
+      return;
+    }
+    MergeStats(tile_stats, &local.glb);
+    if (!size_ec) local.glb_bytes += static_cast<size_t>(bytes);
+  };
+
+  std::unique_ptr<WorkerPool> pool;
+  if (options.threads > 1) pool = std::make_unique<WorkerPool>(options.threads, static_cast<size_t>(options.threads) * 2);
+  for (size_t t = 0; t < tiles.size(); t++) {
+    if (tiles[t].empty) continue;
+    local.tiles++;
+    local.depth = std::max(local.depth, tiles[t].depth);
+    if (tiles[t].triangles.empty()) continue;
+    local.content_tiles++;
+    local.max_tile_triangles = std::max(local.max_tile_triangles, tiles[t].triangles.size());
+    if (pool) {
+      pool->submit([&write_tile, t] { write_tile(t); });
+    } else {
+      write_tile(t);
+    }
+  }
+  if (pool) pool->wait();
+  if (!first_error.empty()) {
+    if (error) *error = first_error;
+    return false;
+  }
+  if (local.tiles == 0) local.tiles = 1;  // 빈 모델도 내용 없는 root tile 하나
+
+  JsonWriter j;
+  j.begin_object();
+  j.key("asset");
+  j.begin_object();
+  j.field("version", "1.1");
+  j.field("generator", "sketchup-csdk-converter");
+  j.end_object();
+  j.field("geometricError", tiles[0].empty ? 0.0 : Diagonal(tiles[0].min, tiles[0].max) * options.units_to_meters);
+  j.key("root");
+  WriteTileJson(tiles, 0, options, j);
+  j.end_object();
+
+  const std::filesystem::path path = out_dir / "tileset.json";
+  std::ofstream f(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  f << j.str();
+  if (!f.good()) {
+    if (error) *error = "failed to write " + path.string();
+    return false;
+  }
+  if (stats) *stats = local;
+  return true;
+}
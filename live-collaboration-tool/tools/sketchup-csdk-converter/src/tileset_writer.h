@@ -0,0 +1,62 @@
+#pragma once
+
+// 큰 모델 스트리밍용 3D Tiles 1.1 타일 출력.
+// 월드 좌표 geometry(flat 배치)를 loose octree로 나눠 tile마다 GLB 하나를 쓰고, tileset.json에
+// bounding volume / geometric error / 계층을 기록합니다.
+// - 삼각형은 중심이 속한 자식 칸을 두 배로 넓힌 영역(loose octree) 안에 들어가면 자식으로 내려가고,
+//   아니면 부모 tile에 남습니다. 그래서 부모 내용을 자식이 대신하지 않는 ADD refine입니다.
+// - tile GLB는 glTF 규약(Y-up, 미터)으로 root node 변환을 두므로 tileset 좌표는 모델 축(Z-up) 그대로인 미터입니다.
+
+#include <cstddef>
+#include <filesystem>
+#include <limits>
+#include <string>
+
+#include "glb_writer.h"
+#include "gltf_scene.h"
+
+struct TilesetOptions {
+  // 삼각형이 이보다 많은 tile은 8개 자식으로 나눕니다.
+  size_t max_tile_triangles = 50000;
+  int max_depth = 10;
+  double units_to_meters = 0.0254;  // SketchUp 내부 단위는 inch
+  // 분할 기준 영역 (모델 단위). min > max면 geometry에서 계산하고, 주어져도 geometry를 모두 포함하게 넓힙니다.
+  double bounds_min[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                          std::numeric_limits<double>::max()};
+  double bounds_max[3] = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(),
+                          std::numeric_limits<double>::lowest()};
+  // root tile transform (column-major, tileset 좌표 → ECEF). 지리 참조 모델만
+  bool has_root_transform = false;
+  double root_transform[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+  // tile primitive 최대 정점 수 (material이 같아도 넘으면 primitive를 나눔)
+  size_t max_primitive_vertices = kMaxIntIndexVertices;
+  // tile GLB 기록 worker 수 (1 = 호출 스레드에서)
+  unsigned threads = 1;
+  // tile GLB 기록 옵션. embed_images는 무시하고 항상 외부 텍스처(../model/*)를 참조합니다.
+  GlbWriteOptions glb;
+};
+
+struct TilesetStats {
+  size_t tiles = 0;          // tileset.json의 tile 수
+  size_t content_tiles = 0;  // GLB를 가진 tile 수
+  int depth = 0;
+  size_t triangles = 0;
+  size_t max_tile_triangles = 0;
+  size_t glb_bytes = 0;  // tile GLB 합
+  // tile별 기록 통계 합 (오차는 최댓값, fallback_path는 비움)
+  GlbWriteStats glb;
+};
+
+// 위도/경도(도)·타원체 높이(m)에 놓인 모델 원점의 지역 좌표(동-북-위, 미터)를 ECEF로 옮기는 행렬 (WGS84).
+// north_correction(도)은 북쪽을 모델 y축으로 돌리는 각도(SUModelGetNorthCorrection)로, 모델 축을 ENU로 돌립니다.
+void GeoreferenceTransform(double latitude, double longitude, double height, double north_correction,
+                           double out[16]);
+
+// scene의 모든 mesh를 월드 좌표로 보고(node 변환/인스턴스 무시) out_dir/tileset.json과
+// out_dir/tiles/*.glb를 씁니다. image uri는 out_dir 기준 상대 경로여야 합니다.
+// 성공 시 true. 실패하면 error에 원인을 채웁니다. stats는 nullptr 가능.
+bool WriteTileset(const GltfScene& scene,
+                  const std::filesystem::path& out_dir,
+                  const TilesetOptions& options,
+                  TilesetStats* stats,
+                  std::string* error);
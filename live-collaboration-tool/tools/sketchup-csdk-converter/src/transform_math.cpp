@@ -0,0 +1,129 @@
+#include "transform_math.h"
+
+#include <cmath>
+
+namespace {
+
+constexpr double kOrthoTolerance = 1e-4;
+
+double Dot3(const double* a, const double* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+}  // namespace
+
+bool DecomposeTRS(const double m[16], TRS* out) {
+  // 원근 성분 없음 + w 정규화 가능
+  if (m[3] != 0.0 || m[7] != 0.0 || m[11] != 0.0) return false;
+  if (std::fabs(m[15]) < 1e-12) return false;
+  const double inv_w = 1.0 / m[15];
+
+  double col[3][3];
+  for (int c = 0; c < 3; c++) {
+    for (int r = 0; r < 3; r++) col[c][r] = m[c * 4 + r] * inv_w;
+  }
+  for (int r = 0; r < 3; r++) out->translation[r] = m[12 + r] * inv_w;
+
+  for (int c = 0; c < 3; c++) {
+    const double len = std::sqrt(Dot3(col[c], col[c]));
+    if (len < 1e-12) return false;
+    out->scale[c] = len;
+    for (int r = 0; r < 3; r++) col[c][r] /= len;
+  }
+
+  if (std::fabs(Dot3(col[0], col[1])) > kOrthoTolerance ||
+      std::fabs(Dot3(col[0], col[2])) > kOrthoTolerance ||
+      std::fabs(Dot3(col[1], col[2])) > kOrthoTolerance) {
+    return false;
+  }
+
+  // det < 0 → 미러. x축을 뒤집어 순수 회전으로 만듭니다.
+  const double cross[3] = {
+      col[0][1] * col[1][2] - col[0][2] * col[1][1],
+      col[0][2] * col[1][0] - col[0][0] * col[1][2],
+      col[0][0] * col[1][1] - col[0][1] * col[1][0],
+  };
+  if (Dot3(cross, col[2]) < 0.0) {
+    out->scale[0] = -out->scale[0];
+    for (int r = 0; r < 3; r++) col[0][r] = -col[0][r];
+  }
+
+  // 회전 행렬(R[row][col] = col[col][row]) → quaternion
+  const double m00 = col[0][0], m01 = col[1][0], m02 = col[2][0];
+  const double m10 = col[0][1], m11 = col[1][1], m12 = col[2][1];
+  const double m20 = col[0][2], m21 = col[1][2], m22 = col[2][2];
+  const double trace = m00 + m11 + m22;
+  double x, y, z, w;
+  if (trace > 0.0) {
+    const double s = std::sqrt(trace + 1.0) * 2.0;
+    w = 0.25 * s;
+    x = (m21 - m12) / s;
+    y = (m02 - m20) / s;
+    z = (m10 - m01) / s;
+  } else if (m00 > m11 && m00 > m22) {
+    const double s = std::sqrt(1.0 + m00 - m11 - m22) * 2.0;
+    w = (m21 - m12) / s;
+    x = 0.25 * s;
+    y = (m01 + m10) / s;
+    z = (m02 + m20) / s;
+  } else if (m11 > m22) {
+    const double s = std::sqrt(1.0 + m11 - m00 - m22) * 2.0;
+    w = (m02 - m20) / s;
+    x = (m01 + m10) / s;
+    y = 0.25 * s;
+    z = (m12 + m21) / s;
+  } else {
+    const double s = std::sqrt(1.0 + m22 - m00 - m11) * 2.0;
+    w = (m10 - m01) / s;
+    x = (m02 + m20) / s;
+    y = (m12 + m21) / s;
+    z = 0.25 * s;
+  }
+  const double qlen = std::sqrt(x * x + y * y + z * z + w * w);
+  out->rotation[0] = x / qlen;
+  out->rotation[1] = y / qlen;
+  out->rotation[2] = z / qlen;
+  out->rotation[3] = w / qlen;
+  return true;
+}
+
+void NormalizeHomogeneous(const double m[16], double out[16]) {
+  const double w = m[15];
+  if (std::fabs(w) < 1e-12) {
+    for (int i = 0; i < 16; i++) out[i] = m[i];
+    return;
+  }
+  const double inv_w = 1.0 / w;
+  for (int i = 0; i < 15; i++) out[i] = m[i] * inv_w;
+  out[15] = 1.0;
+}
+
+Matrix4 IdentityMatrix() {
+  Matrix4 m{};
+  m[0] = m[5] = m[10] = m[15] = 1.0;
+  return m;
+}
+
+Matrix4 Multiply(const Matrix4& a, const Matrix4& b) {
+  Matrix4 out{};
+  for (int col = 0; col < 4; col++) {
+    for (int row = 0; row < 4; row++) {
+      double sum = 0.0;
+      for (int k = 0; k < 4; k++) sum += a[k * 4 + row] * b[col * 4 + k];
+      out[col * 4 + row] = sum;
+    }
+  }
+  return out;
+}
+
+Matrix4 InstanceMatrix(const GltfInstance& inst) {
+  const double x = inst.rotation[0], y = inst.rotation[1], z = inst.rotation[2], w = inst.rotation[3];
+  const double r[3][3] = {{1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y)},
+                          {2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x)},
+                          {2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y)}};
+  Matrix4 m{};
+  for (int col = 0; col < 3; col++) {
+    for (int row = 0; row < 3; row++) m[col * 4 + row] = r[row][col] * inst.scale[col];
+    m[12 + col] = inst.translation[col];
+  }
+  m[15] = 1.0;
+  return m;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// 4x4 변환 행렬 도우미 (column-major, SUTransformation::values / glTF node.matrix와 같은 배치).
+
+#include <array>
+
+#include "gltf_scene.h"
+
+using Matrix4 = std::array<double, 16>;  // column-major
+
+// translation / rotation(quaternion xyzw) / scale 분해 결과
+struct TRS {
+  double translation[3] = {0.0, 0.0, 0.0};
+  double rotation[4] = {0.0, 0.0, 0.0, 1.0};
+  double scale[3] = {1.0, 1.0, 1.0};
+};
+
+// m = T * R * S 로 분해합니다.
+// - SketchUp은 균일 스케일을 m[15](w)에 담기도 하므로 w로 나눠 정규화합니다.
+// - 원근 성분이 있거나 축이 직교하지 않으면(shear) TRS로 표현할 수 없어 false를 반환합니다.
+// - 행렬식이 음수(미러)면 x 스케일을 음수로 둡니다.
+bool DecomposeTRS(const double m[16], TRS* out);
+
+// m[15](w)로 나눠 w=1인 행렬로 만듭니다. (SketchUp 균일 스케일 표현 → glTF node.matrix)
+// w가 0에 가까우면 그대로 복사합니다.
+void NormalizeHomogeneous(const double m[16], double out[16]);
+
+Matrix4 IdentityMatrix();
+
+// a * b (b를 먼저 적용)
+Matrix4 Multiply(const Matrix4& a, const Matrix4& b);
+
+// EXT_mesh_gpu_instancing 인스턴스의 T * R * S
+Matrix4 InstanceMatrix(const GltfInstance& inst);
@@ -0,0 +1,25 @@
+#pragma once
+
+// 경로 압축 union-find (smoothing group, 동일 평면 face 묶기 등 모듈 내부용).
+
+#include <cstddef>
+#include <vector>
+
+struct UnionFind {
+  explicit UnionFind(size_t n) : parent(n) {
+    for (size_t i = 0; i < n; i++) parent[i] = static_cast<int>(i);
+  }
+  int find(int x) {
+    while (parent[x] != x) {
+      parent[x] = parent[parent[x]];
+      x = parent[x];
+    }
+    return x;
+  }
+  void unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a != b) parent[b] = a;
+  }
+  std::vector<int> parent;
+};
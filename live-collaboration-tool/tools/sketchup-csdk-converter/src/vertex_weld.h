@@ -0,0 +1,89 @@
+#pragma once
+
+// 해시 기반 정점 용접(weld).
+// 값을 epsilon 격자로 양자화한 키로 중복을 찾아 같은 인덱스를 돌려줍니다.
+// - OBJ: position / normal / uv를 각각 별도 풀로 (f a/b/c가 따로 참조)
+// - glTF: (position, normal, uv) 묶음 하나를 키로 (정점 속성이 인덱스를 공유)
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+template <int N>
+class WeldPool {
+ public:
+  // epsilon <= 0 이면 비트 단위로 완전히 같은 값만 합칩니다.
+  explicit WeldPool(double epsilon = 0.0) : inv_epsilon_(epsilon > 0.0 ? 1.0 / epsilon : 0.0) {}
+
+  // 같은 칸의 값이 이미 있으면 그 인덱스, 없으면 새 인덱스(0-based)를 반환
+  uint32_t insert(const std::array<double, N>& v, bool* inserted) {
+    const Key key = quantize(v);
+    auto it = map_.find(key);
+    if (it != map_.end()) {
+      if (inserted) *inserted = false;
+      return it->second;
+    }
+    const uint32_t index = static_cast<uint32_t>(map_.size());
+    map_.emplace(key, index);
+    if (inserted) *inserted = true;
+    return index;
+  }
+
+  // 같은 칸의 값이 있으면 그 인덱스를 *index에 넣고 true (추가하지 않음)
+  bool find(const std::array<double, N>& v, uint32_t* index) const {
+    auto it = map_.find(quantize(v));
+    if (it == map_.end()) return false;
+    *index = it->second;
+    return true;
+  }
+
+  size_t size() const { return map_.size(); }
+  void reserve(size_t n) { map_.reserve(n); }
+
+ private:
+  struct Key {
+    std::array<int64_t, N> q;
+    bool operator==(const Key& o) const { return q == o.q; }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& k) const {
+      // splitmix64 기반 결합
+      uint64_t h = 0x9E3779B97F4A7C15ull;
+      for (int64_t x : k.q) {
+        uint64_t z = h ^ static_cast<uint64_t>(x);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        h = (z ^ (z >> 31)) + 0x9E3779B97F4A7C15ull;
+      }
+      return static_cast<size_t>(h);
+    }
+  };
+
+  Key quantize(const std::array<double, N>& v) const {
+    Key k;
+    for (int i = 0; i < N; i++) {
+      if (inv_epsilon_ > 0.0) {
+        k.q[i] = std::llround(v[i] * inv_epsilon_);
+      } else {
+        const double d = v[i] == 0.0 ? 0.0 : v[i];  // -0.0 == 0.0
+        std::memcpy(&k.q[i], &d, sizeof(d));
+      }
+    }
+    return k;
+  }
+
+  double inv_epsilon_;
+  std::unordered_map<Key, uint32_t, KeyHash> map_;
+};
+
+// 용접 결과 집계 (리포트용)
+struct WeldStats {
+  size_t corners = 0;    // 삼각형 코너 수 (용접 전 정점 수)
+  size_t positions = 0;  // 출력된 유니크 position 수
+  size_t normals = 0;
+  size_t texcoords = 0;
+  size_t vertices = 0;   // glTF: 출력된 유니크 (position, normal, uv) 정점 수
+};
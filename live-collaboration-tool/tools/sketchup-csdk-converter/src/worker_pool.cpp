@@ -0,0 +1,140 @@
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+// /proc/self/cgroup에서 controller의 cgroup 경로 ("0::/a/b" 또는 "3:cpu,cpuacct:/a/b"). v2는 controller ""
+std::string CgroupPath(const std::string& controller) {
+  std::ifstream f("/proc/self/cgroup");
+  std::string line;
+  while (std::getline(f, line)) {
+    const size_t a = line.find(':');
+    const size_t b = a == std::string::npos ? std::string::npos : line.find(':', a + 1);
+    if (b == std::string::npos) continue;
+    if (controller.empty()) {
+      if (b == a + 1) return line.substr(b + 1);
+      continue;
+    }
+    std::stringstream list(line.substr(a + 1, b - a - 1));
+    std::string name;
+    while (std::getline(list, name, ',')) {
+      if (name == controller) return line.substr(b + 1);
+    }
+  }
+  return {};
+}
+
+// 컨테이너 안에서는 보통 자기 cgroup이 "/"로 보이지만, 아니면 경로를 붙인 쪽을 먼저 봅니다.
+bool ReadFirst(const std::vector<std::string>& paths, std::string* content) {
+  for (const std::string& p : paths) {
+    std::ifstream f(p);
+    if (f && std::getline(f, *content)) return true;
+  }
+  return false;
+}
+
+// cgroup CPU quota를 CPU 수로 (올림). 제한이 없으면 0
+unsigned CgroupCpuLimit() {
+  std::string line;
+  const std::string v2 = CgroupPath("");
+  if (ReadFirst({"/sys/fs/cgroup" + v2 + "/cpu.max", "/sys/fs/cgroup/cpu.max"}, &line)) {
+    std::stringstream ss(line);
+    std::string quota;
+    double period = 0.0;
+    ss >> quota >> period;
+    if (quota == "max" || period <= 0.0) return 0;
+    return static_cast<unsigned>(std::max(1.0, std::ceil(std::atof(quota.c_str()) / period)));
+  }
+  const std::string v1 = CgroupPath("cpu");
+  std::string quota_line;
+  std::string period_line;
+  if (ReadFirst({"/sys/fs/cgroup/cpu" + v1 + "/cpu.cfs_quota_us", "/sys/fs/cgroup/cpu,cpuacct" + v1 +
+                 "/cpu.cfs_quota_us", "/sys/fs/cgroup/cpu/cpu.cfs_quota_us"}, &quota_line) &&
+      ReadFirst({"/sys/fs/cgroup/cpu" + v1 + "/cpu.cfs_period_us", "/sys/fs/cgroup/cpu,cpuacct" + v1 +
+                 "/cpu.cfs_period_us", "/sys/fs/cgroup/cpu/cpu.cfs_period_us"}, &period_line)) {
+    const double quota = std::atof(quota_line.c_str());
+    const double period = std::atof(period_line.c_str());
+    if (quota <= 0.0 || period <= 0.0) return 0;  // -1 = 제한 없음
+    return static_cast<unsigned>(std::max(1.0, std::ceil(quota / period)));
+  }
+  return 0;
+}
+
+#endif
+
+}  // namespace
+
+unsigned AvailableCpuCount() {
+  unsigned count = std::thread::hardware_concurrency();
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    const unsigned affinity = static_cast<unsigned>(CPU_COUNT(&set));
+    if (affinity > 0) count = count > 0 ? std::min(count, affinity) : affinity;
+  }
+  const unsigned quota = CgroupCpuLimit();
+  if (quota > 0) count = count > 0 ? std::min(count, quota) : quota;
+#endif
+  return std::max(1u, count);
+}
+
+WorkerPool::WorkerPool(unsigned threads, size_t max_pending) : max_pending_(max_pending) {
+  threads = std::max(1u, threads);
+  for (unsigned i = 0; i < threads; i++) threads_.emplace_back(&WorkerPool::run, this);
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  task_ready_.notify_all();
+  for (std::thread& t : threads_) t.join();
+}
+
+void WorkerPool::submit(std::function<void()> task) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (max_pending_ > 0) slot_free_.wait(lock, [this] { return queue_.size() < max_pending_; });
+  queue_.push_back(std::move(task));
+  lock.unlock();
+  task_ready_.notify_one();
+}
+
+void WorkerPool::wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_.wait(lock, [this] { return queue_.empty() && running_ == 0; });
+}
+
+void WorkerPool::run() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) return;  // stopping_ 이고 남은 작업 없음
+      task = std::move(queue_.front());
+      queue_.pop_front();
+      running_++;
+    }
+    slot_free_.notify_one();
+    task();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_--;
+      if (queue_.empty() && running_ == 0) idle_.notify_all();
+    }
+  }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// 순회 스레드 밖에서 텍스처 인코딩/기록 같은 SDK 비의존 작업을 돌리는 고정 크기 스레드 풀.
+// SketchUp C API는 스레드 안전하지 않으므로 작업 안에서 SU* 함수를 부르면 안 됩니다.
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 이 프로세스가 실제로 쓸 수 있는 CPU 수.
+// hardware_concurrency에 CPU affinity와 cgroup CPU quota(v2 cpu.max, v1 cpu.cfs_quota_us)를 반영합니다.
+unsigned AvailableCpuCount();
+
+class WorkerPool {
+ public:
+  // max_pending: 대기 중인 작업이 이만큼이면 submit이 자리가 날 때까지 기다립니다 (0 = 제한 없음).
+  // 작업이 큰 픽셀 버퍼를 들고 있을 때 메모리 상한 역할을 합니다.
+  explicit WorkerPool(unsigned threads, size_t max_pending = 0);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  void submit(std::function<void()> task);
+  // 제출한 작업이 모두 끝날 때까지 기다립니다.
+  void wait();
+  unsigned size() const { return static_cast<unsigned>(threads_.size()); }
+
+ private:
+  void run();
+
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()>> queue_;
+  std::mutex mutex_;
+  std::condition_variable task_ready_;
+  std::condition_variable slot_free_;
+  std::condition_variable idle_;
+  size_t max_pending_;
+  size_t running_ = 0;
+  bool stopping_ = false;
+};
@@ -0,0 +1,265 @@
+// 동일 평면 face 합치기 검사 (MergeCoplanarFaces).
+// 격자 위 정사각형 face(기울어진 평면 포함)로
+// - 둘로 나뉜 사각형, 구멍이 생기는 고리, 구멍 loop를 가진 face가 한 다각형으로 합쳐지는지
+// - 결과 삼각형이 normal 기준 반시계이고 넓이 합이 원래 face와 같은지, 개수가 V + 2H - 2인지
+// - 결과의 바깥 edge가 원래 묶음의 경계 edge와 정확히 같은지 (정점을 빼거나 더하지 않아 T자 틈이 없음)
+// - 정점에서만 맞닿는 face는 합치지 않거나(이웃 아님) 묶음을 건너뛰는지(경계가 한 정점에서 꼬임)
+// - material이나 uv 매핑이 다르면 합치지 않는지
+// 를 봅니다.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "coplanar_merge.h"
+#include "test_support.h"
+
+namespace {
+
+// (N+1)^2 정점 격자. tilted면 x축으로 30도, z축으로 20도 돌린 평면
+struct Grid {
+  int n = 0;
+  std::vector<double> positions;
+  double normal[3] = {0.0, 0.0, 1.0};
+
+  Grid(int size, bool tilted) : n(size) {
+    const double a = tilted ? 0.5235987755982988 : 0.0;
+    const double b = tilted ? 0.3490658503988659 : 0.0;
+    auto rotate = [&](const double p[3], double out[3]) {
+      const double y = p[1] * std::cos(a) - p[2] * std::sin(a);
+      const double z = p[1] * std::sin(a) + p[2] * std::cos(a);
+      out[0] = p[0] * std::cos(b) - y * std::sin(b);
+      out[1] = p[0] * std::sin(b) + y * std::cos(b);
+      out[2] = z + 7.0;
+    };
+    for (int y = 0; y <= n; y++) {
+      for (int x = 0; x <= n; x++) {
+        const double p[3] = {static_cast<double>(x), static_cast<double>(y), 0.0};
+        double q[3];
+        rotate(p, q);
+        positions.insert(positions.end(), q, q + 3);
+      }
+    }
+    const double z[3] = {0.0, 0.0, 1.0};
+    double origin[3];
+    const double zero[3] = {0.0, 0.0, 0.0};
+    rotate(z, normal);
+    rotate(zero, origin);
+    for (int k = 0; k < 3; k++) normal[k] -= origin[k];
+  }
+  int id(int x, int y) const { return y * (n + 1) + x; }
+
+  // 단위 정사각형 face (반시계). uv = (x, y) * 0.5, u에 uv_offset을 더함
+  CoplanarFace square(int x, int y, int material = 0, float uv_offset = 0.0f) const {
+    CoplanarFace f;
+    std::copy(normal, normal + 3, f.normal);
+    f.material = material;
+    const int xs[4] = {x, x + 1, x + 1, x};
+    const int ys[4] = {y, y, y + 1, y + 1};
+    f.loops.emplace_back();
+    for (int k = 0; k < 4; k++) {
+      f.loops[0].push_back(id(xs[k], ys[k]));
+      f.texcoords.push_back(xs[k] * 0.5f + uv_offset);
+      f.texcoords.push_back(ys[k] * 0.5f);
+    }
+    return f;
+  }
+};
+
+// normal 방향 부호 넓이 (loop 하나)
+double LoopArea(const std::vector<double>& positions, const std::vector<int>& loop, const double n[3]) {
+  double sum[3] = {0.0, 0.0, 0.0};
+  for (size_t i = 0; i < loop.size(); i++) {
+    const double* a = &positions[loop[i] * 3];
+    const double* b = &positions[loop[(i + 1) % loop.size()] * 3];
+    sum[0] += a[1] * b[2] - a[2] * b[1];
+    sum[1] += a[2] * b[0] - a[0] * b[2];
+    sum[2] += a[0] * b[1] - a[1] * b[0];
+  }
+  return 0.5 * (sum[0] * n[0] + sum[1] * n[1] + sum[2] * n[2]);
+}
+
+using Edge = std::pair<int, int>;
+
+// 방향 edge 집합에서 반대 방향이 없는 것 (묶음 경계)
+std::set<Edge> OpenEdges(const std::vector<std::vector<int>>& loops) {
+  std::set<Edge> edges;
+  for (const std::vector<int>& loop : loops) {
+    for (size_t i = 0; i < loop.size(); i++) edges.emplace(loop[i], loop[(i + 1) % loop.size()]);
+  }
+  std::set<Edge> open;
+  for (const Edge& e : edges) {
+    if (!edges.count(Edge(e.second, e.first))) open.insert(e);
+  }
+  return open;
+}
+
+// 합친 묶음 하나를 원래 face와 비교. 반환값은 삼각형 수
+size_t CheckGroup(const std::vector<CoplanarFace>& faces, const std::vector<double>& positions,
+                  const CoplanarGroup& group) {
+  if (!CHECK(group.faces.size() >= 2 && group.triangles.size() % 3 == 0)) return 0;
+  const double* n = faces[group.faces[0]].normal;
+  std::vector<std::vector<int>> face_loops;
+  double face_area = 0.0;
+  for (int f : group.faces) {
+    for (const std::vector<int>& loop : faces[f].loops) {
+      face_loops.push_back(loop);
+      face_area += LoopArea(positions, loop, n);  // 구멍 loop는 시계 방향이라 음수
+    }
+  }
+  std::vector<std::vector<int>> triangles;
+  double triangle_area = 0.0;
+  size_t flipped = 0;
+  for (size_t t = 0; t < group.triangles.size(); t += 3) {
+    triangles.push_back({group.triangles[t], group.triangles[t + 1], group.triangles[t + 2]});
+    const double area = LoopArea(positions, triangles.back(), n);
+    if (area <= 0.0) flipped++;
+    triangle_area += area;
+  }
+  if (!CHECK(flipped == 0)) std::fprintf(stderr, "  %zu triangles not counter-clockwise\n", flipped);
+  if (!CHECK(std::fabs(triangle_area - face_area) < 1e-9 * std::max(1.0, face_area))) {
+    std::fprintf(stderr, "  triangle area %g, face area %g\n", triangle_area, face_area);
+  }
+
+  // 경계: 정점 V개(= 경계 edge 수), loop L개 → 구멍 H = L - 1
+  const std::set<Edge> boundary = OpenEdges(face_loops);
+  size_t loops = 0;
+  std::set<Edge> seen;
+  for (const Edge& e : boundary) {
+    if (seen.count(e)) continue;
+    loops++;
+    Edge at = e;
+    while (seen.insert(at).second) {
+      auto next = boundary.lower_bound(Edge(at.second, INT32_MIN));
+      if (next == boundary.end() || next->first != at.second) break;
+      at = *next;
+    }
+  }
+  const size_t expected = boundary.size() + 2 * (loops - 1) - 2;
+  if (!CHECK(triangles.size() == expected)) {
+    std::fprintf(stderr, "  %zu triangles, expected V + 2H - 2 = %zu\n", triangles.size(), expected);
+  }
+  // 삼각형 바깥 edge = 원래 경계 (경계 정점을 하나도 빼거나 더하지 않음)
+  CHECK(OpenEdges(triangles) == boundary);
+  return triangles.size();
+}
+
+void TestSplitQuad(bool tilted) {
+  const Grid grid(2, tilted);
+  // 대각선으로 나뉜 사각형 → 삼각형 2개
+  std::vector<CoplanarFace> faces(2);
+  for (CoplanarFace& f : faces) {
+    std::copy(grid.normal, grid.normal + 3, f.normal);
+    f.material = 3;
+  }
+  faces[0].loops = {{grid.id(0, 0), grid.id(1, 0), grid.id(1, 1)}};
+  faces[0].texcoords = {0, 0, 1, 0, 1, 1};
+  faces[1].loops = {{grid.id(0, 0), grid.id(1, 1), grid.id(0, 1)}};
+  faces[1].texcoords = {0, 0, 1, 1, 0, 1};
+  CoplanarMergeStats stats;
+  std::vector<CoplanarGroup> groups = MergeCoplanarFaces(faces, grid.positions, &stats);
+  if (CHECK(groups.size() == 1 && stats.groups == 1 && stats.faces == 2)) {
+    CHECK(CheckGroup(faces, grid.positions, groups[0]) == 2);
+  }
+
+  // 두 정사각형으로 나뉜 2x1 사각형: 가운데 edge 양 끝 정점은 경계에 남아 삼각형 4개
+  faces = {grid.square(0, 0), grid.square(1, 0)};
+  groups = MergeCoplanarFaces(faces, grid.positions, nullptr);
+  if (CHECK(groups.size() == 1)) CHECK(CheckGroup(faces, grid.positions, groups[0]) == 4);
+}
+
+void TestHoles(bool tilted) {
+  const Grid grid(4, tilted);
+  // 4x4에서 가운데 2x2를 뺀 고리: 바깥 16 + 구멍 8 정점 → 24개
+  std::vector<CoplanarFace> faces;
+  for (int y = 0; y < 4; y++) {
+    for (int x = 0; x < 4; x++) {
+      if ((x == 1 || x == 2) && (y == 1 || y == 2)) continue;
+      faces.push_back(grid.square(x, y));
+    }
+  }
+  CoplanarMergeStats stats;
+  std::vector<CoplanarGroup> groups = MergeCoplanarFaces(faces, grid.positions, &stats);
+  if (CHECK(groups.size() == 1 && stats.faces == 12 && stats.skipped == 0)) {
+    CHECK(CheckGroup(faces, grid.positions, groups[0]) == 24);
+  }
+
+  // 구멍 loop를 가진 3x3 face + 오른쪽 3x1 face: 바깥 (0,0) (3,0) (4,0) (4,3) (3,3) (0,3), 구멍 4 → 10개
+  CoplanarFace big;
+  std::copy(grid.normal, grid.normal + 3, big.normal);
+  big.material = 0;
+  big.loops = {{grid.id(0, 0), grid.id(3, 0), grid.id(3, 3), grid.id(0, 3)},
+               {grid.id(1, 1), grid.id(1, 2), grid.id(2, 2), grid.id(2, 1)}};
+  const int big_xy[8][2] = {{0, 0}, {3, 0}, {3, 3}, {0, 3}, {1, 1}, {1, 2}, {2, 2}, {2, 1}};
+  for (const auto& p : big_xy) big.texcoords.insert(big.texcoords.end(), {p[0] * 0.5f, p[1] * 0.5f});
+  CoplanarFace right;
+  std::copy(grid.normal, grid.normal + 3, right.normal);
+  right.material = 0;
+  right.loops = {{grid.id(3, 0), grid.id(4, 0), grid.id(4, 3), grid.id(3, 3)}};
+  right.texcoords = {1.5f, 0.0f, 2.0f, 0.0f, 2.0f, 1.5f, 1.5f, 1.5f};
+  faces = {big, right};
+  groups = MergeCoplanarFaces(faces, grid.positions, nullptr);
+  if (CHECK(groups.size() == 1)) CHECK(CheckGroup(faces, grid.positions, groups[0]) == 10);
+}
+
+void TestTouchingVertex() {
+  const Grid grid(4, false);
+  // 정점 하나만 공유 → 이웃이 아니므로 묶음 없음
+  std::vector<CoplanarFace> faces = {grid.square(0, 0), grid.square(1, 1)};
+  CoplanarMergeStats stats;
+  CHECK(MergeCoplanarFaces(faces, grid.positions, &stats).empty());
+  CHECK(stats.groups == 0 && stats.skipped == 0);
+
+  // (1,1)과 (2,2) 칸은 정점 (2,2)에서만 맞닿고 아래쪽을 돌아 edge로 이어짐 →
+  // 경계가 그 정점에서 두 번 지나가 다각형 하나로 잇지 못하므로 건너뜀
+  faces.clear();
+  const int cells[][2] = {{1, 1}, {1, 0}, {2, 0}, {3, 0}, {3, 1}, {3, 2}, {2, 2}};
+  for (const auto& c : cells) faces.push_back(grid.square(c[0], c[1]));
+  stats = CoplanarMergeStats();
+  CHECK(MergeCoplanarFaces(faces, grid.positions, &stats).empty());
+  CHECK(stats.groups == 0 && stats.skipped == 1);
+}
+
+void TestMismatch() {
+  const Grid grid(4, false);
+  // 행마다 uv가 어긋남 → 행 4개씩만 묶임
+  std::vector<CoplanarFace> faces;
+  for (int y = 0; y < 4; y++) {
+    for (int x = 0; x < 4; x++) faces.push_back(grid.square(x, y, 0, 0.25f * y));
+  }
+  CoplanarMergeStats stats;
+  std::vector<CoplanarGroup> groups = MergeCoplanarFaces(faces, grid.positions, &stats);
+  CHECK(groups.size() == 4 && stats.faces == 16);
+  for (const CoplanarGroup& g : groups) {
+    bool same_row = true;
+    for (int f : g.faces) same_row = same_row && f / 4 == g.faces[0] / 4;
+    CHECK(same_row);
+    CHECK(CheckGroup(faces, grid.positions, g) == 8);
+  }
+
+  // uv가 edge 양 끝에서는 같아도 face 안의 매핑이 다르면(한쪽만 늘어남) 합치지 않음
+  faces = {grid.square(0, 0), grid.square(1, 0)};
+  faces[1].texcoords[2] = 1.5f;  // (2,0)의 u만 바꿈. 공유 edge (1,0)-(1,1)의 uv는 그대로
+  faces[1].texcoords[4] = 1.5f;
+  CHECK(MergeCoplanarFaces(faces, grid.positions, nullptr).empty());
+
+  // material이 다르거나 음수면 합치지 않음
+  faces = {grid.square(0, 0, 0), grid.square(1, 0, 1), grid.square(2, 0, -1), grid.square(3, 0, -1)};
+  CHECK(MergeCoplanarFaces(faces, grid.positions, nullptr).empty());
+}
+
+}  // namespace
+
+int main() {
+  for (bool tilted : {false, true}) {
+    TestSplitQuad(tilted);
+    TestHoles(tilted);
+  }
+  TestTouchingVertex();
+  TestMismatch();
+  return test::Finish("coplanar_merge_test");
+}
@@ -0,0 +1,422 @@
+// WriteGlb 출력 구조 검사.
+// 합성 scene(부모 matrix + 자식 node, 색상/텍스처 material, 정점 65535개 초과 mesh)을 GLB로 쓰고 다시 읽어
+// - 헤더 magic/version/length, JSON → BIN 청크 순서, 청크 길이와 파일 크기의 4바이트 정렬
+// - bufferView 범위가 BIN 청크 안인지, accessor 범위가 bufferView 안이고 component 크기에 맞게 정렬되는지
+// - accessor min/max가 실제 데이터의 최소/최대와 같은지
+// - float 경로: 정점/인덱스가 입력과 같은지
+// - --quantize 경로: node matrix, int16/int8 정규화, KHR_texture_transform scale로 복원한 값과 입력의 차이가
+//   GlbWriteStats에 보고된 position_error / normal_error_degrees / texcoord_error 안인지
+// 를 봅니다.
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "glb_writer.h"
+#include "test_support.h"
+
+namespace {
+
+constexpr uint32_t kGlbMagic = 0x46546C67;  // "glTF"
+constexpr uint32_t kChunkJson = 0x4E4F534A;
+constexpr uint32_t kChunkBin = 0x004E4942;
+
+// test::SphereScene에 격자 mesh와 node를 붙임
+GltfScene MakeScene() {
+  GltfScene scene = test::SphereScene();
+
+  // mesh 1: 정점 260 x 260개 격자 (UNSIGNED_INT 인덱스), normal/uv 없음
+  GltfMesh grid;
+  grid.name = "grid";
+  GltfPrimitive prim;
+  prim.material = 0;
+  const uint32_t side = 260;
+  for (uint32_t y = 0; y < side; y++) {
+    for (uint32_t x = 0; x < side; x++) {
+      prim.positions.insert(prim.positions.end(), {x * 0.25f, y * 0.5f, 0.01f * static_cast<float>((x * 7 + y * 3) % 11)});
+    }
+  }
+  for (uint32_t y = 0; y + 1 < side; y++) {
+    for (uint32_t x = 0; x + 1 < side; x++) {
+      const uint32_t a = y * side + x;
+      prim.indices.insert(prim.indices.end(), {a, a + 1, a + side, a + 1, a + side + 1, a + side});
+    }
+  }
+  grid.primitives.push_back(std::move(prim));
+  scene.meshes.push_back(std::move(grid));
+
+  // 이동 matrix를 가진 부모(mesh 0) 아래 자식(mesh 1). 양자화 시 부모 mesh는 새 자식 node로 옮겨짐
+  GltfNode root;
+  root.name = "root";
+  root.mesh = 0;
+  root.has_matrix = true;
+  root.matrix[12] = 10.0;
+  root.matrix[13] = -4.0;
+  root.matrix[14] = 2.5;
+  root.children.push_back(1);
+  scene.nodes.push_back(root);
+  GltfNode child;
+  child.name = "child";
+  child.mesh = 1;
+  child.has_matrix = true;
+  child.matrix[12] = -300.0;
+  scene.nodes.push_back(child);
+  scene.roots.push_back(0);
+  return scene;
+}
+
+size_t ComponentSize(int component_type) {
+  switch (component_type) {
+    case 5120:  // BYTE
+    case 5121:  // UNSIGNED_BYTE
+      return 1;
+    case 5122:  // SHORT
+    case 5123:  // UNSIGNED_SHORT
+      return 2;
+    case 5125:  // UNSIGNED_INT
+    case 5126:  // FLOAT
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+size_t ComponentCount(const std::string& type) {
+  if (type == "SCALAR") return 1;
+  if (type == "VEC2") return 2;
+  if (type == "VEC3") return 3;
+  if (type == "VEC4") return 4;
+  if (type == "MAT4") return 16;
+  return 0;
+}
+
+// glTF 규칙대로 component 하나를 읽음 (normalized면 [-1, 1] / [0, 1])
+double ReadComponent(const uint8_t* p, int component_type, bool normalized) {
+  switch (component_type) {
+    case 5120: {
+      const int8_t v = static_cast<int8_t>(p[0]);
+      return normalized ? std::max(v / 127.0, -1.0) : v;
+    }
+    case 5121:
+      return normalized ? p[0] / 255.0 : p[0];
+    case 5122: {
+      int16_t v;
+      std::memcpy(&v, p, sizeof(v));
+      return normalized ? std::max(v / 32767.0, -1.0) : v;
+    }
+    case 5123: {
+      uint16_t v;
+      std::memcpy(&v, p, sizeof(v));
+      return normalized ? v / 65535.0 : v;
+    }
+    case 5125:
+      return test::ReadU32(p);
+    case 5126: {
+      float v;
+      std::memcpy(&v, p, sizeof(v));
+      return v;
+    }
+    default:
+      return 0.0;
+  }
+}
+
+// 구조 검사를 통과한 accessor를 component 단위로 읽음
+bool ReadAccessor(const test::Json& json, const test::GlbFile& glb, size_t index, std::vector<double>* values) {
+  const test::Json& a = json["accessors"][index];
+  const test::Json& view = json["bufferViews"][a["bufferView"].as_size()];
+  const int component_type = static_cast<int>(a["componentType"].number());
+  const size_t components = ComponentCount(a["type"].string());
+  const size_t element = ComponentSize(component_type) * components;
+  const size_t stride = view.has("byteStride") ? view["byteStride"].as_size() : element;
+  const size_t start = view["byteOffset"].as_size() + a["byteOffset"].as_size();
+  const size_t count = a["count"].as_size();
+  if (element == 0 || (count > 0 && start + stride * (count - 1) + element > glb.bin_length())) return false;
+  values->resize(count * components);
+  for (size_t i = 0; i < count; i++) {
+    for (size_t c = 0; c < components; c++) {
+      const uint8_t* p = glb.bin() + start + i * stride + c * ComponentSize(component_type);
+      (*values)[i * components + c] = ReadComponent(p, component_type, a["normalized"].boolean());
+    }
+  }
+  return true;
+}
+
+// 헤더, 청크, bufferView/accessor 범위, min/max
+bool CheckStructure(const test::GlbFile& glb, const test::Json& json) {
+  CHECK(glb.magic == kGlbMagic);
+  CHECK(glb.version == 2);
+  CHECK(glb.length == glb.bytes.size());
+  CHECK(glb.bytes.size() % 4 == 0);
+  CHECK(!glb.truncated);
+  if (!CHECK(glb.chunks.size() == 2)) return false;
+  CHECK(glb.chunks[0].type == kChunkJson);
+  CHECK(glb.chunks[1].type == kChunkBin);
+  for (const test::GlbChunk& c : glb.chunks) {
+    CHECK(c.length % 4 == 0);
+    CHECK(c.offset % 4 == 0);
+  }
+  CHECK(glb.chunks[1].offset + glb.chunks[1].length == glb.bytes.size());
+
+  // BIN 청크는 buffer 0 뒤에 패딩 3바이트까지만 허용
+  if (!CHECK(json["buffers"].size() == 1)) return false;
+  const test::Json& buffer = json["buffers"][0];
+  CHECK(!buffer.has("uri"));
+  const size_t buffer_length = buffer["byteLength"].as_size();
+  CHECK(buffer_length <= glb.bin_length() && glb.bin_length() - buffer_length < 4);
+
+  const test::Json& views = json["bufferViews"];
+  for (size_t i = 0; i < views.size(); i++) {
+    const test::Json& v = views[i];
+    const size_t offset = v["byteOffset"].as_size();
+    const size_t length = v["byteLength"].as_size();
+    CHECK(v["buffer"].as_size() == 0);
+    if (!CHECK(offset + length <= buffer_length)) std::fprintf(stderr, "  bufferView %zu past BIN chunk\n", i);
+    CHECK(offset % 4 == 0);
+    if (v.has("byteStride")) {
+      CHECK(v["byteStride"].as_size() % 4 == 0 && v["byteStride"].as_size() >= 4);
+    }
+  }
+
+  const test::Json& accessors = json["accessors"];
+  bool ok = true;
+  for (size_t i = 0; i < accessors.size(); i++) {
+    const test::Json& a = accessors[i];
+    const int component_type = static_cast<int>(a["componentType"].number());
+    const size_t component = ComponentSize(component_type);
+    const size_t components = ComponentCount(a["type"].string());
+    const size_t view_index = a["bufferView"].as_size();
+    if (!CHECK(component > 0 && components > 0 && a.has("bufferView") && view_index < views.size())) {
+      ok = false;
+      continue;
+    }
+    const test::Json& v = views[view_index];
+    const size_t element = component * components;
+    const size_t stride = v.has("byteStride") ? v["byteStride"].as_size() : element;
+    const size_t offset = a["byteOffset"].as_size();
+    const size_t count = a["count"].as_size();
+    CHECK(stride >= element);
+    CHECK((v["byteOffset"].as_size() + offset) % component == 0);
+    if (!CHECK(count > 0 && offset + stride * (count - 1) + element <= v["byteLength"].as_size())) {
+      std::fprintf(stderr, "  accessor %zu past its bufferView\n", i);
+      ok = false;
+      continue;
+    }
+
+    if (!a.has("min") && !a.has("max")) continue;
+    std::vector<double> values;
+    if (!CHECK(ReadAccessor(json, glb, i, &values))) continue;
+    if (!CHECK(a["min"].size() == components && a["max"].size() == components)) continue;
+    for (size_t c = 0; c < components; c++) {
+      double lo = DBL_MAX;
+      double hi = -DBL_MAX;
+      for (size_t k = c; k < values.size(); k += components) {
+        lo = std::min(lo, values[k]);
+        hi = std::max(hi, values[k]);
+      }
+      // JSON은 float를 %.9g로 쓰므로 float로 되돌리면 정확히 같아야 함
+      const bool same = static_cast<float>(a["min"][c].number()) == static_cast<float>(lo) &&
+                        static_cast<float>(a["max"][c].number()) == static_cast<float>(hi);
+      if (!CHECK(same)) {
+        std::fprintf(stderr, "  accessor %zu component %zu: min/max %g/%g, data %g/%g\n", i, c,
+                     a["min"][c].number(), a["max"][c].number(), lo, hi);
+      }
+    }
+  }
+  return ok;
+}
+
+void Multiply(const double a[16], const double b[16], double out[16]) {
+  for (int col = 0; col < 4; col++) {
+    for (int row = 0; row < 4; row++) {
+      double sum = 0.0;
+      for (int k = 0; k < 4; k++) sum += a[k * 4 + row] * b[col * 4 + k];
+      out[col * 4 + row] = sum;
+    }
+  }
+}
+
+void TransformPoint(const double m[16], const double p[3], double out[3]) {
+  for (int r = 0; r < 3; r++) out[r] = m[r] * p[0] + m[4 + r] * p[1] + m[8 + r] * p[2] + m[12 + r];
+}
+
+struct MeshWorld {
+  double matrix[16];
+};
+
+// 입력 scene: mesh 이름 → world matrix
+void CollectInput(const GltfScene& scene, int node, const double parent[16], std::map<std::string, MeshWorld>* out) {
+  const GltfNode& n = scene.nodes[node];
+  MeshWorld w;
+  Multiply(parent, n.matrix, w.matrix);
+  if (n.mesh >= 0) (*out)[scene.meshes[n.mesh].name] = w;
+  for (int c : n.children) CollectInput(scene, c, w.matrix, out);
+}
+
+// GLB: mesh 이름 → world matrix (node matrix만 씀. 이 scene에는 TRS/인스턴싱이 없음)
+void CollectOutput(const test::Json& json, size_t node, const double parent[16], std::map<std::string, MeshWorld>* out) {
+  const test::Json& n = json["nodes"][node];
+  double local[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+  if (n.has("matrix")) {
+    for (size_t k = 0; k < 16; k++) local[k] = n["matrix"][k].number();
+  }
+  CHECK(!n.has("translation") && !n.has("rotation") && !n.has("scale"));
+  MeshWorld w;
+  Multiply(parent, local, w.matrix);
+  if (n.has("mesh")) (*out)[json["meshes"][n["mesh"].as_size()]["name"].string()] = w;
+  const test::Json& children = n["children"];
+  for (size_t c = 0; c < children.size(); c++) CollectOutput(json, children[c].as_size(), w.matrix, out);
+}
+
+void TestWriteGlb(bool quantize) {
+  const std::filesystem::path dir = test::ScratchDir(quantize ? "glb_writer_test_q" : "glb_writer_test");
+  const std::filesystem::path path = dir / "model.glb";
+  GlbWriteOptions options;
+  options.quantize = quantize;
+  GlbWriteStats stats;
+  std::string error;
+  const GltfScene scene = MakeScene();
+  if (!CHECK(WriteGlb(scene, path, options, &stats, &error))) {
+    std::fprintf(stderr, "  WriteGlb: %s\n", error.c_str());
+    return;
+  }
+  test::GlbFile glb;
+  if (!CHECK(test::ReadGlb(path, &glb))) return;
+  CHECK(stats.file_bytes == glb.bytes.size());
+  test::Json json;
+  if (!CHECK(test::Json::Parse(glb.json(), &json))) return;
+  if (!CheckStructure(glb, json)) return;
+
+  const double identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+  std::map<std::string, MeshWorld> input_world;
+  for (int r : scene.roots) CollectInput(scene, r, identity, &input_world);
+  std::map<std::string, MeshWorld> output_world;
+  const test::Json& roots = json["scenes"][json["scene"].as_size()]["nodes"];
+  for (size_t r = 0; r < roots.size(); r++) CollectOutput(json, roots[r].as_size(), identity, &output_world);
+  if (!CHECK(output_world.size() == scene.meshes.size())) return;
+
+  // 실제 복원 오차 (보고값과 비교)
+  double position_error = 0.0;
+  double normal_error = 0.0;
+  double texcoord_error = 0.0;
+  double extent = 1.0;
+  const test::Json& meshes = json["meshes"];
+  for (size_t m = 0; m < meshes.size(); m++) {
+    const std::string name = meshes[m]["name"].string();
+    const GltfMesh* source = nullptr;
+    for (const GltfMesh& mesh : scene.meshes) {
+      if (mesh.name == name) source = &mesh;
+    }
+    if (!CHECK(source != nullptr && output_world.count(name) && input_world.count(name))) continue;
+    const test::Json& primitives = meshes[m]["primitives"];
+    if (!CHECK(primitives.size() == source->primitives.size())) continue;
+    for (size_t p = 0; p < primitives.size(); p++) {
+      const GltfPrimitive& prim = source->primitives[p];
+      const test::Json& attributes = primitives[p]["attributes"];
+      const size_t count = prim.vertex_count();
+      CHECK(static_cast<int>(primitives[p]["material"].number()) == prim.material);
+
+      std::vector<double> indices;
+      if (CHECK(ReadAccessor(json, glb, primitives[p]["indices"].as_size(), &indices))) {
+        const int expected_type = count <= kMaxShortIndexVertices ? 5123 : 5125;
+        CHECK(static_cast<int>(json["accessors"][primitives[p]["indices"].as_size()]["componentType"].number()) ==
+              expected_type);
+        bool same = indices.size() == prim.indices.size();
+        for (size_t i = 0; same && i < indices.size(); i++) same = indices[i] == prim.indices[i];
+        CHECK(same);
+      }
+
+      std::vector<double> positions;
+      if (!CHECK(ReadAccessor(json, glb, attributes["POSITION"].as_size(), &positions))) continue;
+      if (!CHECK(positions.size() == count * 3)) continue;
+      const MeshWorld& in = input_world[name];
+      const MeshWorld& out = output_world[name];
+      for (size_t v = 0; v < count; v++) {
+        const double src[3] = {prim.positions[v * 3], prim.positions[v * 3 + 1], prim.positions[v * 3 + 2]};
+        double expected[3];
+        double decoded[3];
+        TransformPoint(in.matrix, src, expected);
+        TransformPoint(out.matrix, &positions[v * 3], decoded);
+        for (int c = 0; c < 3; c++) {
+          position_error = std::max(position_error, std::fabs(decoded[c] - expected[c]));
+          extent = std::max(extent, std::fabs(expected[c]));
+        }
+        // float 경로는 node를 바꾸지 않으므로 값이 그대로
+        if (!quantize) CHECK(positions[v * 3] == src[0] && positions[v * 3 + 1] == src[1] && positions[v * 3 + 2] == src[2]);
+      }
+
+      if (prim.normals.size() == prim.positions.size()) {
+        std::vector<double> normals;
+        if (CHECK(attributes.has("NORMAL") && ReadAccessor(json, glb, attributes["NORMAL"].as_size(), &normals)) &&
+            CHECK(normals.size() == count * 3)) {
+          for (size_t v = 0; v < count; v++) {
+            const double src[3] = {prim.normals[v * 3], prim.normals[v * 3 + 1], prim.normals[v * 3 + 2]};
+            normal_error = std::max(normal_error, test::AngleDegrees(src, &normals[v * 3]));
+          }
+        }
+      } else {
+        CHECK(!attributes.has("NORMAL"));
+      }
+
+      const int image = scene.materials[prim.material].image;
+      if (quantize && image < 0) {
+        // 텍스처 없는 material의 uv는 양자화 경로에서 생략
+        CHECK(!attributes.has("TEXCOORD_0"));
+      } else if (prim.texcoords.size() / 2 == count && count > 0) {
+        std::vector<double> texcoords;
+        if (!CHECK(attributes.has("TEXCOORD_0") &&
+                   ReadAccessor(json, glb, attributes["TEXCOORD_0"].as_size(), &texcoords)) ||
+            !CHECK(texcoords.size() == count * 2)) {
+          continue;
+        }
+        double scale[2] = {1.0, 1.0};
+        const test::Json& transform =
+            json["materials"][prim.material]["pbrMetallicRoughness"]["baseColorTexture"]["extensions"]
+                ["KHR_texture_transform"];
+        CHECK(quantize != transform.is_null());
+        if (!transform.is_null()) {
+          scale[0] = transform["scale"][0].number();
+          scale[1] = transform["scale"][1].number();
+          CHECK(!transform.has("offset") && !transform.has("rotation"));
+        }
+        for (size_t k = 0; k < texcoords.size(); k++) {
+          texcoord_error = std::max(texcoord_error, std::fabs(texcoords[k] * scale[k % 2] - prim.texcoords[k]));
+        }
+      }
+    }
+  }
+
+  if (!quantize) {
+    // 같은 방향이어도 acos 반올림으로 각도가 0이 아닐 수 있음
+    CHECK(position_error == 0.0 && normal_error < 1e-4 && texcoord_error == 0.0);
+    return;
+  }
+  // matrix/scale이 %.9g로 기록되므로 그만큼의 반올림 여유
+  const double slack = extent * 1e-8;
+  CHECK(stats.position_error > 0.0 && stats.normal_error_degrees > 0.0 && stats.texcoord_error > 0.0);
+  if (!CHECK(position_error <= stats.position_error + slack)) {
+    std::fprintf(stderr, "  position error %g > reported %g\n", position_error, stats.position_error);
+  }
+  if (!CHECK(normal_error <= stats.normal_error_degrees + 1e-6)) {
+    std::fprintf(stderr, "  normal error %g > reported %g degrees\n", normal_error, stats.normal_error_degrees);
+  }
+  if (!CHECK(texcoord_error <= stats.texcoord_error + 1e-7)) {
+    std::fprintf(stderr, "  texcoord error %g > reported %g\n", texcoord_error, stats.texcoord_error);
+  }
+  CHECK(stats.quantized_vertex_bytes > 0 && stats.quantized_vertex_bytes < stats.float_vertex_bytes);
+}
+
+}  // namespace
+
+int main() {
+  TestWriteGlb(false);
+  TestWriteGlb(true);
+  return test::Finish("glb_writer_test");
+}
@@ -0,0 +1,193 @@
+// 텍스처 축소 검사 (TextureTargetSize / ResampleImage).
+// - 밀도 기준 목표 크기가 밀도를 지키는 가장 작은 2의 거듭제곱(원본 이하)인지, max_size(--max-texture-size)로
+//   긴 변이 제한되는지
+// - 단색 이미지는 어떤 크기로 줄여도 같은 색인지
+// - 검정/흰색 체커보드를 줄이면 sRGB 공간 평균(128)이 아니라 선형 평균(약 188)이 되는지, 알파 가중인지
+// - 텍스처 중복 제거(HashPixels / PixelContentIndex): 같은 픽셀만 같은 것으로 찾고, 해시가 충돌해도 합치지 않는지
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "image_resample.h"
+#include "test_support.h"
+
+namespace {
+
+bool IsPowerOfTwo(size_t v) { return v > 0 && (v & (v - 1)) == 0; }
+
+// 배율 s가 되도록 max_area_ratio를 정함 (texels_per_unit = 1)
+double RatioForScale(size_t width, size_t height, double s) {
+  return s * s * static_cast<double>(width) * height;
+}
+
+void TestTargetSize() {
+  size_t w = 0;
+  size_t h = 0;
+  // 밀도/상한 없음 → 원본 그대로 (2의 거듭제곱이 아니어도)
+  TextureTargetSize(1000, 600, 4.0, 0.0, 0, &w, &h);
+  CHECK(w == 1000 && h == 600);
+  // 배율 0.3: 307.2 → 512
+  TextureTargetSize(1024, 1024, RatioForScale(1024, 1024, 0.3), 1.0, 0, &w, &h);
+  CHECK(w == 512 && h == 512);
+  // 축마다 따로 올림: 200 → 256, 50 → 64
+  TextureTargetSize(2000, 500, RatioForScale(2000, 500, 0.1), 1.0, 0, &w, &h);
+  CHECK(w == 256 && h == 64);
+  // 2의 거듭제곱이 원본보다 크면 원본 크기 (확대하지 않음)
+  TextureTargetSize(1000, 600, RatioForScale(1000, 600, 0.9), 1.0, 0, &w, &h);
+  CHECK(w == 1000 && h == 600);
+  // 이미 밀도보다 작으면 그대로
+  TextureTargetSize(256, 128, RatioForScale(256, 128, 3.0), 1.0, 0, &w, &h);
+  CHECK(w == 256 && h == 128);
+
+  // max_size: 긴 변을 제한하고 비율 유지
+  TextureTargetSize(4096, 2048, 1.0, 0.0, 1024, &w, &h);
+  CHECK(w == 1024 && h == 512);
+  TextureTargetSize(1000, 600, 1.0, 0.0, 500, &w, &h);
+  CHECK(w == 500 && h == 300);
+  TextureTargetSize(3000, 2, 1.0, 0.0, 1024, &w, &h);
+  CHECK(w == 1024 && h == 1);
+  // 밀도로 512가 된 뒤 상한 256
+  TextureTargetSize(1024, 1024, RatioForScale(1024, 1024, 0.3), 1.0, 256, &w, &h);
+  CHECK(w == 256 && h == 256);
+  // 상한보다 작으면 상한은 영향 없음
+  TextureTargetSize(300, 200, 1.0, 0.0, 1024, &w, &h);
+  CHECK(w == 300 && h == 200);
+
+  // 임의 크기/배율: 결과는 원본 이하, 줄였으면 필요한 텍셀 수 이상인 가장 작은 2의 거듭제곱
+  std::mt19937 rng(11);
+  for (int i = 0; i < 2000; i++) {
+    const size_t sw = 1 + rng() % 5000;
+    const size_t sh = 1 + rng() % 5000;
+    const double s = std::ldexp(1.0 + (rng() % 1000) / 1000.0, -static_cast<int>(rng() % 10));
+    const size_t cap = rng() % 3 == 0 ? (1 + rng() % 4096) : 0;
+    TextureTargetSize(sw, sh, RatioForScale(sw, sh, s), 1.0, cap, &w, &h);
+    if (!CHECK(w >= 1 && h >= 1 && w <= sw && h <= sh)) continue;
+    if (cap > 0) {
+      CHECK(std::max(w, h) <= cap);
+      continue;
+    }
+    const bool ok_w = w == sw || (IsPowerOfTwo(w) && w >= sw * s - 1e-6 && (w == 1 || w < 2 * sw * s + 1e-6));
+    const bool ok_h = h == sh || (IsPowerOfTwo(h) && h >= sh * s - 1e-6 && (h == 1 || h < 2 * sh * s + 1e-6));
+    if (!CHECK(ok_w && ok_h)) std::fprintf(stderr, "  %zux%zu scale %g -> %zux%zu\n", sw, sh, s, w, h);
+  }
+}
+
+RgbaImage Solid(size_t width, size_t height, const uint8_t rgba[4]) {
+  RgbaImage img;
+  img.width = width;
+  img.height = height;
+  img.pixels.resize(width * height * 4);
+  for (size_t i = 0; i < width * height; i++) std::copy(rgba, rgba + 4, &img.pixels[i * 4]);
+  return img;
+}
+
+void TestConstantColor() {
+  const uint8_t colors[][4] = {{0, 0, 0, 255}, {255, 255, 255, 255}, {200, 117, 31, 255}, {1, 128, 254, 128},
+                               {90, 60, 30, 1}};
+  const size_t sizes[][2] = {{37, 23}, {64, 64}, {5, 300}, {1, 1}};
+  const size_t targets[][2] = {{8, 5}, {16, 16}, {1, 1}, {3, 7}, {32, 32}};
+  for (const auto& color : colors) {
+    for (const auto& size : sizes) {
+      const RgbaImage src = Solid(size[0], size[1], color);
+      for (const auto& target : targets) {
+        const RgbaImage dst = ResampleImage(src, target[0], target[1]);
+        if (!CHECK(dst.width == target[0] && dst.height == target[1] &&
+                   dst.pixels.size() == target[0] * target[1] * 4)) {
+          continue;
+        }
+        size_t mismatched = 0;
+        for (size_t i = 0; i < target[0] * target[1]; i++) {
+          if (!std::equal(color, color + 4, &dst.pixels[i * 4])) mismatched++;
+        }
+        if (!CHECK(mismatched == 0)) {
+          std::fprintf(stderr, "  color %d,%d,%d,%d %zux%zu -> %zux%zu: %zu pixels differ\n", color[0], color[1],
+                       color[2], color[3], size[0], size[1], target[0], target[1], mismatched);
+        }
+      }
+    }
+  }
+}
+
+void TestCheckerboard() {
+  // 1픽셀 체커보드: 2x2 블록마다 검정 2개, 흰색 2개 → 선형 0.5 → sRGB 약 187.5
+  RgbaImage src;
+  src.width = 64;
+  src.height = 64;
+  src.pixels.resize(64 * 64 * 4);
+  for (size_t y = 0; y < 64; y++) {
+    for (size_t x = 0; x < 64; x++) {
+      const uint8_t v = (x + y) % 2 ? 255 : 0;
+      uint8_t* p = &src.pixels[(y * 64 + x) * 4];
+      p[0] = p[1] = p[2] = v;
+      p[3] = 255;
+    }
+  }
+  const size_t targets[] = {32, 16, 1};
+  for (size_t t : targets) {
+    const RgbaImage dst = ResampleImage(src, t, t);
+    int lo = 255;
+    int hi = 0;
+    for (size_t i = 0; i < t * t; i++) {
+      for (int c = 0; c < 3; c++) {
+        lo = std::min<int>(lo, dst.pixels[i * 4 + c]);
+        hi = std::max<int>(hi, dst.pixels[i * 4 + c]);
+      }
+      CHECK(dst.pixels[i * 4 + 3] == 255);
+    }
+    if (!CHECK(lo >= 187 && hi <= 189)) std::fprintf(stderr, "  checkerboard -> %zu: %d..%d\n", t, lo, hi);
+  }
+
+  // 알파 가중: 투명한 빨강과 불투명한 파랑을 섞으면 색은 파랑, 알파는 절반
+  RgbaImage mixed;
+  mixed.width = 2;
+  mixed.height = 2;
+  mixed.pixels = {255, 0, 0, 0, 0, 0, 255, 255, 0, 0, 255, 255, 255, 0, 0, 0};
+  const RgbaImage one = ResampleImage(mixed, 1, 1);
+  CHECK(one.pixels[0] == 0 && one.pixels[1] == 0 && one.pixels[2] == 255);
+  CHECK(one.pixels[3] == 128);
+}
+
+void TestContentIndex() {
+  const uint8_t red[4] = {255, 0, 0, 255};
+  const RgbaImage a = Solid(4, 4, red);
+  RgbaImage b = a;  // 한 픽셀만 다름
+  b.pixels[21] = 1;
+  RgbaImage c = a;  // 같은 바이트, 다른 크기
+  c.width = 8;
+  c.height = 2;
+  auto hash = [](const RgbaImage& img) { return HashPixels(img.width, img.height, img.pixels.data(), img.pixels.size()); };
+  CHECK(hash(a) == hash(Solid(4, 4, red)));
+  CHECK(hash(a) != hash(b));
+  CHECK(hash(a) != hash(c));
+  CHECK(SamePixels(a, Solid(4, 4, red)));
+  CHECK(!SamePixels(a, b));
+  CHECK(!SamePixels(a, c));
+
+  PixelContentIndex index;
+  size_t value = 99;
+  CHECK(!index.find(hash(a), a, &value));
+  index.add(hash(a), std::make_shared<RgbaImage>(a), 0);
+  CHECK(index.find(hash(a), Solid(4, 4, red), &value) && value == 0);
+  // 해시가 충돌한 다른 이미지(b, c)는 찾지 못하고, 따로 등록하면 각자의 값
+  CHECK(!index.find(hash(a), b, &value));
+  CHECK(!index.find(hash(a), c, &value));
+  index.add(hash(a), std::make_shared<RgbaImage>(b), 1);
+  CHECK(index.find(hash(a), b, &value) && value == 1);
+  CHECK(index.find(hash(a), a, &value) && value == 0);
+  CHECK(!index.find(hash(c), c, &value));
+}
+
+}  // namespace
+
+int main() {
+  TestTargetSize();
+  TestConstantColor();
+  TestCheckerboard();
+  TestContentIndex();
+  return test::Finish("image_resample_test");
+}
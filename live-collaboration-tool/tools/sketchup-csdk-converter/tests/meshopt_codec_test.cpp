@@ -0,0 +1,327 @@
+// EXT_meshopt_compression 왕복 검사.
+// 확장 명세대로 따로 작성한 디코더(정점 코덱 v0, 인덱스 시퀀스 v1, OCTAHEDRAL 필터)로
+// - EncodeMeshoptAttributes / EncodeMeshoptIndices 출력을 직접 디코딩해 입력과 바이트 단위로 비교하고,
+// - WriteGlb(--meshopt, --quantize)가 쓴 GLB BIN의 압축본을 디코딩해 fallback 버퍼(<stem>.fallback.bin)와 비교합니다.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glb_writer.h"
+#include "gltf_scene.h"
+#include "meshopt_codec.h"
+#include "test_support.h"
+
+namespace {
+
+// ---- 명세의 디코더 ----
+
+uint8_t UnZigZag8(uint8_t v) { return static_cast<uint8_t>((v >> 1) ^ static_cast<uint8_t>(-(v & 1))); }
+
+// ATTRIBUTES (헤더 0xa0). 블록 = 바이트 열마다 [그룹 헤더 2비트씩][그룹 데이터], 끝에 tail(기준값 포함 최소 32바이트)
+bool DecodeVertexBuffer(const uint8_t* data, size_t size, size_t count, size_t stride, std::vector<uint8_t>* out) {
+  const size_t tail = std::max<size_t>(stride, 32);
+  if (size < 1 + tail || data[0] != 0xa0) return false;
+  const uint8_t* baseline = data + size - stride;
+  const uint8_t* end = data + size - tail;
+  const uint8_t* p = data + 1;
+  out->assign(count * stride, 0);
+
+  const size_t block = std::min<size_t>((8192 / stride) & ~size_t{15}, 256);
+  std::vector<uint8_t> last(baseline, baseline + stride);
+  std::vector<uint8_t> deltas(block);
+  for (size_t begin = 0; begin < count; begin += block) {
+    const size_t n = std::min(block, count - begin);
+    const size_t groups = (n + 15) / 16;
+    for (size_t k = 0; k < stride; k++) {
+      const uint8_t* header = p;
+      p += (groups + 3) / 4;
+      if (p > end) return false;
+      for (size_t g = 0; g < groups; g++) {
+        const int mode = (header[g / 4] >> ((g % 4) * 2)) & 3;
+        uint8_t* d = &deltas[g * 16];
+        if (mode == 0) {
+          std::fill(d, d + 16, 0);
+        } else if (mode == 3) {
+          if (p + 16 > end) return false;
+          std::memcpy(d, p, 16);
+          p += 16;
+        } else {
+          const int bits = mode == 1 ? 2 : 4;
+          const uint8_t sentinel = static_cast<uint8_t>((1 << bits) - 1);
+          const size_t packed = 16 * bits / 8;
+          if (p + packed > end) return false;
+          const uint8_t* extra = p + packed;
+          for (size_t i = 0; i < 16; i++) {
+            // MSB부터
+            const size_t bit = i * bits;
+            const uint8_t v = static_cast<uint8_t>((p[bit / 8] >> (8 - bits - bit % 8)) & sentinel);
+            if (v == sentinel) {
+              if (extra >= end) return false;
+              d[i] = *extra++;
+            } else {
+              d[i] = v;
+            }
+          }
+          p = extra;
+        }
+      }
+      uint8_t prev = last[k];
+      for (size_t i = 0; i < n; i++) {
+        prev = static_cast<uint8_t>(prev + UnZigZag8(deltas[i]));
+        (*out)[(begin + i) * stride + k] = prev;
+      }
+      last[k] = prev;
+    }
+  }
+  // 블록 뒤에 남은 바이트가 정확히 tail이어야 함
+  return p == end;
+}
+
+// INDICES (헤더 0xd1). varint마다 (zigzag delta << 1) | 기준값 번호, 끝에 4바이트 tail
+bool DecodeIndexSequence(const uint8_t* data, size_t size, size_t count, size_t stride, std::vector<uint8_t>* out) {
+  if (size < 1 + 4 || data[0] != 0xd1) return false;
+  const uint8_t* p = data + 1;
+  const uint8_t* end = data + size - 4;
+  uint32_t last[2] = {0, 0};
+  out->assign(count * stride, 0);
+  for (size_t i = 0; i < count; i++) {
+    uint32_t v = 0;
+    for (int shift = 0;; shift += 7) {
+      if (p >= end || shift > 28) return false;
+      const uint8_t byte = *p++;
+      v |= static_cast<uint32_t>(byte & 127) << shift;
+      if (!(byte & 128)) break;
+    }
+    const uint32_t current = v & 1;
+    const uint32_t d = v >> 1;
+    const uint32_t delta = (d >> 1) ^ (0u - (d & 1));
+    const uint32_t index = last[current] + delta;
+    last[current] = index;
+    if (stride == 2 && index > 0xFFFF) return false;
+    for (size_t b = 0; b < stride; b++) (*out)[i * stride + b] = static_cast<uint8_t>(index >> (8 * b));
+  }
+  return p == end;
+}
+
+// OCTAHEDRAL 필터 (8비트, stride 4): (u, v, 1.0 스케일, w) → 정규화 (x, y, z, w)
+void OctahedralFilter(std::vector<uint8_t>* data) {
+  for (size_t i = 0; i + 3 < data->size(); i += 4) {
+    int8_t* e = reinterpret_cast<int8_t*>(&(*data)[i]);
+    const float one = e[2];
+    float x = e[0];
+    float y = e[1];
+    const float z = one - std::fabs(x) - std::fabs(y);
+    const float t = std::max(-z, 0.0f);
+    x -= x >= 0.0f ? t : -t;
+    y -= y >= 0.0f ? t : -t;
+    const float l = std::sqrt(x * x + y * y + z * z);
+    const float s = 127.0f / l;
+    e[0] = static_cast<int8_t>(std::lround(x * s));
+    e[1] = static_cast<int8_t>(std::lround(y * s));
+    e[2] = static_cast<int8_t>(std::lround(z * s));
+  }
+}
+
+// ---- 코덱 직접 왕복 ----
+
+void CheckAttributesRoundTrip(const std::vector<uint8_t>& data, size_t stride) {
+  const size_t count = data.size() / stride;
+  const std::vector<uint8_t> enc = EncodeMeshoptAttributes(data.data(), count, stride);
+  std::vector<uint8_t> dec;
+  const bool ok = CHECK(DecodeVertexBuffer(enc.data(), enc.size(), count, stride, &dec));
+  if (ok && !CHECK(dec == data)) std::fprintf(stderr, "  attributes stride=%zu count=%zu\n", stride, count);
+}
+
+void CheckIndicesRoundTrip(const std::vector<uint32_t>& indices, size_t stride) {
+  std::vector<uint8_t> raw(indices.size() * stride);
+  for (size_t i = 0; i < indices.size(); i++) {
+    for (size_t b = 0; b < stride; b++) raw[i * stride + b] = static_cast<uint8_t>(indices[i] >> (8 * b));
+  }
+  const std::vector<uint8_t> enc = EncodeMeshoptIndices(raw.data(), indices.size(), stride);
+  std::vector<uint8_t> dec;
+  const bool ok = CHECK(DecodeIndexSequence(enc.data(), enc.size(), indices.size(), stride, &dec));
+  if (ok && !CHECK(dec == raw)) std::fprintf(stderr, "  indices stride=%zu count=%zu\n", stride, indices.size());
+}
+
+void TestCodec() {
+  std::mt19937 rng(12345);
+  // 블록/그룹 경계(16, 256)와 모든 그룹 모드(0/2/4/8비트)가 나오도록 크기와 값 분포를 섞음
+  const size_t counts[] = {0, 1, 15, 16, 17, 255, 256, 257, 1000, 4099};
+  const size_t strides[] = {4, 8, 12, 16, 20, 32, 64, 256};
+  for (size_t stride : strides) {
+    for (size_t count : counts) {
+      std::vector<uint8_t> smooth(count * stride);
+      std::vector<uint8_t> noisy(count * stride);
+      for (size_t i = 0; i < count; i++) {
+        for (size_t k = 0; k < stride; k++) {
+          smooth[i * stride + k] = static_cast<uint8_t>(k * 7 + (k % 3 == 0 ? i / 5 : k % 3 == 1 ? i * 3 : 0));
+          noisy[i * stride + k] = static_cast<uint8_t>(rng());
+        }
+      }
+      CheckAttributesRoundTrip(smooth, stride);
+      CheckAttributesRoundTrip(noisy, stride);
+    }
+  }
+
+  for (size_t stride : {size_t{2}, size_t{4}}) {
+    // v1은 (zigzag delta << 1) | 기준값 번호를 32비트로 쓰므로 |delta| < 2^30만 표현됨 (참조 인코더도 같음).
+    // 정점 수가 그보다 훨씬 작아 실제 인덱스에는 영향이 없음
+    const uint32_t limit = stride == 2 ? 0xFFFE : (1u << 30) - 1;
+    std::vector<uint32_t> grid;  // 격자 삼각형 목록 (작은 delta)
+    for (uint32_t y = 0; y < 40; y++) {
+      for (uint32_t x = 0; x < 40; x++) {
+        const uint32_t a = y * 41 + x;
+        grid.insert(grid.end(), {a, a + 1, a + 41, a + 1, a + 42, a + 41});
+      }
+    }
+    CheckIndicesRoundTrip(grid, stride);
+    std::vector<uint32_t> jumps;  // 두 기준값 사이를 오가는 큰 delta와 범위 끝 값
+    for (int i = 0; i < 3000; i++) jumps.push_back(static_cast<uint32_t>(rng() % (limit + 1ull)));
+    jumps.insert(jumps.end(), {0, limit, 0, limit, 1, limit - 1});
+    CheckIndicesRoundTrip(jumps, stride);
+    CheckIndicesRoundTrip({}, stride);
+  }
+}
+
+// ---- GLB: 압축본 → fallback 버퍼 ----
+
+// test::SphereScene의 구 mesh를 node 하나와 인스턴스 node 하나로 씀
+GltfScene MakeScene() {
+  GltfScene scene = test::SphereScene();
+  GltfNode node;
+  node.name = "root";
+  node.mesh = 0;
+  scene.nodes.push_back(node);
+  scene.roots.push_back(0);
+  // 같은 mesh를 EXT_mesh_gpu_instancing으로 세 번 (TRS bufferView는 target이 없어 byteStride를 쓰지 않음)
+  GltfNode instanced;
+  instanced.name = "instanced";
+  instanced.mesh = 0;
+  for (int i = 0; i < 3; i++) {
+    GltfInstance inst;
+    inst.translation[0] = 300.0f * i;
+    inst.rotation[2] = std::sin(0.3f * i);
+    inst.rotation[3] = std::cos(0.3f * i);
+    inst.scale[1] = 1.0f + i;
+    instanced.instances.push_back(inst);
+  }
+  scene.nodes.push_back(instanced);
+  scene.roots.push_back(1);
+  return scene;
+}
+
+void TestGlbFallback(bool quantize) {
+  const std::filesystem::path dir = test::ScratchDir(quantize ? "meshopt_codec_test_q" : "meshopt_codec_test");
+  const std::filesystem::path path = dir / "model.glb";
+  GlbWriteOptions options;
+  options.meshopt_compression = true;
+  options.quantize = quantize;
+  GlbWriteStats stats;
+  std::string error;
+  const GltfScene scene = MakeScene();
+  if (!CHECK(WriteGlb(scene, path, options, &stats, &error))) {
+    std::fprintf(stderr, "  WriteGlb: %s\n", error.c_str());
+    return;
+  }
+  test::GlbFile glb;
+  if (!CHECK(test::ReadGlb(path, &glb))) return;
+  test::Json json;
+  if (!CHECK(test::Json::Parse(glb.json(), &json))) return;
+  const std::vector<uint8_t> fallback = test::ReadFile(stats.fallback_path);
+  CHECK(stats.fallback_path == dir / "model.fallback.bin");
+  CHECK(json["buffers"].size() == 2);
+  CHECK(json["buffers"][1]["byteLength"].as_size() == fallback.size());
+  CHECK(json["buffers"][1]["extensions"]["EXT_meshopt_compression"]["fallback"].boolean());
+
+  // NORMAL accessor의 bufferView → 원본 primitive (OCTAHEDRAL 결과를 원본 normal과 비교)
+  std::vector<int> normal_primitive(json["bufferViews"].size(), -1);
+  const test::Json& primitives = json["meshes"][0]["primitives"];
+  for (size_t p = 0; p < primitives.size(); p++) {
+    const test::Json& normal = primitives[p]["attributes"]["NORMAL"];
+    if (normal.is_null()) continue;
+    const size_t view = json["accessors"][normal.as_size()]["bufferView"].as_size();
+    if (view < normal_primitive.size()) normal_primitive[view] = static_cast<int>(p);
+  }
+
+  size_t views = 0;
+  size_t octahedral = 0;
+  size_t instance_views = 0;
+  const test::Json& buffer_views = json["bufferViews"];
+  for (size_t i = 0; i < buffer_views.size(); i++) {
+    const test::Json& view = buffer_views[i];
+    const test::Json& ext = view["extensions"]["EXT_meshopt_compression"];
+    if (ext.is_null()) continue;
+    views++;
+    const size_t offset = ext["byteOffset"].as_size();
+    const size_t length = ext["byteLength"].as_size();
+    const size_t count = ext["count"].as_size();
+    const size_t stride = ext["byteStride"].as_size();
+    const std::string mode = ext["mode"].string();
+    // glTF: byteStride는 정점 속성(ARRAY_BUFFER) view에만
+    CHECK(!view.has("byteStride") || view["target"].as_size() == 34962);
+    if (view["target"].is_null()) {
+      instance_views++;
+      CHECK(!view.has("byteStride"));
+    }
+    if (!CHECK(offset + length <= glb.bin_length())) continue;
+    const size_t fb_offset = view["byteOffset"].as_size();
+    const size_t fb_length = view["byteLength"].as_size();
+    if (!CHECK(view["buffer"].as_size() == 1 && fb_offset + fb_length <= fallback.size())) continue;
+    CHECK(count * stride == fb_length);
+
+    std::vector<uint8_t> decoded;
+    if (mode == "ATTRIBUTES") {
+      if (!CHECK(DecodeVertexBuffer(glb.bin() + offset, length, count, stride, &decoded))) continue;
+    } else {
+      CHECK(mode == "INDICES");
+      if (!CHECK(DecodeIndexSequence(glb.bin() + offset, length, count, stride, &decoded))) continue;
+    }
+    const uint8_t* expected = fallback.data() + fb_offset;
+    if (ext["filter"].string() == "OCTAHEDRAL") {
+      // 필터 출력은 fallback(QuantizeNormals)과 같은 int8 xyz 형식이지만 서로 다른 근사라 값은 조금 다름.
+      // 원본 normal과의 각도가 WriteGlb가 보고한 오차 안인지, fallback과 몇 단위 안인지 봄
+      octahedral++;
+      CHECK(stride == 4);
+      OctahedralFilter(&decoded);
+      int max_diff = 0;
+      for (size_t b = 0; b < fb_length; b++) {
+        const int diff = static_cast<int8_t>(decoded[b]) - static_cast<int8_t>(expected[b]);
+        max_diff = std::max(max_diff, std::abs(diff));
+      }
+      if (!CHECK(max_diff <= 2)) std::fprintf(stderr, "  OCTAHEDRAL max difference %d\n", max_diff);
+      if (!CHECK(normal_primitive[i] >= 0)) continue;
+      const std::vector<float>& normals = scene.meshes[0].primitives[normal_primitive[i]].normals;
+      CHECK(normals.size() / 3 == count);
+      double max_error = 0.0;
+      for (size_t v = 0; v < count && v * 3 + 2 < normals.size(); v++) {
+        const int8_t* e = reinterpret_cast<const int8_t*>(&decoded[v * 4]);
+        const double d[3] = {e[0] / 127.0, e[1] / 127.0, e[2] / 127.0};
+        const double n[3] = {normals[v * 3], normals[v * 3 + 1], normals[v * 3 + 2]};
+        max_error = std::max(max_error, test::AngleDegrees(n, d));
+      }
+      if (!CHECK(max_error <= stats.normal_error_degrees + 1e-9)) {
+        std::fprintf(stderr, "  OCTAHEDRAL error %g > reported %g\n", max_error, stats.normal_error_degrees);
+      }
+    } else {
+      CHECK(std::equal(decoded.begin(), decoded.end(), expected));
+    }
+  }
+  CHECK(views == buffer_views.size());
+  CHECK(octahedral == (quantize ? 2u : 0u));
+  CHECK(instance_views == 3);
+}
+
+}  // namespace
+
+int main() {
+  TestCodec();
+  TestGlbFallback(false);
+  TestGlbFallback(true);
+  return test::Finish("meshopt_codec_test");
+}
@@ -0,0 +1,165 @@
+// smoothing group 검사 (BuildSmoothingGroups).
+// 옆면 N개와 뚜껑 2개로 된 원기둥으로
+// - soft edge로 이어진 옆면 꼭짓점이 두 옆면 normal의 평균(정점 방향의 반지름 벡터)을 받는지
+// - soft edge가 없는 뚜껑 모서리와, soft edge가 빠진 세로 이음매는 각이 그대로 남는지(평균 normal 없음)
+// - 공유 edge를 같은 방향으로 쓰는(서로 뒤집힌) face는 잇지 않는지
+// 를 봅니다.
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "smoothing_groups.h"
+#include "test_support.h"
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kSides = 8;
+constexpr double kTolerance = 1e-9;
+
+// 정점: 아래 i, 위 kSides + i. face: 옆면 i (0..kSides-1), 위 뚜껑 kSides, 아래 뚜껑 kSides + 1
+struct Cylinder {
+  std::vector<SmoothingFace> faces;
+  std::vector<SmoothingEdge> edges;
+
+  // skip_seam >= 0이면 그 세로 edge를 soft edge에서 뺌 (hard edge)
+  explicit Cylinder(int skip_seam = -1) {
+    for (int i = 0; i < kSides; i++) {
+      SmoothingFace side;
+      const double a = (i + 0.5) * 2.0 * kPi / kSides;
+      side.normal[0] = std::cos(a);
+      side.normal[1] = std::sin(a);
+      side.normal[2] = 0.0;
+      const int j = (i + 1) % kSides;
+      side.vertices = {i, j, kSides + j, kSides + i};  // 바깥에서 반시계
+      faces.push_back(side);
+    }
+    SmoothingFace top;
+    SmoothingFace bottom;
+    bottom.normal[2] = -1.0;
+    for (int i = 0; i < kSides; i++) {
+      top.vertices.push_back(kSides + i);
+      bottom.vertices.push_back(kSides - 1 - i);
+    }
+    faces.push_back(top);
+    faces.push_back(bottom);
+
+    // 세로 edge i는 옆면 i-1에서 정방향(i → 위), 옆면 i에서 역방향
+    for (int i = 0; i < kSides; i++) {
+      if (i == skip_seam) continue;
+      SmoothingEdge e;
+      e.v0 = i;
+      e.v1 = kSides + i;
+      e.faces = {(i + kSides - 1) % kSides, i};
+      e.reversed = {false, true};
+      edges.push_back(e);
+    }
+  }
+
+  int vertex(int face, const SmoothCorner& c) const { return faces[face].vertices[c.corner]; }
+};
+
+// 정점 v의 반지름 방향 (두 옆면 normal의 평균)
+bool IsRadial(int vertex, const double n[3]) {
+  const double a = (vertex % kSides) * 2.0 * kPi / kSides;
+  return std::fabs(n[0] - std::cos(a)) < kTolerance && std::fabs(n[1] - std::sin(a)) < kTolerance &&
+         std::fabs(n[2]) < kTolerance;
+}
+
+void TestRing() {
+  const Cylinder cyl;
+  SmoothingStats stats;
+  const auto corners = BuildSmoothingGroups(cyl.faces, cyl.edges, &stats);
+  if (!CHECK(corners.size() == cyl.faces.size())) return;
+  for (int f = 0; f < kSides; f++) {
+    CHECK(corners[f].size() == 4);
+    for (const SmoothCorner& c : corners[f]) {
+      if (!CHECK(IsRadial(cyl.vertex(f, c), c.normal))) {
+        std::fprintf(stderr, "  side %d vertex %d: %g %g %g\n", f, cyl.vertex(f, c), c.normal[0], c.normal[1],
+                     c.normal[2]);
+      }
+    }
+  }
+  // 뚜껑 모서리는 hard edge → 뚜껑은 평균을 받지 않고, 옆면 normal에도 z 성분이 섞이지 않음 (IsRadial)
+  CHECK(corners[kSides].empty());
+  CHECK(corners[kSides + 1].empty());
+  CHECK(stats.groups == 1 && stats.faces == kSides && stats.corners == kSides * 4);
+
+  // stats는 누적
+  BuildSmoothingGroups(cyl.faces, cyl.edges, &stats);
+  CHECK(stats.groups == 2 && stats.corners == kSides * 8);
+}
+
+void TestHardSeam() {
+  constexpr int kSeam = 3;
+  const Cylinder cyl(kSeam);
+  SmoothingStats stats;
+  const auto corners = BuildSmoothingGroups(cyl.faces, cyl.edges, &stats);
+  // 이음매 양쪽 옆면(kSeam-1, kSeam)은 이음매 정점에서 평균을 받지 않음
+  for (int f = 0; f < kSides; f++) {
+    size_t seam_corners = 0;
+    for (const SmoothCorner& c : corners[f]) {
+      const int v = cyl.vertex(f, c);
+      if (v % kSides == kSeam) seam_corners++;
+      CHECK(IsRadial(v, c.normal));
+    }
+    CHECK(seam_corners == 0);
+    const bool touches_seam = f == kSeam - 1 || f == kSeam;
+    CHECK(corners[f].size() == (touches_seam ? 2u : 4u));
+  }
+  // 옆면은 여전히 다른 edge로 한 묶음
+  CHECK(stats.groups == 1 && stats.faces == kSides && stats.corners == (kSides - 1) * 4);
+}
+
+void TestReversed() {
+  // 옆면 하나를 뒤집으면 양쪽 edge를 이웃과 같은 방향으로 씀 → 그 face는 묶음에서 빠짐
+  constexpr int kFlipped = 5;
+  Cylinder cyl;
+  SmoothingFace& face = cyl.faces[kFlipped];
+  face.vertices = {face.vertices[3], face.vertices[2], face.vertices[1], face.vertices[0]};
+  for (double& n : face.normal) n = -n;
+  for (SmoothingEdge& e : cyl.edges) {
+    for (size_t i = 0; i < e.faces.size(); i++) {
+      if (e.faces[i] == kFlipped) e.reversed[i] = !e.reversed[i];
+    }
+  }
+  SmoothingStats stats;
+  const auto corners = BuildSmoothingGroups(cyl.faces, cyl.edges, &stats);
+  CHECK(corners[kFlipped].empty());
+  // 이웃 옆면은 뒤집힌 face 쪽 정점에서 평균을 받지 않고, 나머지는 그대로 반지름 방향
+  for (int f = 0; f < kSides; f++) {
+    if (f == kFlipped) continue;
+    const bool neighbor = f == kFlipped - 1 || f == kFlipped + 1;
+    CHECK(corners[f].size() == (neighbor ? 2u : 4u));
+    for (const SmoothCorner& c : corners[f]) CHECK(IsRadial(cyl.vertex(f, c), c.normal));
+  }
+  CHECK(stats.groups == 1 && stats.faces == kSides - 1);
+
+  // edge 하나를 두 face가 같은 방향으로 쓰면 잇지 않음
+  std::vector<SmoothingFace> pair(2);
+  pair[0].vertices = {0, 1, 2};
+  pair[1].vertices = {1, 0, 3};
+  std::vector<SmoothingEdge> edges(1);
+  edges[0].v0 = 0;
+  edges[0].v1 = 1;
+  edges[0].faces = {0, 1};
+  edges[0].reversed = {false, true};
+  SmoothingStats joined;
+  CHECK(BuildSmoothingGroups(pair, edges, &joined)[0].size() == 2);
+  CHECK(joined.groups == 1 && joined.corners == 4);
+  edges[0].reversed = {true, true};
+  SmoothingStats split;
+  const auto none = BuildSmoothingGroups(pair, edges, &split);
+  CHECK(none[0].empty() && none[1].empty());
+  CHECK(split.groups == 0 && split.corners == 0);
+}
+
+}  // namespace
+
+int main() {
+  TestRing();
+  TestHardSeam();
+  TestReversed();
+  return test::Finish("smoothing_groups_test");
+}
@@ -0,0 +1,348 @@
+#pragma once
+
+// 검증 프로그램(ctest) 공용 도구.
+// - CHECK: 실패해도 계속 진행하고 위치/식을 출력, Finish가 실패 수로 종료 코드를 정함
+// - ReadGlb: 헤더와 청크를 검사 없이 그대로 나눔 (구조 검사는 각 테스트가 함)
+// - Json: 검증용 최소 JSON 파서 (glb_writer가 쓰는 부분집합이 아닌 일반 JSON)
+// - SphereScene / AngleDegrees: GLB 출력 테스트가 함께 쓰는 합성 scene과 normal 오차 계산
+// 외부 테스트 프레임워크 없이 빌드됩니다.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gltf_scene.h"
+
+namespace test {
+
+inline int& Failures() {
+  static int failures = 0;
+  return failures;
+}
+
+inline bool Check(bool ok, const char* expr, const char* file, int line) {
+  if (!ok) {
+    std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", file, line, expr);
+    Failures()++;
+  }
+  return ok;
+}
+
+#define CHECK(cond) ::test::Check(static_cast<bool>(cond), #cond, __FILE__, __LINE__)
+
+// 실패가 없으면 0
+inline int Finish(const char* name) {
+  if (Failures() == 0) {
+    std::printf("%s: ok\n", name);
+    return 0;
+  }
+  std::printf("%s: %d check(s) failed\n", name, Failures());
+  return 1;
+}
+
+// 테스트마다 비운 작업 폴더 (시스템 임시 폴더 아래)
+inline std::filesystem::path ScratchDir(const char* name) {
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / name;
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir);
+  return dir;
+}
+
+inline std::vector<uint8_t> ReadFile(const std::filesystem::path& path) {
+  std::ifstream f(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+inline uint32_t ReadU32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+struct GlbChunk {
+  uint32_t type = 0;
+  size_t offset = 0;  // 파일 안 청크 데이터 시작
+  uint32_t length = 0;
+};
+
+struct GlbFile {
+  std::vector<uint8_t> bytes;
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t length = 0;  // 헤더에 적힌 전체 길이
+  std::vector<GlbChunk> chunks;
+  bool truncated = false;  // 청크 길이가 파일 끝을 넘음
+
+  const GlbChunk* chunk(uint32_t type) const {
+    for (const GlbChunk& c : chunks) {
+      if (c.type == type) return &c;
+    }
+    return nullptr;
+  }
+  std::string json() const {
+    const GlbChunk* c = chunk(0x4E4F534A);
+    return c ? std::string(bytes.begin() + c->offset, bytes.begin() + c->offset + c->length) : std::string();
+  }
+  const uint8_t* bin() const {
+    const GlbChunk* c = chunk(0x004E4942);
+    return c ? bytes.data() + c->offset : nullptr;
+  }
+  size_t bin_length() const {
+    const GlbChunk* c = chunk(0x004E4942);
+    return c ? c->length : 0;
+  }
+};
+
+inline bool ReadGlb(const std::filesystem::path& path, GlbFile* out) {
+  out->bytes = ReadFile(path);
+  const std::vector<uint8_t>& b = out->bytes;
+  if (b.size() < 12) return false;
+  out->magic = ReadU32(&b[0]);
+  out->version = ReadU32(&b[4]);
+  out->length = ReadU32(&b[8]);
+  size_t at = 12;
+  while (at + 8 <= b.size()) {
+    GlbChunk c;
+    c.length = ReadU32(&b[at]);
+    c.type = ReadU32(&b[at + 4]);
+    c.offset = at + 8;
+    if (c.offset + c.length > b.size()) {
+      out->truncated = true;
+      break;
+    }
+    out->chunks.push_back(c);
+    at = c.offset + c.length;
+  }
+  return true;
+}
+
+class Json {
+ public:
+  enum class Type { kNull, kBool, kNumber, kString, kArray, kObject };
+
+  Type type() const { return type_; }
+  bool is_null() const { return type_ == Type::kNull; }
+  double number() const { return number_; }
+  bool boolean() const { return boolean_; }
+  const std::string& string() const { return string_; }
+  size_t size() const { return type_ == Type::kObject ? object_.size() : array_.size(); }
+  const std::vector<std::pair<std::string, Json>>& members() const { return object_; }
+
+  // 없으면 null 값
+  const Json& operator[](const std::string& key) const {
+    for (const auto& m : object_) {
+      if (m.first == key) return m.second;
+    }
+    return Null();
+  }
+  const Json& operator[](size_t i) const { return i < array_.size() ? array_[i] : Null(); }
+  bool has(const std::string& key) const {
+    for (const auto& m : object_) {
+      if (m.first == key) return true;
+    }
+    return false;
+  }
+  size_t as_size() const { return static_cast<size_t>(number_); }
+
+  static bool Parse(const std::string& text, Json* out) {
+    size_t at = 0;
+    if (!out->parse_value(text, &at)) return false;
+    SkipSpace(text, &at);
+    return at == text.size();
+  }
+
+ private:
+  static const Json& Null() {
+    static const Json null;
+    return null;
+  }
+  static void SkipSpace(const std::string& s, size_t* at) {
+    while (*at < s.size() && (s[*at] == ' ' || s[*at] == '\n' || s[*at] == '\r' || s[*at] == '\t')) (*at)++;
+  }
+  static bool ParseString(const std::string& s, size_t* at, std::string* out) {
+    if (s[*at] != '"') return false;
+    (*at)++;
+    while (*at < s.size() && s[*at] != '"') {
+      char c = s[(*at)++];
+      if (c == '\\') {
+        if (*at >= s.size()) return false;
+        const char e = s[(*at)++];
+        switch (e) {
+          case 'n': c = '\n'; break;
+          case 't': c = '\t'; break;
+          case 'r': c = '\r'; break;
+          case 'b': c = '\b'; break;
+          case 'f': c = '\f'; break;
+          case 'u':
+            // 검증에는 ASCII 이름만 쓰므로 코드 포인트를 그대로 '?'로 둠
+            if (*at + 4 > s.size()) return false;
+            *at += 4;
+            c = '?';
+            break;
+          default: c = e; break;
+        }
+      }
+      out->push_back(c);
+    }
+    if (*at >= s.size()) return false;
+    (*at)++;
+    return true;
+  }
+  bool parse_value(const std::string& s, size_t* at) {
+    SkipSpace(s, at);
+    if (*at >= s.size()) return false;
+    const char c = s[*at];
+    if (c == '{') {
+      type_ = Type::kObject;
+      (*at)++;
+      SkipSpace(s, at);
+      if (*at < s.size() && s[*at] == '}') {
+        (*at)++;
+        return true;
+      }
+      while (true) {
+        SkipSpace(s, at);
+        std::string key;
+        if (*at >= s.size() || !ParseString(s, at, &key)) return false;
+        SkipSpace(s, at);
+        if (*at >= s.size() || s[*at] != ':') return false;
+        (*at)++;
+        Json value;
+        if (!value.parse_value(s, at)) return false;
+        object_.emplace_back(std::move(key), std::move(value));
+        SkipSpace(s, at);
+        if (*at >= s.size()) return false;
+        if (s[*at] == ',') {
+          (*at)++;
+          continue;
+        }
+        if (s[*at] != '}') return false;
+        (*at)++;
+        return true;
+      }
+    }
+    if (c == '[') {
+      type_ = Type::kArray;
+      (*at)++;
+      SkipSpace(s, at);
+      if (*at < s.size() && s[*at] == ']') {
+        (*at)++;
+        return true;
+      }
+      while (true) {
+        Json value;
+        if (!value.parse_value(s, at)) return false;
+        array_.push_back(std::move(value));
+        SkipSpace(s, at);
+        if (*at >= s.size()) return false;
+        if (s[*at] == ',') {
+          (*at)++;
+          continue;
+        }
+        if (s[*at] != ']') return false;
+        (*at)++;
+        return true;
+      }
+    }
+    if (c == '"') {
+      type_ = Type::kString;
+      return ParseString(s, at, &string_);
+    }
+    if (s.compare(*at, 4, "true") == 0) {
+      type_ = Type::kBool;
+      boolean_ = true;
+      *at += 4;
+      return true;
+    }
+    if (s.compare(*at, 5, "false") == 0) {
+      type_ = Type::kBool;
+      *at += 5;
+      return true;
+    }
+    if (s.compare(*at, 4, "null") == 0) {
+      *at += 4;
+      return true;
+    }
+    const char* begin = s.c_str() + *at;
+    char* end = nullptr;
+    number_ = std::strtod(begin, &end);
+    if (end == begin) return false;
+    type_ = Type::kNumber;
+    *at += static_cast<size_t>(end - begin);
+    return true;
+  }
+
+  Type type_ = Type::kNull;
+  double number_ = 0.0;
+  bool boolean_ = false;
+  std::string string_;
+  std::vector<Json> array_;
+  std::vector<std::pair<std::string, Json>> object_;
+};
+
+// material 0 = 색상, 1 = 텍스처(image 0)와 mesh 0 "spheres": 원점에서 먼 구 두 개 (material마다 primitive 하나).
+// uv는 음수와 1보다 큰 값이 섞임 (타일링, 색상 material은 양자화 시 uv가 생략됨). node는 테스트마다 붙입니다.
+inline GltfScene SphereScene() {
+  GltfScene scene;
+  GltfMaterial color;
+  color.name = "color";
+  scene.materials.push_back(color);
+  GltfMaterial textured;
+  textured.name = "textured";
+  textured.image = 0;
+  scene.materials.push_back(textured);
+  GltfImage image;
+  image.uri = "model/missing.png";  // embed_images를 쓰지 않으므로 파일은 없어도 됨
+  image.mime_type = "image/png";
+  scene.images.push_back(image);
+
+  GltfMesh spheres;
+  spheres.name = "spheres";
+  const double pi = 3.14159265358979323846;
+  for (int material = 0; material < 2; material++) {
+    GltfPrimitive prim;
+    prim.material = material;
+    const uint32_t rings = 24;
+    const uint32_t segments = 48;
+    for (uint32_t r = 0; r <= rings; r++) {
+      for (uint32_t s = 0; s <= segments; s++) {
+        const double theta = pi * r / rings;
+        const double phi = 2.0 * pi * s / segments;
+        const float n[3] = {static_cast<float>(std::sin(theta) * std::cos(phi)),
+                            static_cast<float>(std::sin(theta) * std::sin(phi)), static_cast<float>(std::cos(theta))};
+        prim.positions.insert(prim.positions.end(),
+                              {n[0] * 35.0f + 1500.0f + material * 90.0f, n[1] * 35.0f - 820.0f, n[2] * 35.0f + 40.0f});
+        prim.normals.insert(prim.normals.end(), n, n + 3);
+        prim.texcoords.insert(prim.texcoords.end(), {6.5f * s / segments - 2.5f, -3.0f * r / rings + 1.25f});
+      }
+    }
+    for (uint32_t r = 0; r < rings; r++) {
+      for (uint32_t s = 0; s < segments; s++) {
+        const uint32_t a = r * (segments + 1) + s;
+        prim.indices.insert(prim.indices.end(), {a, a + segments + 1, a + 1, a + 1, a + segments + 1, a + segments + 2});
+      }
+    }
+    spheres.primitives.push_back(std::move(prim));
+  }
+  scene.meshes.push_back(std::move(spheres));
+  return scene;
+}
+
+// 두 방향 사이 각도 (도)
+inline double AngleDegrees(const double a[3], const double b[3]) {
+  const double la = std::sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+  const double lb = std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
+  const double c = (a[0] * b[0] + a[1] * b[1] + a[2] * b[2]) / (la * lb);
+  return std::acos(std::max(-1.0, std::min(1.0, c))) * 57.29577951308232;
+}
+
+}  // namespace test
@@ -0,0 +1,198 @@
+// atlas packer 검사 (PackAtlas / ComposeAtlasPage / RemapAtlasTexcoords).
+// - gutter=4 / align=4로 크기가 섞인 이미지를 넣어 칸(gutter 포함, 정렬된 크기)이 정렬되고 겹치지 않는지
+// - 페이지가 쓰인 영역을 덮는 가장 작은 2의 거듭제곱으로 줄어드는지
+// - 조립한 페이지에서 이미지 내용은 그대로, gutter 텍셀은 가장 가까운 가장자리 픽셀의 복제인지
+// - 바뀐 uv가 [0, 1] 안에서 각 이미지 칸을 벗어나지 않는지 (v 아래/위 원점 모두)
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "texture_atlas.h"
+#include "test_support.h"
+
+namespace {
+
+size_t AlignUp(size_t v, size_t align) { return (v + align - 1) / align * align; }
+
+// 칸(gutter 포함, 정렬된 크기): [x0, x1) x [y0, y1)
+struct Cell {
+  size_t x0, y0, x1, y1;
+};
+
+Cell CellOf(const AtlasRect& r, const AtlasOptions& options) {
+  const size_t x0 = r.x - options.gutter;
+  const size_t y0 = r.y - options.gutter;
+  return {x0, y0, x0 + AlignUp(r.width + options.gutter * 2, options.align),
+          y0 + AlignUp(r.height + options.gutter * 2, options.align)};
+}
+
+// 이미지마다 다른 값, 픽셀마다 다른 값 (복제 위치를 구분할 수 있게)
+RgbaImage MakeImage(size_t index, size_t width, size_t height) {
+  RgbaImage img;
+  img.width = width;
+  img.height = height;
+  img.pixels.resize(width * height * 4);
+  for (size_t y = 0; y < height; y++) {
+    for (size_t x = 0; x < width; x++) {
+      uint8_t* p = &img.pixels[(y * width + x) * 4];
+      p[0] = static_cast<uint8_t>(x);
+      p[1] = static_cast<uint8_t>(y);
+      p[2] = static_cast<uint8_t>(index);
+      p[3] = static_cast<uint8_t>(255 - (x + y) % 7);
+    }
+  }
+  return img;
+}
+
+bool SamePixel(const RgbaImage& page, size_t px, size_t py, const RgbaImage& img, size_t ix, size_t iy) {
+  const uint8_t* a = &page.pixels[(py * page.width + px) * 4];
+  const uint8_t* b = &img.pixels[(iy * img.width + ix) * 4];
+  return std::equal(a, a + 4, b);
+}
+
+void TestPlacementAndPages() {
+  AtlasOptions options;
+  options.page_size = 512;
+  options.gutter = 4;
+  options.align = 4;
+  std::mt19937 rng(7);
+  std::vector<std::pair<size_t, size_t>> sizes;
+  for (int i = 0; i < 120; i++) sizes.emplace_back(1 + rng() % 200, 1 + rng() % 120);
+  sizes.emplace_back(3, 1);            // 정렬보다 작은 이미지
+  sizes.emplace_back(504, 504);        // gutter 포함 페이지를 꽉 채움
+  sizes.emplace_back(505, 10);         // gutter 포함 페이지보다 큼 → 넣지 않음
+  sizes.emplace_back(0, 16);           // 빈 이미지 → 넣지 않음
+  const AtlasLayout layout = PackAtlas(sizes, options);
+
+  CHECK(layout.rects.size() == sizes.size());
+  CHECK(layout.page_width.size() == layout.page_height.size());
+  CHECK(layout.rects[sizes.size() - 2].page == -1);
+  CHECK(layout.rects[sizes.size() - 1].page == -1);
+
+  std::vector<std::vector<Cell>> cells(layout.page_width.size());
+  std::vector<size_t> used_width(layout.page_width.size(), 0);
+  std::vector<size_t> used_height(layout.page_width.size(), 0);
+  for (size_t i = 0; i < sizes.size() - 2; i++) {
+    const AtlasRect& r = layout.rects[i];
+    if (!CHECK(r.page >= 0 && static_cast<size_t>(r.page) < cells.size())) continue;
+    CHECK(r.width == sizes[i].first && r.height == sizes[i].second);
+    CHECK(r.x >= options.gutter && r.y >= options.gutter);
+    const Cell c = CellOf(r, options);
+    CHECK(c.x0 % options.align == 0 && c.y0 % options.align == 0);
+    CHECK(c.x1 <= layout.page_width[r.page] && c.y1 <= layout.page_height[r.page]);
+    for (const Cell& o : cells[r.page]) {
+      const bool apart = c.x1 <= o.x0 || o.x1 <= c.x0 || c.y1 <= o.y0 || o.y1 <= c.y0;
+      if (!CHECK(apart)) std::fprintf(stderr, "  rect %zu overlaps another cell on page %d\n", i, r.page);
+    }
+    cells[r.page].push_back(c);
+    used_width[r.page] = std::max(used_width[r.page], c.x1);
+    used_height[r.page] = std::max(used_height[r.page], c.y1);
+  }
+  // 페이지는 쓰인 영역을 덮는 가장 작은 2의 거듭제곱 (page_size 이하)
+  for (size_t p = 0; p < layout.page_width.size(); p++) {
+    const size_t w = layout.page_width[p];
+    const size_t h = layout.page_height[p];
+    CHECK((w & (w - 1)) == 0 && (h & (h - 1)) == 0);
+    CHECK(w <= options.page_size && h <= options.page_size);
+    CHECK(used_width[p] <= w && used_width[p] * 2 > w);
+    CHECK(used_height[p] <= h && used_height[p] * 2 > h);
+  }
+}
+
+void TestShrinkToFit() {
+  AtlasOptions options;  // page 2048, gutter 4, align 4
+  // 100x50 → 칸 108x60 → 128x64
+  const AtlasLayout one = PackAtlas({{100, 50}}, options);
+  CHECK(one.page_width.size() == 1);
+  CHECK(one.page_width[0] == 128 && one.page_height[0] == 64);
+  CHECK(one.rects[0].x == 4 && one.rects[0].y == 4);
+  // 같은 높이 두 장은 한 shelf에: 칸 128x132 두 개 → 256x132 → 256x256
+  const AtlasLayout two = PackAtlas({{120, 124}, {120, 124}}, options);
+  CHECK(two.page_width.size() == 1);
+  CHECK(two.page_width[0] == 256 && two.page_height[0] == 256);
+  CHECK(two.rects[0].y == two.rects[1].y);
+}
+
+void TestComposeGutter() {
+  AtlasOptions options;
+  options.page_size = 256;
+  options.gutter = 4;
+  options.align = 4;
+  const std::vector<std::pair<size_t, size_t>> sizes = {{13, 7}, {32, 32}, {1, 1}, {50, 21}, {9, 40}, {64, 3}};
+  const AtlasLayout layout = PackAtlas(sizes, options);
+  std::vector<RgbaImage> images;
+  for (size_t i = 0; i < sizes.size(); i++) images.push_back(MakeImage(i + 1, sizes[i].first, sizes[i].second));
+  CHECK(layout.page_width.size() == 1);
+  const RgbaImage page = ComposeAtlasPage(images, layout, 0, options);
+  CHECK(page.width == layout.page_width[0] && page.height == layout.page_height[0]);
+  CHECK(page.pixels.size() == page.width * page.height * 4);
+
+  const long g = static_cast<long>(options.gutter);
+  for (size_t i = 0; i < sizes.size(); i++) {
+    const AtlasRect& r = layout.rects[i];
+    const RgbaImage& img = images[i];
+    size_t mismatched = 0;
+    // 내용 + 둘레 gutter: 이미지 밖 좌표는 가장 가까운 가장자리 픽셀 (모서리는 모서리 픽셀)
+    for (long dy = -g; dy < static_cast<long>(r.height) + g; dy++) {
+      for (long dx = -g; dx < static_cast<long>(r.width) + g; dx++) {
+        const size_t ix = static_cast<size_t>(std::min(std::max(dx, 0L), static_cast<long>(r.width) - 1));
+        const size_t iy = static_cast<size_t>(std::min(std::max(dy, 0L), static_cast<long>(r.height) - 1));
+        if (!SamePixel(page, r.x + dx, r.y + dy, img, ix, iy)) mismatched++;
+      }
+    }
+    if (!CHECK(mismatched == 0)) std::fprintf(stderr, "  rect %zu: %zu texels differ\n", i, mismatched);
+  }
+}
+
+void TestRemap() {
+  AtlasOptions options;
+  options.page_size = 1024;
+  const std::vector<std::pair<size_t, size_t>> sizes = {{100, 60}, {17, 250}, {256, 256}, {3, 5}, {400, 33}};
+  const AtlasLayout layout = PackAtlas(sizes, options);
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  for (size_t i = 0; i < sizes.size(); i++) {
+    const AtlasRect& r = layout.rects[i];
+    if (!CHECK(r.page >= 0)) continue;
+    const double w = static_cast<double>(layout.page_width[r.page]);
+    const double h = static_cast<double>(layout.page_height[r.page]);
+    std::vector<float> uv = {0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f};
+    for (int k = 0; k < 200; k++) uv.push_back(unit(rng));
+    for (bool top_left : {false, true}) {
+      std::vector<float> mapped = uv;
+      RemapAtlasTexcoords(r, layout.page_width[r.page], layout.page_height[r.page], top_left, &mapped);
+      // 페이지 텍셀 좌표(아래 원점)로 되돌려 칸 안인지 봄. float 반올림 여유 1e-3 텍셀
+      const double eps = 1e-3;
+      size_t outside = 0;
+      for (size_t k = 0; k + 1 < mapped.size(); k += 2) {
+        const double px = mapped[k] * w;
+        const double py = (top_left ? 1.0 - mapped[k + 1] : mapped[k + 1]) * h;
+        if (px < r.x - eps || px > r.x + r.width + eps || py < r.y - eps || py > r.y + r.height + eps) outside++;
+        // 원래 uv와 같은 비율 자리
+        const double src_v = top_left ? 1.0 - uv[k + 1] : uv[k + 1];
+        if (std::fabs(px - (r.x + uv[k] * r.width)) > eps || std::fabs(py - (r.y + src_v * r.height)) > eps) {
+          outside++;
+        }
+      }
+      if (!CHECK(outside == 0)) std::fprintf(stderr, "  rect %zu: %zu uv outside (top_left=%d)\n", i, outside, top_left);
+      // 꼭짓점 uv (0,0)/(1,1)은 칸 모서리
+      const double v0 = top_left ? 1.0 - mapped[1] : mapped[1];
+      CHECK(std::fabs(mapped[0] * w - r.x) < eps && std::fabs(v0 * h - (top_left ? r.y + r.height : r.y)) < eps);
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  TestPlacementAndPages();
+  TestShrinkToFit();
+  TestComposeGutter();
+  TestRemap();
+  return test::Finish("texture_atlas_test");
+}